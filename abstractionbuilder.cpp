@@ -0,0 +1,307 @@
+#include "abstractionbuilder.h"
+#include "cardabstraction.h"
+#include "handcombos.h"
+#include "rangeevaluator.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <utility>
+
+using namespace std;
+
+namespace {
+
+const char* kStreetNames[4] = {"Preflop", "Flop", "Turn", "River"};
+
+double getSeconds(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+float getDistance(const float* a, const float* b, int dimensions) {
+    float distance = 0.0f;
+    for (int i = 0; i < dimensions; i++) distance += (a[i] - b[i]) * (a[i] - b[i]);
+    return distance;
+}
+
+}
+
+AbstractionBuilder::AbstractionBuilder(int numThreads)
+    : _pool(numThreads), _feature(kEquityHistogram), _histogramBins(20), _sampleSize(200000), _iterations(25),
+    _seed(0) {
+    _numBuckets[0] = 169;
+    setBuckets(64, 64, 64);
+}
+
+void AbstractionBuilder::setBuckets(int flop, int turn, int river) {
+    int buckets[3] = {flop, turn, river};
+    for (int street = 1; street < 4; street++) {
+        if (buckets[street - 1] <= 0 || buckets[street - 1] > 65536) throw runtime_error("Bucket counts run 1 to 65536");
+        _numBuckets[street] = buckets[street - 1];
+    }
+}
+
+void AbstractionBuilder::setFeature(Feature feature, int histogramBins) {
+    if (histogramBins <= 0) throw runtime_error("Equity histograms need a bin");
+    _feature = feature;
+    _histogramBins = histogramBins;
+}
+
+void AbstractionBuilder::setClustering(int sampleSize, int iterations, uint64_t seed) {
+    _sampleSize = sampleSize > 0 ? sampleSize : 1;
+    _iterations = iterations > 0 ? iterations : 1;
+    _seed = seed;
+}
+
+void AbstractionBuilder::build(const string& path) {
+    auto start = chrono::steady_clock::now();
+    computeRiverStrength();
+    for (int street = 3; street >= 1; street--) cluster(street);
+    ClusteredBuckets::save(path, _indexer, _numBuckets, _tables);
+    _riverStrength = vector<uint16_t>();
+    for (int street = 0; street < 4; street++) _tables[street] = vector<uint16_t>();
+    cout << "Card abstraction written to " << path << " in " << getSeconds(start) << " s" << endl;
+}
+
+// One pass per river board up to suit relabelling: the 1081 holdings are ranked once and each
+// one's wins minus losses read off the ranking (RangeEvaluator's showdown sums against a flat
+// range), which covers every river index.
+void AbstractionBuilder::computeRiverStrength() {
+    auto start = chrono::steady_clock::now();
+    int suitOrders[24][4];
+    int orders = 0;
+    int suits[4] = {0, 1, 2, 3};
+    do {
+        copy(suits, suits + 4, suitOrders[orders++]);
+    } while (next_permutation(suits, suits + 4));
+
+    vector<uint64_t> boards;
+    uint8_t board[5];
+    for (board[0] = 0; board[0] < 52; board[0]++) {
+        for (board[1] = board[0] + 1; board[1] < 52; board[1]++) {
+            for (board[2] = board[1] + 1; board[2] < 52; board[2]++) {
+                for (board[3] = board[2] + 1; board[3] < 52; board[3]++) {
+                    for (board[4] = board[3] + 1; board[4] < 52; board[4]++) {
+                        uint64_t mask = HandCombos::getMask(board, 5);
+                        bool smallest = true;
+                        for (int order = 1; order < orders && smallest; order++) {
+                            uint64_t relabelled = 0;
+                            for (int i = 0; i < 5; i++) relabelled |= 1ull << (board[i] / 4 * 4 + suitOrders[order][board[i] % 4]);
+                            smallest = relabelled >= mask;
+                        }
+                        if (smallest) boards.push_back(mask);
+                    }
+                }
+            }
+        }
+    }
+
+    _riverStrength.assign(_indexer.getSize(3), 0);
+    vector<float> flat(HandCombos::kNumCombos, 1.0f);
+    _pool.parallelFor(static_cast<int>(boards.size()), [&](int begin, int end) {
+        RangeEvaluator::Ranking ranking;
+        vector<float> values(HandCombos::kNumCombos);
+        uint8_t cards[5];
+        for (int i = begin; i < end; i++) {
+            int count = 0;
+            for (int card = 0; card < 52; card++) {
+                if ((boards[i] >> card) & 1u) cards[count++] = static_cast<uint8_t>(card);
+            }
+            RangeEvaluator::rankBoard(cards, ranking);
+            // against every holding but the board's and its own: C(45, 2) of them
+            RangeEvaluator::showdownValues(ranking, 1.0f, flat.data(), values.data());
+            for (uint16_t combo : ranking.order) {
+                double strength = 0.5 + values[combo] / (2.0 * 990.0);
+                uint64_t index = _indexer.getIndex(HandCombos::getCards(combo), cards, 5);
+                _riverStrength[index] = static_cast<uint16_t>(lround(strength * 65535.0));
+            }
+        }
+    });
+    cout << "River strength: " << _riverStrength.size() << " hands on " << boards.size() << " boards in "
+         << getSeconds(start) << " s" << endl;
+}
+
+int AbstractionBuilder::getDimensions(int street) const {
+    return street < 3 && _feature == kEquityHistogram ? _histogramBins : 1;
+}
+
+// River: strength. Turn and flop: the cumulative equity histogram over every runout, or EHS^2.
+void AbstractionBuilder::getFeatures(int street, uint64_t index, float* features) const {
+    if (street == 3) {
+        features[0] = _riverStrength[index] / 65535.0f;
+        return;
+    }
+    uint8_t cards[7];
+    _indexer.getHand(street, index, cards);
+    int boardSize = street + 2;
+    uint64_t used = 0;
+    for (int i = 0; i < 2 + boardSize; i++) used |= 1ull << cards[i];
+    uint8_t remaining[52];
+    int numRemaining = 0;
+    for (int card = 0; card < 52; card++) {
+        if (!((used >> card) & 1u)) remaining[numRemaining++] = static_cast<uint8_t>(card);
+    }
+
+    vector<int> histogram(_histogramBins, 0);
+    double squares = 0.0;
+    int runouts = 0;
+    auto add = [&]() {
+        float strength = _riverStrength[_indexer.getIndex(cards, cards + 2, 5)] / 65535.0f;
+        histogram[min(static_cast<int>(strength * _histogramBins), _histogramBins - 1)]++;
+        squares += strength * strength;
+        runouts++;
+    };
+    for (int first = 0; first < numRemaining; first++) {
+        cards[boardSize + 2] = remaining[first];
+        if (street == 2) {
+            add();
+            continue;
+        }
+        for (int second = first + 1; second < numRemaining; second++) {
+            cards[6] = remaining[second];
+            add();
+        }
+    }
+
+    if (_feature == kHandStrengthSquared) {
+        features[0] = static_cast<float>(squares / runouts);
+        return;
+    }
+    int cumulative = 0;
+    for (int bin = 0; bin < _histogramBins; bin++) {
+        cumulative += histogram[bin];
+        features[bin] = static_cast<float>(cumulative) / runouts;
+    }
+}
+
+void AbstractionBuilder::cluster(int street) {
+    auto start = chrono::steady_clock::now();
+    vector<float> centers;
+    fitCenters(street, centers);
+
+    int dimensions = getDimensions(street);
+    int count = static_cast<int>(_indexer.getSize(street));
+    vector<uint16_t>& table = _tables[street];
+    table.assign(count, 0);
+    _pool.parallelFor(count, [&](int begin, int end) {
+        vector<float> features(dimensions);
+        for (int index = begin; index < end; index++) {
+            getFeatures(street, index, features.data());
+            table[index] = static_cast<uint16_t>(findNearest(centers, dimensions, features.data()));
+        }
+    });
+    cout << kStreetNames[street] << ": " << count << " hands in " << _numBuckets[street] << " buckets, "
+         << getSeconds(start) << " s" << endl;
+}
+
+// k-means++ seeding and Lloyd rounds on a sample, then centers sorted weakest first.
+void AbstractionBuilder::fitCenters(int street, vector<float>& centers) {
+    int dimensions = getDimensions(street);
+    int k = _numBuckets[street];
+    uint64_t size = _indexer.getSize(street);
+    int samples = static_cast<int>(min<uint64_t>(_sampleSize, size));
+    mt19937_64 rng(_seed + street);
+    vector<uint64_t> indices(samples);
+    for (int i = 0; i < samples; i++) indices[i] = samples == static_cast<int>(size) ? i : rng() % size;
+    vector<float> points(static_cast<size_t>(samples) * dimensions);
+    _pool.parallelFor(samples, [&](int begin, int end) {
+        for (int i = begin; i < end; i++) getFeatures(street, indices[i], &points[static_cast<size_t>(i) * dimensions]);
+    });
+
+    centers.assign(static_cast<size_t>(k) * dimensions, 0.0f);
+    vector<float> nearest(samples, numeric_limits<float>::max());
+    for (int center = 0; center < k; center++) {
+        double total = 0.0;
+        for (float distance : nearest) total += distance;
+        int chosen = 0;
+        if (center == 0 || total <= 0.0) {
+            chosen = static_cast<int>(rng() % samples);
+        } else {
+            double target = uniform_real_distribution<double>(0.0, total)(rng);
+            for (chosen = 0; chosen < samples - 1; chosen++) {
+                target -= nearest[chosen];
+                if (target <= 0.0) break;
+            }
+        }
+        float* row = &centers[static_cast<size_t>(center) * dimensions];
+        copy(&points[static_cast<size_t>(chosen) * dimensions], &points[static_cast<size_t>(chosen + 1) * dimensions], row);
+        _pool.parallelFor(samples, [&](int begin, int end) {
+            for (int i = begin; i < end; i++) {
+                nearest[i] = min(nearest[i], getDistance(&points[static_cast<size_t>(i) * dimensions], row, dimensions));
+            }
+        });
+    }
+
+    int workers = _pool.size();
+    vector<int> assignment(samples, -1);
+    vector<double> sums(static_cast<size_t>(workers) * k * dimensions);
+    vector<int> counts(static_cast<size_t>(workers) * k);
+    vector<int> changes(workers);
+    for (int round = 0; round < _iterations; round++) {
+        fill(sums.begin(), sums.end(), 0.0);
+        fill(counts.begin(), counts.end(), 0);
+        _pool.run([&](int worker) {
+            int begin = static_cast<int>(static_cast<long long>(samples) * worker / workers);
+            int end = static_cast<int>(static_cast<long long>(samples) * (worker + 1) / workers);
+            double* sum = &sums[static_cast<size_t>(worker) * k * dimensions];
+            int* count = &counts[static_cast<size_t>(worker) * k];
+            changes[worker] = 0;
+            for (int i = begin; i < end; i++) {
+                const float* point = &points[static_cast<size_t>(i) * dimensions];
+                int center = findNearest(centers, dimensions, point);
+                if (center != assignment[i]) changes[worker]++;
+                assignment[i] = center;
+                count[center]++;
+                for (int d = 0; d < dimensions; d++) sum[static_cast<size_t>(center) * dimensions + d] += point[d];
+            }
+        });
+        int changed = 0;
+        for (int worker = 0; worker < workers; worker++) changed += changes[worker];
+        if (changed == 0) break;
+        for (int center = 0; center < k; center++) {
+            int count = 0;
+            for (int worker = 0; worker < workers; worker++) count += counts[static_cast<size_t>(worker) * k + center];
+            if (count == 0) continue;   // an empty cluster keeps its place
+            for (int d = 0; d < dimensions; d++) {
+                double sum = 0.0;
+                for (int worker = 0; worker < workers; worker++) {
+                    sum += sums[(static_cast<size_t>(worker) * k + center) * dimensions + d];
+                }
+                centers[static_cast<size_t>(center) * dimensions + d] = static_cast<float>(sum / count);
+            }
+        }
+    }
+
+    // weakest first: lowest strength, or for cumulative histograms the most mass early on
+    vector<pair<double, int>> order(k);
+    for (int center = 0; center < k; center++) {
+        double strength = 0.0;
+        for (int d = 0; d < dimensions; d++) strength += centers[static_cast<size_t>(center) * dimensions + d];
+        order[center] = make_pair(dimensions > 1 ? -strength : strength, center);
+    }
+    sort(order.begin(), order.end());
+    vector<float> sorted(centers.size());
+    for (int center = 0; center < k; center++) {
+        copy(&centers[static_cast<size_t>(order[center].second) * dimensions],
+             &centers[static_cast<size_t>(order[center].second + 1) * dimensions],
+             &sorted[static_cast<size_t>(center) * dimensions]);
+    }
+    centers.swap(sorted);
+}
+
+int AbstractionBuilder::findNearest(const vector<float>& centers, int dimensions, const float* features) const {
+    int best = 0;
+    float bestDistance = numeric_limits<float>::max();
+    int k = static_cast<int>(centers.size()) / dimensions;
+    for (int center = 0; center < k; center++) {
+        float distance = getDistance(&centers[static_cast<size_t>(center) * dimensions], features, dimensions);
+        if (distance < bestDistance) {
+            best = center;
+            bestDistance = distance;
+        }
+    }
+    return best;
+}
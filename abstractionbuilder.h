@@ -0,0 +1,61 @@
+#ifndef ABSTRACTIONBUILDER_H
+#define ABSTRACTIONBUILDER_H
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "handindexer.h"
+#include "workerpool.h"
+
+// Offline pipeline for ClusteredBuckets tables, over every HandIndexer index of every street:
+//
+//   river  hand strength (EHS: share of opponent holdings beaten, ties half) of each of the
+//          123M river hands, kept for the streets before it;
+//   turn   the distribution of river strength over the 46 river cards - an equity histogram -
+//          along with its mean (EHS) and mean square (EHS^2);
+//   flop   the same over the 1081 turn and river pairs.
+//
+// Each street is then clustered with k-means: the river on strength, the turn and flop on
+// their histograms (cumulative, so the distance between two tracks the earth mover's distance
+// between their equity distributions) or on EHS^2 alone. Centers are fitted to a random
+// sample of the street's hands, then every hand goes to its nearest center. Strength, feature
+// and assignment passes all run on the worker pool.
+//
+// The river pass ranks each of the 134,459 distinct river boards once; the turn and flop read
+// the strength table about two billion times. A full build takes some 12 minutes on one core and
+// holds the 250 MB strength table while it runs.
+class AbstractionBuilder
+{
+public:
+    enum Feature { kEquityHistogram, kHandStrengthSquared };
+
+    explicit AbstractionBuilder(int numThreads = 0);   // 0 = one per hardware thread
+
+    void setBuckets(int flop, int turn, int river);
+    void setFeature(Feature feature, int histogramBins = 20);
+    // k-means fits centers to sampleSize hands per street, for at most iterations rounds
+    void setClustering(int sampleSize, int iterations, uint64_t seed = 0);
+
+    // Runs every stage and writes the table for ClusteredBuckets; prints each stage's time.
+    void build(const std::string& path);
+
+private:
+    HandIndexer _indexer;
+    WorkerPool _pool;
+    int _numBuckets[4];
+    Feature _feature;
+    int _histogramBins;
+    int _sampleSize;
+    int _iterations;
+    uint64_t _seed;
+    std::vector<uint16_t> _riverStrength;   // EHS * 65535 per river index
+    std::vector<uint16_t> _tables[4];
+
+    void computeRiverStrength();
+    int getDimensions(int street) const;
+    void getFeatures(int street, uint64_t index, float* features) const;
+    void cluster(int street);
+    void fitCenters(int street, std::vector<float>& centers);
+    int findNearest(const std::vector<float>& centers, int dimensions, const float* features) const;
+};
+
+#endif // ABSTRACTIONBUILDER_H
@@ -0,0 +1,305 @@
+#include "agentprotocol.h"
+#include "vectorenv.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace {
+
+#ifdef MSG_NOSIGNAL
+const int kSendFlags = MSG_NOSIGNAL;
+#else
+const int kSendFlags = 0;
+#endif
+
+sockaddr_un socketAddress(const string& path) {
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw runtime_error("Agent socket path too long: " + path);
+    }
+    memcpy(address.sun_path, path.c_str(), path.size());
+    return address;
+}
+
+// Appends one frame holding count records to out.
+template <typename Record>
+void appendFrame(vector<uint8_t>& out, uint16_t type, const Record* records, int count) {
+    AgentFrameHeader header = {kAgentMagic, type, static_cast<uint16_t>(count)};
+    size_t start = out.size();
+    out.resize(start + sizeof(header) + sizeof(Record) * count);
+    memcpy(&out[start], &header, sizeof(header));
+    memcpy(&out[start + sizeof(header)], records, sizeof(Record) * count);
+}
+
+// Calls handle(records, count) for every complete frame of the given type at the front of
+// in and drops those bytes. Throws on anything that isn't a frame.
+template <typename Record, typename Handler>
+void consumeFrames(vector<uint8_t>& in, uint16_t type, Handler handle) {
+    size_t offset = 0;
+    while (in.size() - offset >= sizeof(AgentFrameHeader)) {
+        AgentFrameHeader header;
+        memcpy(&header, &in[offset], sizeof(header));
+        if (header.magic != kAgentMagic || header.type != type || header.count > kMaxAgentBatch) {
+            throw runtime_error("Malformed agent frame");
+        }
+        size_t frameBytes = sizeof(header) + sizeof(Record) * header.count;
+        if (in.size() - offset < frameBytes) break;
+        handle(reinterpret_cast<const Record*>(&in[offset + sizeof(header)]), header.count);
+        offset += frameBytes;
+    }
+    in.erase(in.begin(), in.begin() + offset);
+}
+
+bool writeAll(int fd, const uint8_t* data, size_t size) {
+    while (size > 0) {
+        ssize_t sent = send(fd, data, size, kSendFlags);
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent <= 0) return false;
+        data += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+}
+
+AgentConnection::AgentConnection(const string& socketPath, int maxBatch)
+    : _fd(-1),
+    _maxBatch(max(1, min(maxBatch, kMaxAgentBatch))),
+    _nextId(1),
+    _outSent(0),
+    _nextLatency(0),
+    _totalLatency(0.0),
+    _responses(0),
+    _framesSent(0),
+    _requestsSent(0) {
+    sockaddr_un address = socketAddress(socketPath);
+    _fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (_fd < 0) throw runtime_error("Could not create agent socket");
+    if (connect(_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        close(_fd);
+        throw runtime_error("Could not connect to agent at " + socketPath);
+    }
+    fcntl(_fd, F_SETFL, fcntl(_fd, F_GETFL, 0) | O_NONBLOCK);
+    _queued.reserve(_maxBatch);
+}
+
+AgentConnection::~AgentConnection() {
+    close(_fd);
+}
+
+uint64_t AgentConnection::submit(const int8_t* features, uint8_t legalMask, int seat) {
+    _queued.emplace_back();
+    AgentRequest& request = _queued.back();
+    request.id = _nextId++;
+    request.seat = static_cast<uint8_t>(seat);
+    request.legalMask = legalMask;
+    memset(request.reserved, 0, sizeof(request.reserved));
+    memset(request.padding, 0, sizeof(request.padding));
+    memcpy(request.features, features, sizeof(request.features));
+    _submitted[request.id] = Clock::now();
+    if (static_cast<int>(_queued.size()) >= _maxBatch) flush();
+    return request.id;
+}
+
+void AgentConnection::flush() {
+    if (!_queued.empty()) {
+        appendFrame(_out, kAgentRequests, _queued.data(), static_cast<int>(_queued.size()));
+        _framesSent++;
+        _requestsSent += static_cast<long long>(_queued.size());
+        _queued.clear();
+    }
+    sendPending();
+}
+
+void AgentConnection::sendPending() {
+    while (_outSent < _out.size()) {
+        ssize_t sent = send(_fd, &_out[_outSent], _out.size() - _outSent, kSendFlags);
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        if (sent <= 0) throw runtime_error("Agent connection lost while sending");
+        _outSent += static_cast<size_t>(sent);
+    }
+    if (_outSent == _out.size()) {
+        _out.clear();
+        _outSent = 0;
+    }
+}
+
+void AgentConnection::receive() {
+    sendPending();
+    uint8_t buffer[65536];
+    for (;;) {
+        ssize_t got = recv(_fd, buffer, sizeof(buffer), 0);
+        if (got < 0 && errno == EINTR) continue;
+        if (got < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        if (got <= 0) throw runtime_error("Agent closed the connection");
+        _in.insert(_in.end(), buffer, buffer + got);
+    }
+
+    Clock::time_point now = Clock::now();
+    consumeFrames<AgentResponse>(_in, kAgentResponses, [&](const AgentResponse* responses, int count) {
+        for (int i = 0; i < count; i++) {
+            auto submitted = _submitted.find(responses[i].id);
+            if (submitted == _submitted.end()) continue;
+            float latency = chrono::duration<float, micro>(now - submitted->second).count();
+            if (_latencies.size() < static_cast<size_t>(kAgentLatencySamples)) {
+                _latencies.push_back(latency);
+            } else {
+                _latencies[_nextLatency] = latency;
+                _nextLatency = (_nextLatency + 1) % kAgentLatencySamples;
+            }
+            _totalLatency += latency;
+            _responses++;
+            _submitted.erase(submitted);
+            _answers[responses[i].id] = responses[i].action;
+        }
+    });
+}
+
+bool AgentConnection::takeResponse(uint64_t id, int& action) {
+    auto answer = _answers.find(id);
+    if (answer == _answers.end()) return false;
+    action = answer->second;
+    _answers.erase(answer);
+    return true;
+}
+
+int AgentConnection::getFd() const {
+    return _fd;
+}
+
+int AgentConnection::getInFlight() const {
+    return static_cast<int>(_submitted.size());
+}
+
+long long AgentConnection::getFramesSent() const {
+    return _framesSent;
+}
+
+long long AgentConnection::getRequestsSent() const {
+    return _requestsSent;
+}
+
+long long AgentConnection::getResponses() const {
+    return _responses;
+}
+
+double AgentConnection::getMeanLatencyMicros() const {
+    if (_responses == 0) return 0.0;
+    return _totalLatency / _responses;
+}
+
+double AgentConnection::getLatencyPercentileMicros(double percentile) const {
+    if (_latencies.empty()) return 0.0;
+    vector<float> sorted(_latencies);
+    size_t rank = static_cast<size_t>(percentile / 100.0 * (sorted.size() - 1) + 0.5);
+    if (rank >= sorted.size()) rank = sorted.size() - 1;
+    nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+    return sorted[rank];
+}
+
+AgentServer::AgentServer(const string& socketPath, Policy policy)
+    : _path(socketPath), _policy(policy), _listenFd(-1), _stopping(false) {
+    sockaddr_un address = socketAddress(socketPath);
+    _listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (_listenFd < 0) throw runtime_error("Could not create agent socket");
+    unlink(socketPath.c_str());
+    if (bind(_listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+            || listen(_listenFd, 16) != 0) {
+        close(_listenFd);
+        throw runtime_error("Could not listen on " + socketPath);
+    }
+}
+
+AgentServer::~AgentServer() {
+    close(_listenFd);
+    unlink(_path.c_str());
+}
+
+void AgentServer::serve() {
+    struct Client {
+        int fd;
+        vector<uint8_t> in;
+    };
+    vector<Client> clients;
+    vector<pollfd> fds;
+    vector<AgentResponse> responses;
+    vector<uint8_t> out;
+    uint8_t buffer[65536];
+
+    while (!_stopping.load()) {
+        fds.assign(1, {_listenFd, POLLIN, 0});
+        for (const Client& client : clients) fds.push_back({client.fd, POLLIN, 0});
+        if (poll(fds.data(), fds.size(), 50) <= 0) continue;
+
+        if (fds[0].revents & POLLIN) {
+            int fd = accept(_listenFd, nullptr, nullptr);
+            if (fd >= 0) clients.push_back({fd, vector<uint8_t>()});
+        }
+
+        for (size_t i = 0; i < fds.size() - 1; i++) {
+            if (!(fds[i + 1].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            Client& client = clients[i];
+            ssize_t got = recv(client.fd, buffer, sizeof(buffer), 0);
+            bool open = got > 0;
+            if (open) {
+                client.in.insert(client.in.end(), buffer, buffer + got);
+                out.clear();
+                try {
+                    consumeFrames<AgentRequest>(client.in, kAgentRequests, [&](const AgentRequest* requests, int count) {
+                        responses.resize(count);
+                        for (int r = 0; r < count; r++) {
+                            memset(&responses[r], 0, sizeof(AgentResponse));
+                            responses[r].id = requests[r].id;
+                            responses[r].action = static_cast<uint8_t>(_policy(requests[r]));
+                        }
+                        appendFrame(out, kAgentResponses, responses.data(), count);
+                    });
+                    open = writeAll(client.fd, out.data(), out.size());
+                } catch (const runtime_error&) {
+                    open = false;
+                }
+            }
+            if (!open && !(got < 0 && errno == EINTR)) {
+                close(client.fd);
+                client.fd = -1;
+            }
+        }
+        clients.erase(remove_if(clients.begin(), clients.end(), [](const Client& client) {
+            return client.fd < 0;
+        }), clients.end());
+    }
+
+    for (const Client& client : clients) close(client.fd);
+}
+
+void AgentServer::stop() {
+    _stopping.store(true);
+}
+
+int AgentServer::standInPolicy(const AgentRequest& request) {
+    int ranks[2];
+    int found = 0;
+    for (int card = 0; card < 52 && found < 2; card++) {
+        if (request.features[InfoState::kHoleOffset + card]) ranks[found++] = card / 4;
+    }
+    bool pair = found == 2 && ranks[0] == ranks[1];
+    if (pair && (request.legalMask & (1u << VectorEnv::kRaiseHalfPot))) return VectorEnv::kRaiseHalfPot;
+    if (request.legalMask & (1u << VectorEnv::kCheckCall)) return VectorEnv::kCheckCall;
+    if (request.legalMask & (1u << VectorEnv::kFold)) return VectorEnv::kFold;
+    for (int action = 0; action < VectorEnv::kNumActions; action++) {
+        if (request.legalMask & (1u << action)) return action;
+    }
+    return VectorEnv::kFold;
+}
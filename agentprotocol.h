@@ -0,0 +1,126 @@
+#ifndef AGENTPROTOCOL_H
+#define AGENTPROTOCOL_H
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "infostate.h"
+
+// Binary protocol for decision agents running in another local process, over a Unix domain
+// stream socket. Everything is little endian and fixed size, so a Python agent can read it
+// with struct / numpy:
+//
+//   frame     = AgentFrameHeader, then count records
+//   requests  (type kAgentRequests)  AgentRequest  x count, client -> agent
+//   responses (type kAgentResponses) AgentResponse x count, agent -> client
+//
+// A request carries the int8 InfoState of the seat to act and a bit per legal
+// VectorEnv::DiscreteAction; the response names one of those actions. The client may send
+// any number of request frames before reading (pipelining); responses can come back in any
+// grouping and order, matched by id.
+const uint32_t kAgentMagic = 0x47414b50u;   // "PKAG"
+const uint16_t kAgentRequests = 1;
+const uint16_t kAgentResponses = 2;
+const int kMaxAgentBatch = 4096;
+const int kAgentLatencySamples = 4096;     // percentiles come from this many most recent responses
+
+struct AgentFrameHeader {
+    uint32_t magic;
+    uint16_t type;
+    uint16_t count;
+};
+
+struct AgentRequest {
+    uint64_t id;
+    uint8_t seat;
+    uint8_t legalMask;      // bit i set = VectorEnv::DiscreteAction i is legal
+    uint8_t reserved[6];
+    int8_t features[InfoState::kSize];
+    uint8_t padding[4];     // keeps the record a multiple of 8 bytes
+};
+
+struct AgentResponse {
+    uint64_t id;
+    uint8_t action;         // a VectorEnv::DiscreteAction
+    uint8_t reserved[7];
+};
+
+static_assert(sizeof(AgentFrameHeader) == 8, "agent frame header is 8 bytes on the wire");
+static_assert(sizeof(AgentRequest) == 16 + InfoState::kSize + 4, "agent request must have no implicit padding");
+static_assert(sizeof(AgentResponse) == 16, "agent response is 16 bytes on the wire");
+
+// Client end of one agent socket, shared by every RemoteBot talking to that agent.
+// submit() only queues; queued requests go out as one frame on flush() (or when the batch
+// is full). Nothing blocks: unsent bytes wait for the next flush()/receive().
+class AgentConnection
+{
+public:
+    explicit AgentConnection(const std::string& socketPath, int maxBatch = 256);
+    ~AgentConnection();
+    AgentConnection(const AgentConnection&) = delete;
+    AgentConnection& operator=(const AgentConnection&) = delete;
+
+    uint64_t submit(const int8_t* features, uint8_t legalMask, int seat);
+    void flush();
+    void receive();
+    bool takeResponse(uint64_t id, int& action);   // true once the answer for id has arrived
+
+    int getFd() const;
+    int getInFlight() const;
+    long long getFramesSent() const;
+    long long getRequestsSent() const;
+    long long getResponses() const;
+    double getMeanLatencyMicros() const;
+    double getLatencyPercentileMicros(double percentile) const;   // 0..100, over the recent samples
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    int _fd;
+    int _maxBatch;
+    uint64_t _nextId;
+    std::vector<AgentRequest> _queued;
+    std::vector<uint8_t> _out;
+    size_t _outSent;
+    std::vector<uint8_t> _in;
+    std::unordered_map<uint64_t, Clock::time_point> _submitted;
+    std::unordered_map<uint64_t, int> _answers;
+    std::vector<float> _latencies;      // ring of the last kAgentLatencySamples
+    size_t _nextLatency;
+    double _totalLatency;
+    long long _responses;
+    long long _framesSent;
+    long long _requestsSent;
+
+    void sendPending();
+};
+
+// Minimal local agent for tests and benchmarks: serves any number of clients on one
+// socket, answering each request frame as it arrives with the given policy.
+class AgentServer
+{
+public:
+    using Policy = std::function<int(const AgentRequest&)>;
+
+    explicit AgentServer(const std::string& socketPath, Policy policy = standInPolicy);
+    ~AgentServer();
+    AgentServer(const AgentServer&) = delete;
+    AgentServer& operator=(const AgentServer&) = delete;
+
+    void serve();       // returns after stop()
+    void stop();
+
+    // Raises half pot with a pocket pair, otherwise checks or calls, folding only when it must.
+    static int standInPolicy(const AgentRequest& request);
+
+private:
+    std::string _path;
+    Policy _policy;
+    int _listenFd;
+    std::atomic<bool> _stopping;
+};
+
+#endif // AGENTPROTOCOL_H
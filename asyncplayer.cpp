@@ -0,0 +1,30 @@
+#include "asyncplayer.h"
+#include <thread>
+#include <poll.h>
+
+AsyncPlayer::AsyncPlayer(const std::string& name, int chips, int position)
+    : Player(name, chips, position) {
+}
+
+PlayerAction AsyncPlayer::makeDecision(const Gamestate& gameState, GameManager* gameManager) {
+    beginDecision(gameState, gameManager);
+    return waitForDecision();
+}
+
+PlayerAction AsyncPlayer::waitForDecision() {
+    PlayerAction action(Action::fold);
+    while (!pollDecision(action)) {
+        int fd = getWaitFd();
+        if (fd >= 0) {
+            pollfd wait = {fd, POLLIN, 0};
+            ::poll(&wait, 1, 10);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    return action;
+}
+
+int AsyncPlayer::getWaitFd() const {
+    return -1;
+}
@@ -0,0 +1,27 @@
+#ifndef ASYNCPLAYER_H
+#define ASYNCPLAYER_H
+#include "player.h"
+
+class GameManager;
+
+// A player whose decision can take a while (external agent, remote model, long search).
+// beginDecision() starts the work and returns at once; pollDecision() reports the action once
+// it is ready. The table is left untouched in between, so the state passed to beginDecision
+// stays valid until the action has been collected. Under a TableExecutor the thread serves
+// other tables meanwhile; a plain GameManager gets the blocking makeDecision below.
+class AsyncPlayer : public Player {
+public:
+    AsyncPlayer(const std::string& name, int chips, int position = -1);
+    PlayerAction makeDecision(const Gamestate& gameState, GameManager* gameManager);
+
+    virtual void beginDecision(const Gamestate& gameState, GameManager* gameManager) = 0;
+    virtual bool pollDecision(PlayerAction& action) = 0;
+    // Descriptor that becomes readable when progress is possible, or -1 to be polled blindly.
+    virtual int getWaitFd() const;
+
+protected:
+    // The blocking wait behind makeDecision: polls until the started decision is ready.
+    PlayerAction waitForDecision();
+};
+
+#endif // ASYNCPLAYER_H
@@ -0,0 +1,146 @@
+#include "batchscheduler.h"
+
+using namespace std;
+
+BatchPlayer::BatchPlayer(const string& name, int chips, shared_ptr<BatchPolicy> policy, int position)
+    : Player(name, chips, position), _policy(policy) {
+}
+
+PlayerAction BatchPlayer::makeDecision(const Gamestate& gameState, GameManager* /*gameManager*/) {
+    DecisionRequest request = {&gameState, getSeat(), -1};
+    PlayerAction action(Action::fold);
+    _policy->decide(&request, 1, &action);
+    return action;
+}
+
+BatchPolicy* BatchPlayer::getPolicy() const {
+    return _policy.get();
+}
+
+BatchScheduler::BatchScheduler(int maxBatchSize, chrono::microseconds maxBatchLatency)
+    : _maxBatchSize(maxBatchSize > 0 ? maxBatchSize : 1),
+    _maxBatchLatency(maxBatchLatency),
+    _handsPlayed(0),
+    _decisions(0),
+    _batchedDecisions(0),
+    _batches(0) {
+}
+
+int BatchScheduler::addTable(shared_ptr<GameManager> table, int numHands) {
+    _tables.push_back({table, numHands, false, false});
+    return static_cast<int>(_tables.size()) - 1;
+}
+
+bool BatchScheduler::step() {
+    for (int i = 0; i < static_cast<int>(_tables.size()); i++) {
+        if (!_tables[i].finished && !_tables[i].waiting) advance(i);
+    }
+    Clock::time_point now = Clock::now();
+    for (Queue& queue : _queues) {
+        if (!queue.requests.empty() && now - queue.oldest >= _maxBatchLatency) flush(queue);
+    }
+
+    // Once every live table is parked nothing can fill a queue further, so the oldest one goes
+    // out whatever its size.
+    bool running = false;
+    bool stalled = true;
+    for (const Table& table : _tables) {
+        if (table.finished) continue;
+        running = true;
+        if (!table.waiting) stalled = false;
+    }
+    if (running && stalled) {
+        Queue* oldest = nullptr;
+        for (Queue& queue : _queues) {
+            if (!queue.requests.empty() && (!oldest || queue.oldest < oldest->oldest)) oldest = &queue;
+        }
+        if (oldest) flush(*oldest);
+    }
+    return running;
+}
+
+void BatchScheduler::run() {
+    while (step()) {
+    }
+}
+
+// Plays the table forward until it either finishes or parks a request in a policy queue.
+void BatchScheduler::advance(int index) {
+    Table& table = _tables[index];
+    GameManager& game = *table.game;
+    for (;;) {
+        if (!game.isAwaitingDecision()) {
+            if (table.handsLeft <= 0 || game.isGameOver()) {
+                table.finished = true;
+                return;
+            }
+            game.beginHand();
+            table.handsLeft--;
+            _handsPlayed++;
+            continue;
+        }
+
+        int seat = game.getDecisionSeat();
+        Player* player = game.getPlayer(seat).get();
+        BatchPlayer* batched = dynamic_cast<BatchPlayer*>(player);
+        _decisions++;
+        if (!batched) {
+            game.applyDecision(player->makeDecision(game.getGameState(), &game));
+            continue;
+        }
+
+        Queue& queue = queueFor(batched->getPolicy());
+        Clock::time_point now = Clock::now();
+        if (queue.requests.empty()) queue.oldest = now;
+        queue.requests.push_back({&game.getGameState(), seat, index});
+        table.waiting = true;
+        if (static_cast<int>(queue.requests.size()) >= _maxBatchSize || now - queue.oldest >= _maxBatchLatency) {
+            flush(queue);
+        }
+        return;
+    }
+}
+
+BatchScheduler::Queue& BatchScheduler::queueFor(BatchPolicy* policy) {
+    for (Queue& queue : _queues) {
+        if (queue.policy == policy) return queue;
+    }
+    _queues.push_back(Queue());
+    _queues.back().policy = policy;
+    _queues.back().requests.reserve(_maxBatchSize);
+    return _queues.back();
+}
+
+void BatchScheduler::flush(Queue& queue) {
+    int count = static_cast<int>(queue.requests.size());
+    queue.actions.assign(count, PlayerAction(Action::fold));
+    queue.policy->decide(queue.requests.data(), count, queue.actions.data());
+    for (int i = 0; i < count; i++) {
+        Table& table = _tables[queue.requests[i].table];
+        table.game->applyDecision(queue.actions[i]);
+        table.waiting = false;
+    }
+    _batchedDecisions += count;
+    _batches++;
+    queue.requests.clear();
+}
+
+int BatchScheduler::getNumTables() const {
+    return static_cast<int>(_tables.size());
+}
+
+long long BatchScheduler::getHandsPlayed() const {
+    return _handsPlayed;
+}
+
+long long BatchScheduler::getDecisions() const {
+    return _decisions;
+}
+
+long long BatchScheduler::getBatches() const {
+    return _batches;
+}
+
+double BatchScheduler::getMeanBatchSize() const {
+    return _batches > 0 ? static_cast<double>(_batchedDecisions) / _batches : 0.0;
+}
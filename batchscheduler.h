@@ -0,0 +1,89 @@
+#ifndef BATCHSCHEDULER_H
+#define BATCHSCHEDULER_H
+#include <chrono>
+#include <memory>
+#include <vector>
+#include "player.h"
+#include "gamemanager.h"
+
+// One pending decision: the table's state and the seat that has to act.
+struct DecisionRequest {
+    const Gamestate* state;
+    int seat;
+    int table;      // index in the scheduler, -1 when asked outside one
+};
+
+// A decision policy that prefers to see many tables at once (network, equity engine, ...).
+// decide() fills actions[i] for requests[i].
+class BatchPolicy
+{
+public:
+    virtual ~BatchPolicy() {}
+    virtual void decide(const DecisionRequest* requests, int count, PlayerAction* actions) = 0;
+};
+
+// Seats a BatchPolicy at a table. Under a BatchScheduler its decisions are batched with every
+// other seat using the same policy; played by a plain GameManager it asks for a batch of one.
+class BatchPlayer : public Player {
+public:
+    BatchPlayer(const std::string& name, int chips, std::shared_ptr<BatchPolicy> policy, int position = -1);
+    PlayerAction makeDecision(const Gamestate& gameState, GameManager* gameManager);
+    BatchPolicy* getPolicy() const;
+
+private:
+    std::shared_ptr<BatchPolicy> _policy;
+};
+
+// Runs many GameManager tables as resumable hands. Each sweep advances every table until it
+// needs a BatchPlayer decision (other players are asked directly), queues that request under
+// the player's policy, and moves on. A policy's queue is handed to decide() when it reaches
+// the batch size or its oldest request has waited the maximum batch latency. When every table
+// is waiting on an answer, the queue with the oldest request goes out regardless, so the
+// tables never deadlock.
+class BatchScheduler
+{
+public:
+    BatchScheduler(int maxBatchSize = 256, std::chrono::microseconds maxBatchLatency = std::chrono::microseconds(1000));
+
+    int addTable(std::shared_ptr<GameManager> table, int numHands);
+    bool step();        // one sweep over the tables; false once every table is finished
+    void run();
+
+    int getNumTables() const;
+    long long getHandsPlayed() const;
+    long long getDecisions() const;     // every decision, batched or asked directly
+    long long getBatches() const;
+    double getMeanBatchSize() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Table {
+        std::shared_ptr<GameManager> game;
+        int handsLeft;
+        bool waiting;   // a request for this table is queued
+        bool finished;
+    };
+
+    struct Queue {
+        BatchPolicy* policy;
+        std::vector<DecisionRequest> requests;
+        std::vector<PlayerAction> actions;
+        Clock::time_point oldest;
+    };
+
+    int _maxBatchSize;
+    std::chrono::microseconds _maxBatchLatency;
+    std::vector<Table> _tables;
+    std::vector<Queue> _queues;
+    long long _handsPlayed;
+    long long _decisions;
+    long long _batchedDecisions;
+    long long _batches;
+
+    void advance(int index);
+    Queue& queueFor(BatchPolicy* policy);
+    void flush(Queue& queue);
+};
+
+#endif // BATCHSCHEDULER_H
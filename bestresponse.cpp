@@ -0,0 +1,363 @@
+#include "bestresponse.h"
+#include "headsupengine.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+const int kCombos = HandCombos::kNumCombos;
+const int kMaxActions = BetAbstraction::kMaxActions;
+const int kMaxRivers = 48;                  // cards left after a turn
+const int kNumFlops = 22100;                // 52 choose 3
+const int kFlopsMissingOneHand = 19600;     // 50 choose 3
+const int kFlopsMissingTwoHands = 17296;    // 48 choose 3
+const double kHandPairs = 1326.0 * 1225.0;  // deals of two hands that share no card
+
+}
+
+struct BestResponse::Worker {
+    unique_ptr<BotStrategy> strategy;
+    int flop;                                       // the rankings below are for this flop
+    vector<RangeEvaluator::Ranking> rankings;       // turn slot x kMaxRivers + river slot
+    vector<uint8_t> ranked;
+};
+
+BestResponse::BestResponse(const RuleSet& rules, const BetAbstraction& bets, int numThreads)
+    : _rules(rules),
+    _bets(bets),
+    _tree(rules, bets, StrengthBuckets()),
+    _pool(numThreads),
+    _turnsPerFlop(0),
+    _riversPerTurn(0),
+    _seed(0),
+    _workers(nullptr),
+    _values{0.0, 0.0},
+    _seconds(0.0) {
+    int nodes = static_cast<int>(_tree.getNodes().size());
+    _spots.resize(nodes);
+    _outcomes.resize(static_cast<size_t>(nodes) * kMaxActions);
+    switch (rules.getBettingType()) {
+    case BettingStructure::NO_LIMIT: {
+        HeadsUpEngine<BettingStructure::NO_LIMIT> table(rules);
+        table.setButton(1);
+        if (table.startHand()) expand(table, 0);
+        break;
+    }
+    case BettingStructure::POT_LIMIT: {
+        HeadsUpEngine<BettingStructure::POT_LIMIT> table(rules);
+        table.setButton(1);
+        if (table.startHand()) expand(table, 0);
+        break;
+    }
+    case BettingStructure::FIXED_LIMIT: {
+        HeadsUpEngine<BettingStructure::FIXED_LIMIT> table(rules);
+        table.setButton(1);
+        if (table.startHand()) expand(table, 0);
+        break;
+    }
+    }
+    setBoardSample(200, 4, 4);
+}
+
+// Same walk as BettingTree's, so node indices line up; the engine's button is seat 0, which
+// makes engine seats the small blind / big blind numbering of BotSpot.
+template <typename Engine>
+void BestResponse::expand(const Engine& table, int node) {
+    const BettingTree::Node& info = _tree.getNodes()[node];
+    BotSpot& spot = _spots[node];
+    spot.node = node;
+    spot.legalMask = info.legalMask;
+    spot.seat = table.getCurrentSeat();
+    spot.phase = table.getPhase();
+    spot.currentBet = table.getCurrentBet();
+    for (int seat = 0; seat < 2; seat++) {
+        spot.stacks[seat] = table.getStack(seat);
+        spot.roundBets[seat] = table.getRoundBet(seat);
+        spot.totalBets[seat] = table.getTotalBet(seat);
+    }
+    spot.allInMask = table.getAllInMask();
+    spot.history.assign(table.getHistory(), table.getHistory() + table.getHistorySize());
+
+    for (int action = 0; action < kMaxActions; action++) {
+        if (!((info.legalMask >> action) & 1u)) continue;
+        Engine child = table;
+        child.applyAction(_bets.toPlayerAction(child, action));
+        Outcome& outcome = _outcomes[static_cast<size_t>(node) * kMaxActions + action];
+        outcome.child = info.children[action];
+        outcome.nextStreet = outcome.child != BettingTree::kNoChild && _tree.getNodes()[outcome.child].street != info.street;
+        unsigned inHand = child.getInHandMask();
+        outcome.folder = inHand == 3u ? -1 : (inHand & 1u ? 1 : 0);
+        outcome.totalBets[0] = child.getTotalBet(0);
+        outcome.totalBets[1] = child.getTotalBet(1);
+        if (outcome.child != BettingTree::kNoChild) expand(child, outcome.child);
+    }
+}
+
+void BestResponse::setBoardSample(int flops, int turnsPerFlop, int riversPerTurn, uint64_t seed) {
+    _turnsPerFlop = turnsPerFlop;
+    _riversPerTurn = riversPerTurn;
+    _seed = seed;
+
+    vector<uint8_t> all;
+    all.reserve(kNumFlops * 3);
+    for (int a = 0; a < 52; a++) {
+        for (int b = a + 1; b < 52; b++) {
+            for (int c = b + 1; c < 52; c++) {
+                all.push_back(static_cast<uint8_t>(a));
+                all.push_back(static_cast<uint8_t>(b));
+                all.push_back(static_cast<uint8_t>(c));
+            }
+        }
+    }
+    if (flops <= 0 || flops >= kNumFlops) {
+        _flops.swap(all);
+        return;
+    }
+    // partial Fisher-Yates over whole flops
+    EngineRng rng(seed);
+    for (int i = 0; i < flops; i++) {
+        int pick = i + rng.below(kNumFlops - i);
+        for (int card = 0; card < 3; card++) swap(all[i * 3 + card], all[pick * 3 + card]);
+    }
+    _flops.assign(all.begin(), all.begin() + flops * 3);
+}
+
+double BestResponse::computeExploitability(const StrategyFactory& makeStrategy) {
+    auto start = chrono::steady_clock::now();
+    vector<Worker> workers(_pool.size());
+    for (Worker& worker : workers) {
+        worker.strategy = makeStrategy();
+        if (!worker.strategy) throw runtime_error("Best response needs a bot strategy");
+        worker.flop = -1;
+        worker.rankings.resize(static_cast<size_t>(kMaxRivers + 1) * kMaxRivers);
+        worker.ranked.assign(worker.rankings.size(), 0);
+    }
+
+    _workers = workers.data();
+
+    vector<float> reach(kCombos, 1.0f);
+    vector<float> values(kCombos);
+    Board board = {{0, 0, 0, 0, 0}, 0, -1, -1, -1};
+    for (int traverser = 0; traverser < 2; traverser++) {
+        walk(workers[0], 0, traverser, board, reach.data(), values.data(), true);
+        double total = 0.0;
+        for (int combo = 0; combo < kCombos; combo++) total += values[combo];
+        _values[traverser] = total / kHandPairs / _rules.getBigBlind() * 1000.0;
+    }
+    _workers = nullptr;
+
+    _seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    double exploitability = (_values[0] + _values[1]) / 2.0;
+    cout << "Best response: " << exploitability << " mbb/hand (small blind " << _values[0]
+         << ", big blind " << _values[1] << "), " << _flops.size() / 3 << " flops in " << _seconds << " s" << endl;
+    return exploitability;
+}
+
+void BestResponse::walk(Worker& worker, int node, int traverser, const Board& board, const float* reachBot,
+                        float* values, bool parallel) {
+    // lines the bot never takes are worth nothing to either side
+    if (none_of(reachBot, reachBot + kCombos, [](float reach) { return reach > 0.0f; })) {
+        fill(values, values + kCombos, 0.0f);
+        return;
+    }
+
+    const BettingTree::Node& info = _tree.getNodes()[node];
+    const BotSpot& spot = _spots[node];
+    bool botActs = spot.seat != traverser;
+    int actions = BettingTree::getNumActions(info);
+    vector<float> strategy;
+    vector<float> childValues(static_cast<size_t>(actions) * kCombos);
+    vector<float> childReach(kCombos);
+
+    if (botActs) {
+        strategy.assign(static_cast<size_t>(actions) * kCombos, 0.0f);
+        float probabilities[kMaxActions];
+        for (int combo = 0; combo < kCombos; combo++) {
+            if (reachBot[combo] == 0.0f) continue;
+            worker.strategy->getStrategy(spot, HandCombos::getCards(combo), board.cards, board.size, probabilities);
+            for (int action = 0; action < kMaxActions; action++) {
+                if ((info.legalMask >> action) & 1u) {
+                    strategy[static_cast<size_t>(BettingTree::getActionSlot(info, action)) * kCombos + combo] =
+                        probabilities[action];
+                }
+            }
+        }
+    }
+
+    for (int action = 0; action < kMaxActions; action++) {
+        if (!((info.legalMask >> action) & 1u)) continue;
+        int slot = BettingTree::getActionSlot(info, action);
+        const float* reach = reachBot;
+        if (botActs) {
+            const float* sigma = &strategy[static_cast<size_t>(slot) * kCombos];
+            for (int combo = 0; combo < kCombos; combo++) childReach[combo] = reachBot[combo] * sigma[combo];
+            reach = childReach.data();
+        }
+        float* out = &childValues[static_cast<size_t>(slot) * kCombos];
+        const Outcome& outcome = _outcomes[static_cast<size_t>(node) * kMaxActions + action];
+        if (outcome.child == BettingTree::kNoChild) {
+            terminal(worker, outcome, traverser, board, reach, out, parallel);
+        } else if (outcome.nextStreet) {
+            deal(worker, board, reach, out, parallel,
+                 [&](Worker& dealer, const Board& next, const float* nextReach, float* nextValues) {
+                     walk(dealer, outcome.child, traverser, next, nextReach, nextValues, false);
+                 });
+        } else {
+            walk(worker, outcome.child, traverser, board, reach, out, parallel);
+        }
+    }
+
+    copy(childValues.begin(), childValues.begin() + kCombos, values);
+    for (int slot = 1; slot < actions; slot++) {
+        const float* out = &childValues[static_cast<size_t>(slot) * kCombos];
+        if (botActs) {
+            for (int combo = 0; combo < kCombos; combo++) values[combo] += out[combo];
+        } else {
+            for (int combo = 0; combo < kCombos; combo++) values[combo] = max(values[combo], out[combo]);
+        }
+    }
+}
+
+// All in before the river runs the remaining cards out through the same board sample.
+void BestResponse::terminal(Worker& worker, const Outcome& outcome, int traverser, const Board& board,
+                            const float* reachBot, float* values, bool parallel) {
+    if (outcome.folder >= 0) {
+        float payoff = outcome.folder == traverser ? -outcome.totalBets[traverser]
+                                                   : static_cast<float>(outcome.totalBets[outcome.folder]);
+        RangeEvaluator::foldValues(payoff, reachBot, values);
+        return;
+    }
+    if (board.size < 5) {
+        deal(worker, board, reachBot, values, parallel,
+             [&](Worker& dealer, const Board& next, const float* nextReach, float* nextValues) {
+                 terminal(dealer, outcome, traverser, next, nextReach, nextValues, false);
+             });
+        return;
+    }
+    float matched = static_cast<float>(min(outcome.totalBets[0], outcome.totalBets[1]));
+    RangeEvaluator::showdownValues(getRanking(worker, board), matched, reachBot, values);
+}
+
+// The next street's cards, from the sample. A hand's value is the average over the sampled
+// deals it does not block, scaled by how much more often a deal misses one hand than two
+// (19600 / 17296 flops, or total - 2 / total - 4 cards): that keeps the opponent hands it
+// meets at their exact count, so the best response cannot gain from a lucky sample, and
+// with every card dealt it is the exact chance weight.
+void BestResponse::deal(Worker& worker, const Board& board, const float* reachBot, float* values, bool parallel,
+                        const function<void(Worker&, const Board&, const float*, float*)>& next) {
+    vector<uint8_t> cards;
+    int count;
+    double scale;
+    if (board.size == 0) {
+        count = static_cast<int>(_flops.size() / 3);
+        scale = static_cast<double>(kFlopsMissingOneHand) / kFlopsMissingTwoHands;
+    } else {
+        sampleCards(board, cards);
+        count = static_cast<int>(cards.size());
+        int total = 52 - board.size;
+        scale = static_cast<double>(total - 2) / (total - 4);
+    }
+
+    struct Sum {
+        vector<double> values;
+        vector<int> deals;    // sampled deals that miss each hand
+    };
+    auto dealOne = [&](Worker& dealer, int index, vector<float>& reach, vector<float>& out, Sum& sum) {
+        Board child = board;
+        if (board.size == 0) {
+            for (int card = 0; card < 3; card++) child.cards[card] = _flops[index * 3 + card];
+            child.size = 3;
+            child.flop = index;
+        } else {
+            child.cards[child.size++] = cards[index];
+            (board.size == 3 ? child.turnSlot : child.riverSlot) = index;
+        }
+        uint64_t dealt = HandCombos::getMask(child.cards + board.size, child.size - board.size);
+        for (int combo = 0; combo < kCombos; combo++) {
+            reach[combo] = (HandCombos::getMask(combo) & dealt) ? 0.0f : reachBot[combo];
+        }
+        next(dealer, child, reach.data(), out.data());
+        for (int combo = 0; combo < kCombos; combo++) {
+            if (HandCombos::getMask(combo) & dealt) continue;
+            sum.values[combo] += out[combo];
+            sum.deals[combo]++;
+        }
+    };
+
+    int workers = !parallel || board.size != 0 ? 1 : _pool.size();
+    vector<Sum> sums(workers, Sum{vector<double>(kCombos, 0.0), vector<int>(kCombos, 0)});
+    if (workers == 1) {
+        vector<float> reach(kCombos), out(kCombos);
+        for (int index = 0; index < count; index++) dealOne(worker, index, reach, out, sums[0]);
+    } else {
+        // flops go out one at a time so uneven subtrees still balance; each worker sums its own
+        atomic<int> nextFlop(0);
+        _pool.run([&](int index) {
+            vector<float> reach(kCombos), out(kCombos);
+            for (int flop = nextFlop++; flop < count; flop = nextFlop++) {
+                dealOne(_workers[index], flop, reach, out, sums[index]);
+            }
+        });
+    }
+    for (int combo = 0; combo < kCombos; combo++) {
+        double total = 0.0;
+        int deals = 0;
+        for (const Sum& sum : sums) {
+            total += sum.values[combo];
+            deals += sum.deals[combo];
+        }
+        values[combo] = deals > 0 ? static_cast<float>(total * scale / deals) : 0.0f;
+    }
+}
+
+// Deterministic in the seed and the board so far, so every line that reaches a board deals
+// the same sample after it.
+void BestResponse::sampleCards(const Board& board, vector<uint8_t>& cards) const {
+    uint64_t used = HandCombos::getMask(board.cards, board.size);
+    cards.clear();
+    for (int card = 0; card < 52; card++) {
+        if (!((used >> card) & 1u)) cards.push_back(static_cast<uint8_t>(card));
+    }
+    int wanted = board.size == 3 ? _turnsPerFlop : _riversPerTurn;
+    int available = static_cast<int>(cards.size());
+    if (wanted <= 0 || wanted >= available) return;
+
+    EngineRng rng(_seed ^ (static_cast<uint64_t>(board.flop) << 16) ^ (board.size == 4 ? board.cards[3] + 1u : 0u));
+    rng.next();
+    for (int i = 0; i < wanted; i++) swap(cards[i], cards[i + rng.below(available - i)]);
+    cards.resize(wanted);
+}
+
+const RangeEvaluator::Ranking& BestResponse::getRanking(Worker& worker, const Board& board) const {
+    if (worker.flop != board.flop) {
+        fill(worker.ranked.begin(), worker.ranked.end(), 0);
+        worker.flop = board.flop;
+    }
+    size_t index = static_cast<size_t>(board.turnSlot) * kMaxRivers + board.riverSlot;
+    if (!worker.ranked[index]) {
+        RangeEvaluator::rankBoard(board.cards, worker.rankings[index]);
+        worker.ranked[index] = 1;
+    }
+    return worker.rankings[index];
+}
+
+double BestResponse::getBestResponseValue(int seat) const {
+    return _values[seat];
+}
+
+double BestResponse::getSeconds() const {
+    return _seconds;
+}
+
+const BettingTree& BestResponse::getTree() const {
+    return _tree;
+}
+
+const BotSpot& BestResponse::getSpot(int node) const {
+    return _spots[node];
+}
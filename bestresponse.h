@@ -0,0 +1,94 @@
+#ifndef BESTRESPONSE_H
+#define BESTRESPONSE_H
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "ruleset.h"
+#include "betabstraction.h"
+#include "bettingtree.h"
+#include "botstrategy.h"
+#include "rangeevaluator.h"
+#include "workerpool.h"
+
+// Exploitability of any bot in the abstract heads-up game a RuleSet and BetAbstraction define
+// (the game MccfrSolver trains on). The bot's strategy is read through a BotStrategy at every
+// spot it reaches, and a best response to it is computed exactly by walking the betting tree
+// once per seat with a value for each of the 1326 hands, the way LimitRangeSolver walks its
+// tree: the bot's reach goes down, the best response's value per hand comes up, and its
+// decisions take the best action hand by hand.
+//
+// Boards are the other half of the abstraction: the walk deals a random sample of flops,
+// then per flop a sample of turn cards and per turn of river cards. Every sampled card
+// stands for its share of the deck, so values estimate the full deal without bias and are
+// exact with every card dealt (flops 0, turns 0, rivers 0). Flops go out to the worker pool,
+// which asks one BotStrategy per worker.
+class BestResponse
+{
+public:
+    // called once per worker for a BotStrategy of its own
+    using StrategyFactory = std::function<std::unique_ptr<BotStrategy>()>;
+
+    BestResponse(const RuleSet& rules, const BetAbstraction& bets, int numThreads = 0);
+
+    // Flops dealt (0 for all 22100), then turn cards per flop and river cards per turn (0 for
+    // every card). The sample is fixed by the seed, so runs against different bots compare.
+    void setBoardSample(int flops, int turnsPerFlop, int riversPerTurn, uint64_t seed = 0);
+
+    // How much a best response wins against the bot, in milli big blinds per hand, averaged
+    // over both seats. Prints the time it took.
+    double computeExploitability(const StrategyFactory& makeStrategy);
+    // What the best response won in one seat (0 = small blind) in the last computation, mbb/hand.
+    double getBestResponseValue(int seat) const;
+    double getSeconds() const;   // of the last computation
+
+    const BettingTree& getTree() const;
+    const BotSpot& getSpot(int node) const;
+
+private:
+    // what one abstract action at one node leads to
+    struct Outcome {
+        int child;          // BettingTree node, kNoChild when the hand ends
+        bool nextStreet;    // a card comes before the child
+        int folder;         // the seat that folded, -1 for a showdown
+        int totalBets[2];
+    };
+
+    struct Board {
+        uint8_t cards[5];
+        int size;
+        int flop;           // index into _flops
+        int turnSlot;       // position in the flop's turn sample
+        int riverSlot;
+    };
+
+    struct Worker;
+
+    RuleSet _rules;
+    BetAbstraction _bets;
+    BettingTree _tree;
+    WorkerPool _pool;
+    std::vector<BotSpot> _spots;
+    std::vector<Outcome> _outcomes;   // node x BetAbstraction::kMaxActions
+    std::vector<uint8_t> _flops;      // 3 cards each
+    int _turnsPerFlop;
+    int _riversPerTurn;
+    uint64_t _seed;
+    Worker* _workers;                 // one per pool worker while a computation runs
+    double _values[2];
+    double _seconds;
+
+    template <typename Engine>
+    void expand(const Engine& table, int node);
+
+    void walk(Worker& worker, int node, int traverser, const Board& board, const float* reachBot, float* values,
+              bool parallel);
+    void terminal(Worker& worker, const Outcome& outcome, int traverser, const Board& board, const float* reachBot,
+                  float* values, bool parallel);
+    void deal(Worker& worker, const Board& board, const float* reachBot, float* values, bool parallel,
+              const std::function<void(Worker&, const Board&, const float*, float*)>& next);
+    void sampleCards(const Board& board, std::vector<uint8_t>& cards) const;
+    const RangeEvaluator::Ranking& getRanking(Worker& worker, const Board& board) const;
+};
+
+#endif // BESTRESPONSE_H
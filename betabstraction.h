@@ -0,0 +1,155 @@
+#ifndef BETABSTRACTION_H
+#define BETABSTRACTION_H
+#include <cmath>
+#include <vector>
+#include "poker_info.h"
+#include "tableengine.h"
+
+// Abstract action set for solvers: fold, check/call, raises sized as fractions of the pot
+// after calling, and all in. Ids are fixed (kFold, kCheckCall, then one per pot fraction,
+// then all in) so a betting sequence means the same thing at every node; which of them are
+// legal depends on the table. After maxRaisesPerStreet bets/raises on a street only fold and
+// check/call remain.
+//
+// Works on anything with the table engine getters (getLegalActions, getCurrentBet,
+// getPotSize, getCurrentSeat, getRoundBet).
+class BetAbstraction
+{
+public:
+    static const int kFold = 0;
+    static const int kCheckCall = 1;
+    static const int kFirstRaise = 2;
+    static const int kMaxActions = 8;
+
+    explicit BetAbstraction(const std::vector<double>& potFractions = {0.5, 1.0}, int maxRaisesPerStreet = 3)
+        : _potFractions(potFractions), _maxRaisesPerStreet(maxRaisesPerStreet) {
+        if (_potFractions.size() > static_cast<size_t>(kMaxActions - 3)) _potFractions.resize(kMaxActions - 3);
+    }
+
+    int getNumActions() const { return kFirstRaise + static_cast<int>(_potFractions.size()) + 1; }
+    int getAllInAction() const { return getNumActions() - 1; }
+    bool isRaise(int action) const { return action >= kFirstRaise; }
+    const std::vector<double>& getPotFractions() const { return _potFractions; }
+    int getMaxRaisesPerStreet() const { return _maxRaisesPerStreet; }
+
+    // Bit per abstract action id; sized raises only count when they land on distinct amounts
+    // below all in.
+    template <typename Table>
+    unsigned legalMask(const Table& table, int raisesThisStreet) const {
+        LegalActions legal = table.getLegalActions();
+        unsigned mask = 0;
+        bool facingBet = legal.has(Action::call);
+        if (facingBet && legal.has(Action::fold)) mask |= 1u << kFold;
+        if (legal.has(Action::check) || legal.has(Action::call)) mask |= 1u << kCheckCall;
+        if (raisesThisStreet >= _maxRaisesPerStreet) return mask;
+
+        if (legal.has(Action::bet) || legal.has(Action::raise)) {
+            int lastAmount = 0;
+            for (int i = 0; i < static_cast<int>(_potFractions.size()); i++) {
+                int amount = raiseAmount(table, legal, i);
+                if (amount > lastAmount && amount < legal.allInTo) {
+                    mask |= 1u << (kFirstRaise + i);
+                    lastAmount = amount;
+                }
+            }
+        }
+        if (legal.has(Action::all_in) && legal.allInTo > table.getCurrentBet()) mask |= 1u << getAllInAction();
+        return mask;
+    }
+
+    template <typename Table>
+    PlayerAction toPlayerAction(const Table& table, int action) const {
+        LegalActions legal = table.getLegalActions();
+        if (action == kFold) return PlayerAction(Action::fold);
+        if (action == kCheckCall) {
+            return legal.has(Action::check) ? PlayerAction(Action::check) : PlayerAction(Action::call, legal.callAmount);
+        }
+        if (action == getAllInAction()) return PlayerAction(Action::all_in, legal.allInTo);
+        Action type = table.getCurrentBet() == 0 ? Action::bet : Action::raise;
+        return PlayerAction(type, raiseAmount(table, legal, action - kFirstRaise));
+    }
+
+    // Abstract action for a real one. A bet or raise between two neighbouring sizes goes to the
+    // smaller one with the pseudo-harmonic probability getLowerShare: uniform, in [0, 1),
+    // decides, and the default 0.5 always takes the likelier side. All in is a size too, with
+    // the stack's pot fraction, so an overbet past the largest fraction falls between that
+    // fraction and all in; sizes below the smallest fraction go to it.
+    template <typename Table>
+    int translate(const Table& table, const PlayerAction& action, double uniform = 0.5) const {
+        switch (action.actionType) {
+        case Action::fold: return kFold;
+        case Action::check:
+        case Action::call: return kCheckCall;
+        case Action::all_in: return getAllInAction();
+        default: break;
+        }
+        LegalActions legal = table.getLegalActions();
+        return translateFraction(getPotFraction(table, action.amount), getPotFraction(table, legal.allInTo), uniform);
+    }
+
+    // The same for a size already given as a pot fraction, with all in at allInFraction; a
+    // handful of compares. Fractions at or past all in are all in.
+    int translateFraction(double fraction, double allInFraction, double uniform = 0.5) const {
+        if (fraction >= allInFraction) return getAllInAction();
+        int below = -1;
+        int above = -1;
+        for (int i = 0; i < static_cast<int>(_potFractions.size()); i++) {
+            double size = _potFractions[i];
+            if (size <= fraction && (below < 0 || size > _potFractions[below])) below = i;
+            if (size >= fraction && (above < 0 || size < _potFractions[above])) above = i;
+        }
+        // a fraction the stack cannot reach is no neighbour; all in is
+        bool allInAbove = above < 0 || _potFractions[above] >= allInFraction;
+        int upper = allInAbove ? getAllInAction() : kFirstRaise + above;
+        if (below < 0) return upper;
+        double upperFraction = allInAbove ? allInFraction : _potFractions[above];
+        if (upperFraction == _potFractions[below]) return kFirstRaise + below;
+        double lower = getLowerShare(_potFractions[below], upperFraction, fraction);
+        return uniform < lower ? kFirstRaise + below : upper;
+    }
+
+    // Pseudo-harmonic mapping (Ganzfried and Sandholm): how often a bet of x pot between the
+    // abstract sizes a < x < b should be read as a. It is 1 at a, 0 at b, and leans towards
+    // the smaller size the way the harmonic mean of the two does, which keeps an opponent
+    // from gaining much by betting in between.
+    static double getLowerShare(double a, double b, double x) {
+        return ((b - x) * (1.0 + a)) / ((b - a) * (1.0 + x));
+    }
+
+    // A raise size a node does not offer becomes the nearest raise it does; -1 if none.
+    static int nearestOffered(unsigned mask, int action) {
+        if ((mask >> action) & 1u) return action;
+        if (action < kFirstRaise) return -1;
+        for (int offset = 1; offset < kMaxActions; offset++) {
+            int below = action - offset;
+            int above = action + offset;
+            if (below >= kFirstRaise && ((mask >> below) & 1u)) return below;
+            if (above < kMaxActions && ((mask >> above) & 1u)) return above;
+        }
+        return -1;
+    }
+
+    // Raise size as a fraction of the pot after calling, for a "raise to" amount.
+    template <typename Table>
+    static double getPotFraction(const Table& table, int raiseTo) {
+        int toCall = table.getCurrentBet() - table.getRoundBet(table.getCurrentSeat());
+        int potAfterCall = table.getPotSize() + (toCall > 0 ? toCall : 0);
+        return potAfterCall > 0 ? static_cast<double>(raiseTo - table.getCurrentBet()) / potAfterCall : 1.0;
+    }
+
+private:
+    std::vector<double> _potFractions;
+    int _maxRaisesPerStreet;
+
+    template <typename Table>
+    int raiseAmount(const Table& table, const LegalActions& legal, int index) const {
+        int toCall = legal.callAmount;
+        int potAfterCall = table.getPotSize() + toCall;
+        int amount = table.getCurrentBet() + static_cast<int>(std::lround(_potFractions[index] * potAfterCall));
+        if (amount < legal.minRaiseTo) amount = legal.minRaiseTo;
+        if (amount > legal.maxRaiseTo) amount = legal.maxRaiseTo;
+        return amount;
+    }
+};
+
+#endif // BETABSTRACTION_H
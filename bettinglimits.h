@@ -0,0 +1,130 @@
+#ifndef BETTINGLIMITS_H
+#define BETTINGLIMITS_H
+#include "poker_info.h"
+#include "ruleset.h"
+
+// Legal moves for the seat to act: a bitmask over Action plus the amounts that go with it.
+// Bet/raise amounts are round totals ("raise to"), same as PlayerAction in GameManager.
+struct LegalActions {
+    unsigned mask;
+    int callAmount;  // chips a call adds
+    int minRaiseTo;
+    int maxRaiseTo;
+    int allInTo;
+
+    bool has(Action action) const { return (mask >> static_cast<int>(action)) & 1u; }
+};
+
+// Everything the legal moves of the seat to act depend on.
+struct BettingSpot {
+    int stack;              // chips behind
+    int roundBet;           // already in this betting round
+    int currentBet;
+    int potSize;            // everything put in this hand, this round included
+    int bigBlind;
+    int raisesThisRound;
+    int maxRaises;          // only limit games cap raises
+    bool opponentsCanAct;   // someone else can still answer a raise
+};
+
+// Bet sizing for each betting structure, fixed at compile time so the specialized
+// table engines never branch on the structure. RuleSet forwards its runtime queries
+// here, which keeps both paths on the same rules.
+template <BettingStructure Structure>
+struct BettingLimits;
+
+template <>
+struct BettingLimits<BettingStructure::NO_LIMIT> {
+    static constexpr bool capsRaises = false;
+
+    static int getMinimumRaise(int currentBet, int bigBlind) {
+        return currentBet + bigBlind;
+    }
+    static int getMaximumBet(int /*currentBet*/, int playerChips, int /*potSize*/, int /*bigBlind*/) {
+        return playerChips; // Can bet all chips
+    }
+    static bool isValidBet(int amount, int currentBet, int playerChips, int bigBlind) {
+        return amount >= getMinimumRaise(currentBet, bigBlind) || amount == playerChips;
+    }
+};
+
+template <>
+struct BettingLimits<BettingStructure::POT_LIMIT> {
+    static constexpr bool capsRaises = false;
+
+    static int getMinimumRaise(int currentBet, int bigBlind) {
+        return currentBet + bigBlind;
+    }
+    static int getMaximumBet(int currentBet, int playerChips, int potSize, int /*bigBlind*/) {
+        return playerChips < currentBet + potSize ? playerChips : currentBet + potSize;
+    }
+    static bool isValidBet(int amount, int currentBet, int /*playerChips*/, int bigBlind) {
+        return amount >= getMinimumRaise(currentBet, bigBlind);
+    }
+};
+
+template <>
+struct BettingLimits<BettingStructure::FIXED_LIMIT> {
+    static constexpr bool capsRaises = true; // RuleSet::getMaxRaises applies per round
+
+    static int getMinimumRaise(int currentBet, int bigBlind) {
+        return currentBet + bigBlind;
+    }
+    static int getMaximumBet(int currentBet, int /*playerChips*/, int /*potSize*/, int bigBlind) {
+        return currentBet + bigBlind; // Fixed increment
+    }
+    static bool isValidBet(int amount, int currentBet, int /*playerChips*/, int bigBlind) {
+        return amount == bigBlind || amount == currentBet + bigBlind;
+    }
+};
+
+// The legal moves at a spot. The table engines and GameManager all ask this, so every table
+// plays by the same rules: no raising into players who can't respond, limit games cap the
+// raises per round, a short call puts the rest of the stack in, and all in is legal when it
+// is no more than a call or a raise the structure allows.
+template <BettingStructure Structure>
+LegalActions getLegalActionsAt(const BettingSpot& spot) {
+    using Limits = BettingLimits<Structure>;
+    auto bit = [](Action action) { return 1u << static_cast<int>(action); };
+    LegalActions legal = {bit(Action::fold), 0, 0, 0, 0};
+    int toCall = spot.currentBet - spot.roundBet;
+    if (toCall <= 0) {
+        legal.mask |= bit(Action::check);
+    } else {
+        legal.mask |= bit(Action::call);
+        legal.callAmount = toCall < spot.stack ? toCall : spot.stack;
+    }
+
+    legal.allInTo = spot.roundBet + spot.stack;
+    legal.minRaiseTo = Limits::getMinimumRaise(spot.currentBet, spot.bigBlind);
+    legal.maxRaiseTo = Limits::getMaximumBet(spot.currentBet, legal.allInTo, spot.potSize, spot.bigBlind);
+
+    bool capped = Limits::capsRaises && spot.raisesThisRound >= spot.maxRaises;
+    bool canRaise = spot.opponentsCanAct && !capped && legal.allInTo > spot.currentBet;
+    if (canRaise && legal.minRaiseTo <= legal.allInTo && legal.minRaiseTo <= legal.maxRaiseTo) {
+        legal.mask |= bit(spot.currentBet == 0 ? Action::bet : Action::raise);
+        if (legal.maxRaiseTo > legal.allInTo) legal.maxRaiseTo = legal.allInTo;
+    }
+    if (spot.stack > 0 && (legal.allInTo <= spot.currentBet || (canRaise && legal.allInTo <= legal.maxRaiseTo))) {
+        legal.mask |= bit(Action::all_in);
+    }
+    return legal;
+}
+
+// getLegalActionsAt for a structure only known at runtime. Tables look it up once, when they
+// are set up, rather than switching on the structure at every decision.
+using LegalActionsRule = LegalActions (*)(const BettingSpot& spot);
+
+inline LegalActionsRule getLegalActionsRule(BettingStructure structure) {
+    switch (structure) {
+    case BettingStructure::POT_LIMIT:
+        return &getLegalActionsAt<BettingStructure::POT_LIMIT>;
+    case BettingStructure::FIXED_LIMIT:
+        return &getLegalActionsAt<BettingStructure::FIXED_LIMIT>;
+    case BettingStructure::NO_LIMIT:
+    default:
+        return &getLegalActionsAt<BettingStructure::NO_LIMIT>;
+    }
+}
+
+#endif // BETTINGLIMITS_H
@@ -0,0 +1,72 @@
+#include "bettingtree.h"
+#include "headsupengine.h"
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+static_assert(sizeof(BettingTree::Node) == 48, "nodes are stored as-is in strategy files");
+
+template <typename Engine>
+int expand(const Engine& table, int raises, const BetAbstraction& bets, vector<BettingTree::Node>& nodes) {
+    int index = static_cast<int>(nodes.size());
+    nodes.push_back(BettingTree::Node());
+    BettingTree::Node node = BettingTree::Node();
+    node.street = static_cast<uint8_t>(CardAbstraction::getStreet(table.getBoardSize()));
+    node.actor = table.getCurrentSeat() == table.getSmallBlindSeat() ? 0 : 1;
+
+    unsigned mask = bets.legalMask(table, raises);
+    for (int action = 0; action < BetAbstraction::kMaxActions; action++) {
+        node.children[action] = BettingTree::kNoChild;
+        if (!((mask >> action) & 1u)) continue;
+        Engine child = table;
+        if (!child.applyAction(bets.toPlayerAction(child, action))) {
+            mask &= ~(1u << action);
+            continue;
+        }
+        if (child.isHandOver()) continue;
+        int childRaises = child.getPhase() == table.getPhase() ? raises + (bets.isRaise(action) ? 1 : 0) : 0;
+        node.children[action] = expand(child, childRaises, bets, nodes);
+    }
+    node.legalMask = static_cast<uint16_t>(mask);
+    nodes[index] = node;
+    return index;
+}
+
+template <typename Engine>
+void build(const RuleSet& rules, const BetAbstraction& bets, vector<BettingTree::Node>& nodes) {
+    Engine table(rules);
+    table.setButton(1);
+    if (!table.startHand()) throw runtime_error("Betting tree needs positive starting stacks");
+    expand(table, 0, bets, nodes);
+}
+
+}
+
+BettingTree::BettingTree(const RuleSet& rules, const BetAbstraction& bets, const CardAbstraction& cards)
+    : _numCells(0) {
+    switch (rules.getBettingType()) {
+    case BettingStructure::NO_LIMIT:
+        build<HeadsUpEngine<BettingStructure::NO_LIMIT>>(rules, bets, _nodes);
+        break;
+    case BettingStructure::POT_LIMIT:
+        build<HeadsUpEngine<BettingStructure::POT_LIMIT>>(rules, bets, _nodes);
+        break;
+    case BettingStructure::FIXED_LIMIT:
+        build<HeadsUpEngine<BettingStructure::FIXED_LIMIT>>(rules, bets, _nodes);
+        break;
+    }
+    for (Node& node : _nodes) {
+        node.firstCell = _numCells;
+        _numCells += static_cast<uint64_t>(cards.getNumBuckets(node.street)) * getNumActions(node);
+    }
+}
+
+const vector<BettingTree::Node>& BettingTree::getNodes() const {
+    return _nodes;
+}
+
+uint64_t BettingTree::getNumCells() const {
+    return _numCells;
+}
@@ -0,0 +1,47 @@
+#ifndef BETTINGTREE_H
+#define BETTINGTREE_H
+#include <cstdint>
+#include <vector>
+#include "ruleset.h"
+#include "betabstraction.h"
+#include "cardabstraction.h"
+
+// Every betting sequence of the abstract heads-up game, enumerated once so infosets get dense
+// indices. Node 0 is the first preflop decision; a node's children are indexed by abstract
+// action id. Betting never depends on the cards, so the tree is the same for every deal and
+// infoset (node, bucket) owns cells [firstCell + bucket * n, firstCell + (bucket + 1) * n)
+// for the node's n legal actions, in action id order.
+class BettingTree
+{
+public:
+    static const int kNoChild = -1;   // the action ends the hand (or is not legal)
+
+    struct Node {
+        uint64_t firstCell;
+        int32_t children[BetAbstraction::kMaxActions];
+        uint16_t legalMask;
+        uint8_t street;
+        uint8_t actor;       // 0 = small blind, 1 = big blind
+        uint32_t reserved;
+    };
+
+    BettingTree(const RuleSet& rules, const BetAbstraction& bets, const CardAbstraction& cards);
+
+    const std::vector<Node>& getNodes() const;
+    uint64_t getNumCells() const;
+
+    static int getNumActions(const Node& node) { return __builtin_popcount(node.legalMask); }
+    // position of an action within its node's cells
+    static int getActionSlot(const Node& node, int action) {
+        return __builtin_popcount(node.legalMask & ((1u << action) - 1u));
+    }
+    static uint64_t getCell(const Node& node, int bucket) {
+        return node.firstCell + static_cast<uint64_t>(bucket) * getNumActions(node);
+    }
+
+private:
+    std::vector<Node> _nodes;
+    uint64_t _numCells;
+};
+
+#endif // BETTINGTREE_H
@@ -0,0 +1,108 @@
+#include "botstrategy.h"
+#include "gamestateview.h"
+#include "handcombos.h"
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+// Fills the other chair at a PlayerStrategy table; it is never asked to act.
+class EmptyChair : public Player {
+public:
+    EmptyChair() : Player("empty chair", 0) {}
+    PlayerAction makeDecision(const Gamestate& /*gameState*/, GameManager* /*gameManager*/) {
+        return PlayerAction(Action::fold);
+    }
+};
+
+void checkCallOnly(float* probabilities) {
+    for (int action = 0; action < BetAbstraction::kMaxActions; action++) probabilities[action] = 0.0f;
+    probabilities[BetAbstraction::kCheckCall] = 1.0f;
+}
+
+}
+
+SolverStrategy::SolverStrategy(shared_ptr<const MccfrSolver> solver)
+    : _solver(solver) {
+    if (!_solver) throw runtime_error("SolverStrategy needs a trained solver");
+}
+
+void SolverStrategy::getStrategy(const BotSpot& spot, const uint8_t* hole, const uint8_t* board, int boardSize,
+                                 float* probabilities) {
+    uint64_t boardMask = HandCombos::getMask(board, boardSize);
+    if (_buckets.size() >= kMaxCachedBoards && !_buckets.count(boardMask)) _buckets.clear();
+    vector<int>& buckets = _buckets[boardMask];
+    if (buckets.empty()) buckets.assign(HandCombos::kNumCombos, -1);
+    int& bucket = buckets[HandCombos::getIndex(hole[0], hole[1])];
+    if (bucket < 0) bucket = _solver->getCardAbstraction().getBucket(hole, board, boardSize);
+    if (!_solver->getAverageStrategy(spot.node, bucket, probabilities)) checkCallOnly(probabilities);
+}
+
+PlayerStrategy::PlayerStrategy(const RuleSet& rules, const BetAbstraction& bets, shared_ptr<Player> player,
+                               int samples)
+    : _bets(bets), _player(player), _table(rules), _samples(samples > 0 ? samples : 1), _node(-1), _boardMask(0) {
+    if (!_player) throw runtime_error("PlayerStrategy needs a player");
+    _table.addPlayer(_player);
+    _table.addPlayer(make_shared<EmptyChair>());
+}
+
+void PlayerStrategy::getStrategy(const BotSpot& spot, const uint8_t* hole, const uint8_t* board, int boardSize,
+                                 float* probabilities) {
+    uint64_t boardMask = HandCombos::getMask(board, boardSize);
+    if (spot.node != _node || boardMask != _boardMask) {
+        setUpSpot(spot, board, boardSize);
+        _node = spot.node;
+        _boardMask = boardMask;
+    }
+    _seats.holeCards[0].clear();
+    _seats.dealCard(0, Card::fromIndex(hole[0]));
+    _seats.dealCard(0, Card::fromIndex(hole[1]));
+    _table.loadPosition(_seats, _state);
+
+    const Gamestate& table = _table.getGameState();
+    GamestateView view(table, 0);
+    for (int action = 0; action < BetAbstraction::kMaxActions; action++) probabilities[action] = 0.0f;
+    for (int sample = 0; sample < _samples; sample++) {
+        _player->reset();
+        PlayerAction decision = _player->makeDecision(table, &_table);
+        int action = BetAbstraction::nearestOffered(spot.legalMask, _bets.translate(view, decision));
+        if (action < 0) action = BetAbstraction::kCheckCall;   // e.g. folding when checking is free
+        probabilities[action] += 1.0f / _samples;
+    }
+}
+
+// Everything but the hole cards, which are all that change from one hand to the next.
+void PlayerStrategy::setUpSpot(const BotSpot& spot, const uint8_t* board, int boardSize) {
+    // the player always sits in table seat 0, so the spot's seats swap when it is the big blind
+    int tableSeat[2] = {spot.seat == 0 ? 0 : 1, spot.seat == 0 ? 1 : 0};
+    _seats = SeatState();
+    _seats.addSeat(0);
+    _seats.addSeat(0);
+    for (int seat = 0; seat < 2; seat++) {
+        int at = tableSeat[seat];
+        _seats.stacks[at] = spot.stacks[seat];
+        _seats.roundBets[at] = spot.roundBets[seat];
+        _seats.totalBets[at] = spot.totalBets[seat];
+        if ((spot.allInMask >> seat) & 1u) _seats.allIn |= 1u << at;
+    }
+
+    // heads-up GameManager puts the dealer button on the big blind
+    const Gamestate& table = _table.getGameState();
+    _state = Gamestate();
+    _state.reset();
+    _state.setBlinds(table.getSmallBlind(), table.getBigBlind());
+    _state.setDealerPosition(tableSeat[1]);
+    _state.setSmallBlindPosition(tableSeat[0]);
+    _state.setBigBlindPosition(tableSeat[1]);
+    for (const ActionRecord& record : spot.history) {
+        _state.setCurrentPhase(record.phase);
+        _state.addActionToHistory(PlayerAction(record.actionType, record.amount), tableSeat[record.seat]);
+        _seats.acted |= 1u << tableSeat[record.seat];
+    }
+    _state.setCurrentPhase(spot.phase);
+    _state.setBettingRound(1 + CardAbstraction::getStreet(boardSize));
+    for (int i = 0; i < boardSize; i++) _state.addCommunityCards(Card::fromIndex(board[i]));
+    _state.setCurrentBet(spot.currentBet);
+    _state.setCurrentPlayerIndex(0);
+}
@@ -0,0 +1,83 @@
+#ifndef BOTSTRATEGY_H
+#define BOTSTRATEGY_H
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "poker_info.h"
+#include "ruleset.h"
+#include "betabstraction.h"
+#include "gamemanager.h"
+#include "mccfrsolver.h"
+
+// A point of the abstract heads-up game (a BettingTree over a BetAbstraction) where a bot has
+// to act, minus the cards. Seats are 0 = small blind (the button), 1 = big blind; chip counts
+// are after everything put in so far, the history is as HeadsUpEngine records it.
+struct BotSpot {
+    int node;               // BettingTree node
+    unsigned legalMask;     // abstract actions the node offers
+    int seat;
+    GamePhase phase;
+    int currentBet;
+    int stacks[2];
+    int roundBets[2];
+    int totalBets[2];
+    unsigned allInMask;
+    std::vector<ActionRecord> history;
+};
+
+// How a bot plays the abstract game: probabilities over abstract action ids (only the spot's
+// legal ones nonzero) for given hole cards and board. Instances are used from one thread.
+class BotStrategy
+{
+public:
+    virtual ~BotStrategy() {}
+    virtual void getStrategy(const BotSpot& spot, const uint8_t* hole, const uint8_t* board, int boardSize,
+                             float* probabilities) = 0;
+};
+
+// The average strategy of a trained MccfrSolver, read straight from its store; spots it never
+// visited check/call, like CfrBot. The solver's tree must be the one the spots come from.
+class SolverStrategy : public BotStrategy
+{
+public:
+    explicit SolverStrategy(std::shared_ptr<const MccfrSolver> solver);
+    void getStrategy(const BotSpot& spot, const uint8_t* hole, const uint8_t* board, int boardSize,
+                     float* probabilities);
+
+private:
+    static const size_t kMaxCachedBoards = 4096;
+
+    std::shared_ptr<const MccfrSolver> _solver;
+    // card buckets per board (by card mask), filled in as hands are asked for: bucketing
+    // postflop hands is far dearer than reading the strategy
+    std::unordered_map<uint64_t, std::vector<int>> _buckets;
+};
+
+// Any Player, asked through its makeDecision at a private GameManager table set up to the
+// spot. The real action it picks is mapped onto the bet abstraction (nearest pot fraction).
+// Bots that randomize are asked samples times and their answers counted; anything the spot
+// does not offer becomes check/call. BestResponse asks from worker threads, so bots that
+// share state between instances (or print) want a single thread.
+class PlayerStrategy : public BotStrategy
+{
+public:
+    PlayerStrategy(const RuleSet& rules, const BetAbstraction& bets, std::shared_ptr<Player> player, int samples = 1);
+    void getStrategy(const BotSpot& spot, const uint8_t* hole, const uint8_t* board, int boardSize,
+                     float* probabilities);
+
+private:
+    BetAbstraction _bets;
+    std::shared_ptr<Player> _player;
+    GameManager _table;     // the player sits in seat 0, a placeholder in seat 1
+    int _samples;
+    // the last spot set up, kept while only the hole cards change
+    int _node;
+    uint64_t _boardMask;
+    SeatState _seats;
+    Gamestate _state;
+
+    void setUpSpot(const BotSpot& spot, const uint8_t* board, int boardSize);
+};
+
+#endif // BOTSTRATEGY_H
@@ -26,6 +26,14 @@ int Card::getSuit() const {
     return _suit;
 }
 
+int Card::getIndex() const {
+    return _rank * 4 + _suit;
+}
+
+Card Card::fromIndex(int index) {
+    return Card(index / 4, index % 4);
+}
+
 string Card::toString() const {
     return rankToString(_rank) + suitToString(_suit);
 }
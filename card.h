@@ -10,6 +10,8 @@ public:
     Card(int rank, int suit);
     int getRank() const;
     int getSuit() const;
+    int getIndex() const;             // 0-51, rank * 4 + suit
+    static Card fromIndex(int index);
     std::string toString() const;
     bool operator==(const Card& other) const;
     bool operator<(const Card& other) const;
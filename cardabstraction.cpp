@@ -0,0 +1,184 @@
+#include "cardabstraction.h"
+#include "handstrengthevaluator.h"
+#include <cstdio>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+struct ClusteredBuckets::Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t numBuckets[4];
+    uint32_t entryBytes;
+    uint32_t reserved;
+    uint64_t offsets[4];
+    uint64_t entries[4];
+    uint64_t fileSize;
+    uint8_t padding[24];
+};
+
+namespace {
+
+const uint32_t kMagic = 0x41434b50;   // 'PKCA'
+const uint32_t kVersion = 1;
+
+size_t alignUp(size_t offset) {
+    return (offset + 63) & ~static_cast<size_t>(63);
+}
+
+}
+
+int CardAbstraction::getBucket(const Hand& hole, const vector<Card>& board) const {
+    const vector<Card>& cards = hole.getCards();
+    if (cards.size() < 2) throw runtime_error("Bucketing needs two hole cards");
+    uint8_t holeCards[2] = {static_cast<uint8_t>(cards[0].getIndex()), static_cast<uint8_t>(cards[1].getIndex())};
+    uint8_t boardCards[5];
+    int boardSize = 0;
+    for (const Card& card : board) {
+        if (boardSize < 5) boardCards[boardSize++] = static_cast<uint8_t>(card.getIndex());
+    }
+    return getBucket(holeCards, boardCards, boardSize);
+}
+
+int CardAbstraction::getPreflopClass(const uint8_t* hole) {
+    int high = hole[0] / 4;
+    int low = hole[1] / 4;
+    if (high < low) {
+        int swap = high;
+        high = low;
+        low = swap;
+    }
+    bool suited = hole[0] % 4 == hole[1] % 4;
+    // pairs on the diagonal, suited above it, offsuit below it
+    return suited ? high * 13 + low : low * 13 + high;
+}
+
+StrengthBuckets::StrengthBuckets(int postflopBuckets)
+    : _postflopBuckets(postflopBuckets > 0 ? postflopBuckets : 1) {
+}
+
+int StrengthBuckets::getNumBuckets(int street) const {
+    return street == 0 ? 169 : _postflopBuckets;
+}
+
+int StrengthBuckets::getBucket(const uint8_t* hole, const uint8_t* board, int boardSize) const {
+    if (boardSize == 0) return getPreflopClass(hole);
+    int bucket = static_cast<int>(getHandStrength(hole, board, boardSize) * _postflopBuckets);
+    return bucket < _postflopBuckets ? bucket : _postflopBuckets - 1;
+}
+
+double StrengthBuckets::getHandStrength(const uint8_t* hole, const uint8_t* board, int boardSize) {
+    return HandStrengthEvaluator::getHandStrength(hole, board, boardSize);
+}
+
+ClusteredBuckets::ClusteredBuckets(const string& path)
+    : _mapping(nullptr), _mappedBytes(0), _entryBytes(1) {
+    static_assert(sizeof(Header) == 128, "header is 128 bytes on disk");
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw runtime_error("Could not open card abstraction " + path);
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw runtime_error("Could not read card abstraction " + path);
+    }
+    _mappedBytes = static_cast<size_t>(info.st_size);
+    _mapping = _mappedBytes >= sizeof(Header) ? mmap(nullptr, _mappedBytes, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (_mapping == MAP_FAILED) {
+        _mapping = nullptr;
+        throw runtime_error("Could not map card abstraction " + path);
+    }
+
+    const char* base = static_cast<const char*>(_mapping);
+    const Header* header = reinterpret_cast<const Header*>(base);
+    bool valid = header->magic == kMagic && header->version == kVersion && header->fileSize == _mappedBytes
+                 && (header->entryBytes == 1 || header->entryBytes == 2);
+    for (int street = 1; street < 4 && valid; street++) {
+        valid = header->numBuckets[street] > 0 && header->numBuckets[street] <= 65536
+                && header->entries[street] == _indexer.getSize(street)
+                && header->offsets[street] + header->entries[street] * header->entryBytes <= _mappedBytes;
+    }
+    if (!valid) {
+        munmap(_mapping, _mappedBytes);
+        _mapping = nullptr;
+        throw runtime_error("Malformed card abstraction " + path);
+    }
+    _entryBytes = static_cast<int>(header->entryBytes);
+    _numBuckets[0] = 169;
+    _tables[0] = nullptr;
+    for (int street = 1; street < 4; street++) {
+        _numBuckets[street] = static_cast<int>(header->numBuckets[street]);
+        _tables[street] = reinterpret_cast<const uint8_t*>(base + header->offsets[street]);
+    }
+}
+
+ClusteredBuckets::~ClusteredBuckets() {
+    if (_mapping) munmap(_mapping, _mappedBytes);
+}
+
+int ClusteredBuckets::getNumBuckets(int street) const {
+    return _numBuckets[street];
+}
+
+int ClusteredBuckets::getBucket(const uint8_t* hole, const uint8_t* board, int boardSize) const {
+    if (boardSize == 0) return getPreflopClass(hole);
+    uint64_t index = _indexer.getIndex(hole, board, boardSize);
+    const uint8_t* table = _tables[getStreet(boardSize)];
+    if (_entryBytes == 1) return table[index];
+    return reinterpret_cast<const uint16_t*>(table)[index];
+}
+
+void ClusteredBuckets::save(const string& path, const HandIndexer& indexer, const int* numBuckets,
+                            const vector<uint16_t>* tables) {
+    Header header = Header();
+    header.magic = kMagic;
+    header.version = kVersion;
+    header.numBuckets[0] = 169;
+    header.entryBytes = 1;
+    size_t offset = sizeof(Header);
+    for (int street = 1; street < 4; street++) {
+        if (tables[street].size() != indexer.getSize(street) || numBuckets[street] <= 0 || numBuckets[street] > 65536) {
+            throw runtime_error("Card abstraction tables do not match the hand indexer");
+        }
+        header.numBuckets[street] = static_cast<uint32_t>(numBuckets[street]);
+        header.entries[street] = tables[street].size();
+        if (numBuckets[street] > 256) header.entryBytes = 2;
+    }
+    for (int street = 1; street < 4; street++) {
+        offset = alignUp(offset);
+        header.offsets[street] = offset;
+        offset += header.entries[street] * header.entryBytes;
+    }
+    header.fileSize = alignUp(offset);
+
+    string temporary = path + ".tmp";
+    FILE* file = fopen(temporary.c_str(), "wb");
+    if (!file) throw runtime_error("Could not write card abstraction " + path);
+    bool ok = fwrite(&header, sizeof(Header), 1, file) == 1;
+    size_t written = sizeof(Header);
+    vector<uint8_t> chunk;
+    for (int street = 1; street < 4 && ok; street++) {
+        chunk.assign(header.offsets[street] - written, 0);
+        ok = chunk.empty() || fwrite(chunk.data(), 1, chunk.size(), file) == chunk.size();
+        written = header.offsets[street];
+        const vector<uint16_t>& table = tables[street];
+        if (header.entryBytes == 2) {
+            ok = ok && fwrite(table.data(), sizeof(uint16_t), table.size(), file) == table.size();
+        } else {
+            chunk.assign(table.begin(), table.end());
+            ok = ok && fwrite(chunk.data(), 1, chunk.size(), file) == chunk.size();
+        }
+        written += table.size() * header.entryBytes;
+    }
+    chunk.assign(header.fileSize - written, 0);
+    ok = ok && (chunk.empty() || fwrite(chunk.data(), 1, chunk.size(), file) == chunk.size());
+    ok = fclose(file) == 0 && ok;
+    if (!ok || rename(temporary.c_str(), path.c_str()) != 0) {
+        remove(temporary.c_str());
+        throw runtime_error("Failed writing card abstraction " + path);
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef CARDABSTRACTION_H
+#define CARDABSTRACTION_H
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "card.h"
+#include "hand.h"
+#include "handindexer.h"
+
+// Groups private cards (given the board) into buckets per street so that strategically
+// similar hands share an infoset. Cards are Card::getIndex values; street is 0 preflop,
+// 1 flop, 2 turn, 3 river.
+class CardAbstraction
+{
+public:
+    virtual ~CardAbstraction() {}
+    virtual int getNumBuckets(int street) const = 0;
+    virtual int getBucket(const uint8_t* hole, const uint8_t* board, int boardSize) const = 0;
+    // The same for cards as the game classes hold them.
+    int getBucket(const Hand& hole, const std::vector<Card>& board) const;
+
+    static int getStreet(int boardSize) { return boardSize == 0 ? 0 : boardSize - 2; }
+    // The 169 strategically distinct starting hands: pairs, suited and offsuit rank pairs.
+    static int getPreflopClass(const uint8_t* hole);
+};
+
+// 169 preflop classes; after the flop, the share of opponent holdings the hand currently
+// beats (ties count half), cut into equal-width buckets.
+class StrengthBuckets : public CardAbstraction
+{
+public:
+    explicit StrengthBuckets(int postflopBuckets = 8);
+    int getNumBuckets(int street) const;
+    int getBucket(const uint8_t* hole, const uint8_t* board, int boardSize) const;
+    using CardAbstraction::getBucket;
+
+    static double getHandStrength(const uint8_t* hole, const uint8_t* board, int boardSize);
+
+private:
+    int _postflopBuckets;
+};
+
+// 169 preflop classes; after the flop, buckets read straight from a table AbstractionBuilder
+// wrote, one entry per HandIndexer index of the street, so a lookup is an index computation and
+// one memory read. The table is mapped read-only and shared between processes; clusters are
+// numbered from weakest to strongest.
+//
+// File layout, little endian: 128-byte header { 'PKCA', version, buckets per street, entry
+// bytes (1 or 2), reserved, offset per street, fileSize }, then the flop, turn and river
+// tables, each 64-byte aligned.
+class ClusteredBuckets : public CardAbstraction
+{
+public:
+    explicit ClusteredBuckets(const std::string& path);
+    ~ClusteredBuckets();
+    ClusteredBuckets(const ClusteredBuckets&) = delete;
+    ClusteredBuckets& operator=(const ClusteredBuckets&) = delete;
+
+    int getNumBuckets(int street) const;
+    int getBucket(const uint8_t* hole, const uint8_t* board, int boardSize) const;
+    using CardAbstraction::getBucket;
+
+    // Writes a table: numBuckets per street (preflop ignored), tables[street] holding one
+    // bucket per index of the street. Via a temporary file, like StrategyStore::save.
+    static void save(const std::string& path, const HandIndexer& indexer, const int* numBuckets,
+                     const std::vector<uint16_t>* tables);
+
+private:
+    struct Header;
+
+    HandIndexer _indexer;
+    void* _mapping;
+    size_t _mappedBytes;
+    int _numBuckets[4];
+    int _entryBytes;
+    const uint8_t* _tables[4];
+};
+
+#endif // CARDABSTRACTION_H
@@ -0,0 +1,229 @@
+#include "cfrbot.h"
+#include "gamemanager.h"
+#include "gamestateview.h"
+#include <algorithm>
+#include <climits>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+// Just enough of a table to size past bets against the pot and the stack for
+// BetAbstraction::translate: the blinds are posted, then every recorded action is replayed in
+// order.
+class ReplayTable
+{
+public:
+    ReplayTable(const Gamestate& state)
+        : _currentSeat(-1), _currentBet(state.getBigBlind()), _pot(0) {
+        const SeatState* seats = state.getSeats();
+        for (int seat = 0; seat < kMaxSeats; seat++) {
+            _roundBets[seat] = 0;
+            // what each seat started the hand with; unknown seats never run out
+            _stacks[seat] = seats && seat < seats->size() ? seats->stacks[seat] + seats->totalBets[seat] : INT_MAX / 2;
+        }
+        post(state.getSmallBlindPosition(), state.getSmallBlind());
+        post(state.getBigBlindPosition(), state.getBigBlind());
+    }
+
+    void newStreet() {
+        for (int seat = 0; seat < kMaxSeats; seat++) _roundBets[seat] = 0;
+        _currentBet = 0;
+    }
+
+    void setCurrentSeat(int seat) { _currentSeat = seat; }
+
+    void apply(const ActionRecord& record) {
+        int seat = record.seat;
+        switch (record.actionType) {
+        case Action::call:
+            post(seat, min(_currentBet - _roundBets[seat], _stacks[seat]));
+            break;
+        case Action::bet:
+        case Action::raise:
+            if (record.amount > _roundBets[seat]) post(seat, record.amount - _roundBets[seat]);
+            if (_roundBets[seat] > _currentBet) _currentBet = _roundBets[seat];
+            break;
+        case Action::all_in:
+            // GameManager records a shove with amount 0: it is always the seat's whole stack
+            post(seat, _stacks[seat]);
+            if (_roundBets[seat] > _currentBet) _currentBet = _roundBets[seat];
+            break;
+        default:
+            break;
+        }
+    }
+
+    int getCurrentSeat() const { return _currentSeat; }
+    int getCurrentBet() const { return _currentBet; }
+    int getRoundBet(int seat) const { return _roundBets[seat]; }
+    int getPotSize() const { return _pot; }
+    // Only all in is filled in: the replay sizes actions, it does not judge them.
+    LegalActions getLegalActions() const {
+        LegalActions legal = {};
+        legal.allInTo = _roundBets[_currentSeat] + _stacks[_currentSeat];
+        return legal;
+    }
+
+private:
+    static const int kMaxSeats = 32;
+    int _roundBets[kMaxSeats];
+    int _stacks[kMaxSeats];   // chips still behind
+    int _currentSeat;
+    int _currentBet;
+    int _pot;
+
+    void post(int seat, int amount) {
+        if (seat < 0 || seat >= kMaxSeats || amount <= 0) return;
+        _roundBets[seat] += amount;
+        _stacks[seat] -= amount;
+        _pot += amount;
+    }
+};
+
+// [0, 1) from a seed and an action's place in the history
+double getUniform(uint64_t seed, size_t index) {
+    return (EngineRng::getStreamSeed(seed, index) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+}
+
+CfrBot::CfrBot(const string& name, int chips, shared_ptr<const MccfrSolver> solver, int position)
+    : Player(name, chips, position), _solver(solver), _sampling(false), _rng(0), _randomizedTranslation(false),
+    _translationSeed(0), _recorded(0) {
+    if (!_solver) throw runtime_error("CfrBot needs a trained solver");
+}
+
+void CfrBot::reset() {
+    _recorded = 0;
+    _translationSeed = _randomizedTranslation ? (static_cast<uint64_t>(_rng()) << 32 | _rng()) | 1u : 0;
+}
+
+void CfrBot::setTranslation(bool randomized, shared_ptr<TranslationStats> stats) {
+    _randomizedTranslation = randomized;
+    _stats = stats;
+    reset();
+}
+
+void CfrBot::setSampling(bool sampling, unsigned seed) {
+    _sampling = sampling;
+    _rng.seed(seed);
+}
+
+int CfrBot::tracePath(const MccfrSolver& solver, const Gamestate& gameState, vector<PathStep>& path,
+                      uint64_t translationSeed) {
+    const BetAbstraction& bets = solver.getBetAbstraction();
+    const StrategyStore& store = solver.getStore();
+    ReplayTable replay(gameState);
+    int node = 0;
+    GamePhase street = GamePhase::preflop;
+    path.clear();
+    for (const ActionRecord& record : gameState.getActionHistory()) {
+        if (node == BettingTree::kNoChild) return node;
+        if (record.phase != street) {
+            street = record.phase;
+            replay.newStreet();
+        }
+        const BettingTree::Node& info = store.getNode(node);
+        replay.setCurrentSeat(record.seat);
+        double uniform = translationSeed ? getUniform(translationSeed, path.size()) : 0.5;
+        int action = bets.translate(replay, PlayerAction(record.actionType, record.amount), uniform);
+        action = BetAbstraction::nearestOffered(info.legalMask, action);
+        if (action < 0) return BettingTree::kNoChild;
+        path.push_back({node, record.seat, action, record.phase});
+        node = info.children[action];
+        replay.apply(record);
+    }
+    return node;
+}
+
+int CfrBot::findNode(const MccfrSolver& solver, const Gamestate& gameState, int seat) {
+    vector<PathStep> path;
+    return checkNode(solver, gameState, seat, tracePath(solver, gameState, path));
+}
+
+int CfrBot::checkNode(const MccfrSolver& solver, const Gamestate& gameState, int seat, int node) {
+    if (node == BettingTree::kNoChild) return node;
+
+    // the legacy table may order streets or players differently from the engine
+    const BettingTree::Node& info = solver.getStore().getNode(node);
+    bool smallBlind = seat == gameState.getSmallBlindPosition();
+    int boardStreet = CardAbstraction::getStreet(static_cast<int>(gameState.getCommunityCards().size()));
+    if (info.street != boardStreet || (info.actor == 0) != smallBlind) return BettingTree::kNoChild;
+    return node;
+}
+
+PlayerAction CfrBot::makeDecision(const Gamestate& gameState, GameManager* /*gameManager*/) {
+    int seat = getSeat();
+    const BetAbstraction& bets = _solver->getBetAbstraction();
+    GamestateView view(gameState, seat);
+    unsigned tableMask = bets.legalMask(view, 0);
+    bool canCheckCall = (tableMask >> BetAbstraction::kCheckCall) & 1u;
+    PlayerAction fallback = canCheckCall ? bets.toPlayerAction(view, BetAbstraction::kCheckCall)
+                                         : PlayerAction(Action::fold);
+
+    if (_stats) recordSizes(gameState, seat);
+    vector<PathStep> path;
+    int node = checkNode(*_solver, gameState, seat, tracePath(*_solver, gameState, path, _translationSeed));
+    if (node == BettingTree::kNoChild) return fallback;
+    int bucket = _solver->getCardAbstraction().getBucket(view.getHoleCards(seat), view.getBoard(), view.getBoardSize());
+    float probabilities[BetAbstraction::kMaxActions];
+    if (!_solver->getAverageStrategy(node, bucket, probabilities)) return fallback;
+
+    // the strategy only covers what both the tree node and the real table allow
+    float total = 0.0f;
+    for (int action = 0; action < BetAbstraction::kMaxActions; action++) {
+        if (!((tableMask >> action) & 1u)) probabilities[action] = 0.0f;
+        total += probabilities[action];
+    }
+    if (total <= 0.0f) return fallback;
+
+    return bets.toPlayerAction(view, pickAction(probabilities, BetAbstraction::kMaxActions));
+}
+
+// Counts the opponent's bet and raise sizes not counted yet this hand, on the tree or off it.
+void CfrBot::recordSizes(const Gamestate& gameState, int seat) {
+    const BetAbstraction& bets = _solver->getBetAbstraction();
+    const vector<ActionRecord>& history = gameState.getActionHistory();
+    ReplayTable replay(gameState);
+    GamePhase street = GamePhase::preflop;
+    for (size_t i = 0; i < history.size(); i++) {
+        const ActionRecord& record = history[i];
+        if (record.phase != street) {
+            street = record.phase;
+            replay.newStreet();
+        }
+        replay.setCurrentSeat(record.seat);
+        bool sized = record.actionType == Action::bet || record.actionType == Action::raise;
+        if (i >= _recorded && record.seat != seat && sized) {
+            double uniform = _translationSeed ? getUniform(_translationSeed, i) : 0.5;
+            int action = bets.translate(replay, PlayerAction(record.actionType, record.amount), uniform);
+            _stats->record(BetAbstraction::getPotFraction(replay, record.amount), action,
+                           BetAbstraction::getPotFraction(replay, replay.getLegalActions().allInTo));
+        }
+        replay.apply(record);
+    }
+    _recorded = history.size();
+}
+
+int CfrBot::pickAction(const float* probabilities, int count) {
+    int pick = -1;
+    if (_sampling) {
+        float total = 0.0f;
+        for (int action = 0; action < count; action++) total += max(probabilities[action], 0.0f);
+        if (total <= 0.0f) return -1;
+        float target = uniform_real_distribution<float>(0.0f, total)(_rng);
+        for (int action = 0; action < count; action++) {
+            if (probabilities[action] <= 0.0f) continue;
+            pick = action;
+            target -= probabilities[action];
+            if (target <= 0.0f) break;
+        }
+    } else {
+        for (int action = 0; action < count; action++) {
+            if (probabilities[action] > 0.0f && (pick < 0 || probabilities[action] > probabilities[pick])) pick = action;
+        }
+    }
+    return pick;
+}
@@ -0,0 +1,64 @@
+#ifndef CFRBOT_H
+#define CFRBOT_H
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+#include "player.h"
+#include "mccfrsolver.h"
+#include "translationstats.h"
+
+class GameManager;
+
+// Plays the average strategy of a trained MccfrSolver at a heads-up GameManager table. The
+// hand's action history is mapped onto the solver's bet abstraction and walked down its
+// betting tree to find the infoset; spots off the tree or never visited fall back to
+// check/call. Picks the most likely abstract action by default, or samples the mixed
+// strategy when sampling is turned on.
+//
+// Real bet sizes are translated with BetAbstraction's pseudo-harmonic mapping, to the likelier
+// neighbouring size or, randomized, to each with its probability; the draw for each action is
+// fixed for the rest of the hand, so later decisions replay the same path.
+class CfrBot : public Player {
+public:
+    CfrBot(const std::string& name, int chips, std::shared_ptr<const MccfrSolver> solver, int position = -1);
+    PlayerAction makeDecision(const Gamestate& gameState, GameManager* gameManager);
+    void reset();
+    void setSampling(bool sampling, unsigned seed = 0);
+    // Randomized translation, and where to count the opponent's real sizes (may be shared).
+    void setTranslation(bool randomized, std::shared_ptr<TranslationStats> stats = nullptr);
+
+    // One recorded action as the solver's tree sees it.
+    struct PathStep {
+        int node;           // where it was taken
+        int seat;           // table seat that took it
+        int action;         // abstract action id
+        GamePhase phase;
+    };
+
+    // Betting tree node for the seat to act, or BettingTree::kNoChild if the hand left the tree.
+    static int findNode(const MccfrSolver& solver, const Gamestate& gameState, int seat);
+    // Walks the hand's history down the solver's tree, one step per action for as long as the
+    // hand stays on it. Returns the node reached, or BettingTree::kNoChild if it left. A
+    // nonzero translationSeed randomizes bet translation, the same way for the same seed.
+    static int tracePath(const MccfrSolver& solver, const Gamestate& gameState, std::vector<PathStep>& path,
+                         uint64_t translationSeed = 0);
+
+protected:
+    // Most likely action, or one sampled when sampling is on; -1 if all are zero.
+    int pickAction(const float* probabilities, int count);
+
+private:
+    std::shared_ptr<const MccfrSolver> _solver;
+    bool _sampling;
+    std::mt19937 _rng;
+    bool _randomizedTranslation;
+    uint64_t _translationSeed;          // drawn per hand
+    std::shared_ptr<TranslationStats> _stats;
+    size_t _recorded;                   // history actions of this hand already counted
+
+    static int checkNode(const MccfrSolver& solver, const Gamestate& gameState, int seat, int node);
+    void recordSizes(const Gamestate& gameState, int seat);
+};
+
+#endif // CFRBOT_H
@@ -6,7 +6,7 @@
 using namespace std;
 
 
-Deck::Deck() {
+Deck::Deck() : _rng(std::random_device()()) {
     _currentCard = 0;
     for (int suit = 0; suit < 4; suit++) {        // 4 suits
         for (int rank = 0; rank < 13; rank++) {
@@ -21,12 +21,16 @@ Deck::~Deck() {
 }
 
 void Deck::shuffle() {
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    std::shuffle(_cards.begin(), _cards.end(), _rng);
 
-    std::shuffle(_cards.begin(), _cards.end(), gen);
+    _currentCard = 0;
+}
 
+void Deck::seed(uint64_t seed) {
+    // the constructor has already shuffled once, so start again from the ordered deck
+    sort(_cards.begin(), _cards.end(), [](const Card& a, const Card& b) { return a.getIndex() < b.getIndex(); });
     _currentCard = 0;
+    _rng.seed(seed);
 }
 
 Card Deck::deal() {
@@ -3,6 +3,8 @@
 #include <string>
 #include "card.h"
 #include <vector>
+#include <random>
+#include <cstdint>
 
 class Deck
 {
@@ -10,6 +12,8 @@ public:
     Deck();
     ~Deck();
     void shuffle();
+    // Fixes the shuffle sequence: equal seeds deal the same cards hand after hand.
+    void seed(uint64_t seed);
     Card deal();
     void reset();
     bool isEmpty() const;
@@ -18,6 +22,7 @@ public:
 private:
     std::vector<Card> _cards;
     int _currentCard;
+    std::mt19937_64 _rng;
 };
 
 #endif // DECK_H
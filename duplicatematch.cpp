@@ -0,0 +1,172 @@
+#include "duplicatematch.h"
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include "gamemanager.h"
+#include "tableengine.h"
+
+using namespace std;
+
+namespace {
+
+// a deal's seeds: the deck's, then one per seat
+const uint64_t kStreamsPerDeal = 64;
+
+}
+
+DuplicateMatch::DuplicateMatch(const RuleSet& rules, int numThreads)
+    : _rules(rules), _pool(numThreads), _seed(0), _deals(0) {
+}
+
+void DuplicateMatch::addEntrant(const string& name, Entrant entrant) {
+    if (_deals > 0) throw runtime_error("Entrants must be added before the first deal");
+    if (_entrants.size() >= SeatState::kMaxSeats) throw runtime_error("Too many entrants for one table");
+    _names.push_back(name);
+    _entrants.push_back(entrant);
+}
+
+void DuplicateMatch::setSeed(uint64_t seed) {
+    _seed = seed;
+}
+
+void DuplicateMatch::playTable(const RuleSet& rules, uint64_t seed, long long deal, int rotation,
+                               const vector<Entrant>& entrants, double* won, double* decisionSeconds) {
+    int numSeats = static_cast<int>(entrants.size());
+    int stack = rules.getStartingChips();
+
+    // the deck and each seat's dice depend on the deal alone, so every rotation plays the same
+    // cards and the same rolls seat by seat; bots that play alike come out exactly even
+    GameManager game(rules);
+    game.setVerbose(false);
+    game.setSeed(EngineRng::getStreamSeed(seed, deal * kStreamsPerDeal));
+    game.setAllInEvaluation();
+    vector<shared_ptr<Player>> seated(numSeats);
+    for (int seat = 0; seat < numSeats; seat++) {
+        int entrant = (seat + rotation) % numSeats;
+        seated[entrant] = entrants[entrant](stack, EngineRng::getStreamSeed(seed, deal * kStreamsPerDeal + seat + 1));
+    }
+    for (int seat = 0; seat < numSeats; seat++) {
+        game.addPlayer(seated[(seat + rotation) % numSeats]);
+    }
+
+    // playHand()'s loop, spelled out so the decisions can be timed
+    game.beginHand();
+    while (game.isAwaitingDecision()) {
+        int seat = game.getDecisionSeat();
+        if (!decisionSeconds) {
+            game.applyDecision(game.getPlayer(seat)->makeDecision(game.getGameState(), &game));
+            continue;
+        }
+        auto start = chrono::steady_clock::now();
+        PlayerAction action = game.getPlayer(seat)->makeDecision(game.getGameState(), &game);
+        decisionSeconds[(seat + rotation) % numSeats] += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        game.applyDecision(action);
+    }
+
+    // all-ins count at their expected value rather than the runout dealt
+    for (int entrant = 0; entrant < numSeats; entrant++) {
+        won[entrant] += seated[entrant]->getChips() + seated[entrant]->getAllInAdjustment() - stack;
+    }
+}
+
+void DuplicateMatch::play(int deals) {
+    int numSeats = static_cast<int>(_entrants.size());
+    if (numSeats < 2) throw runtime_error("A duplicate match needs at least two entrants");
+    if (deals <= 0) return;
+    if (_deals == 0) {
+        // checked once, before any table runs; the entrants are fixed from here on
+        int stack = _rules.getStartingChips();
+        for (int entrant = 0; entrant < numSeats; entrant++) {
+            shared_ptr<Player> player = _entrants[entrant](stack, 0);
+            if (!player || player->getChips() != stack) {
+                throw runtime_error("Entrant " + _names[entrant] + " must sit down with the stack given");
+            }
+        }
+    }
+
+    // one job per table: every deal's mirrored tables are spread across the workers
+    int jobs = deals * numSeats;
+    vector<double> won(static_cast<size_t>(jobs) * numSeats);
+    _pool.parallelFor(jobs, [&](int begin, int end) {
+        for (int job = begin; job < end; job++) {
+            playTable(_rules, _seed, _deals + job / numSeats, job % numSeats, _entrants, &won[static_cast<size_t>(job) * numSeats]);
+        }
+    });
+
+    // a deal's score is the entrant's total over its rotations, per hand played
+    double scale = 100.0 / _rules.getBigBlind() / numSeats;
+    size_t first = _scores.size();
+    _scores.resize(first + static_cast<size_t>(deals) * numSeats, 0.0);
+    for (int job = 0; job < jobs; job++) {
+        int deal = job / numSeats;
+        for (int entrant = 0; entrant < numSeats; entrant++) {
+            _scores[first + static_cast<size_t>(deal) * numSeats + entrant] += won[static_cast<size_t>(job) * numSeats + entrant] * scale;
+        }
+    }
+    _deals += deals;
+}
+
+long long DuplicateMatch::getDeals() const {
+    return _deals;
+}
+
+DuplicateMatch::Standing DuplicateMatch::summarize(const string& name, int first, int second) const {
+    size_t numSeats = _entrants.size();
+    Standing standing;
+    standing.name = name;
+    standing.deals = _deals;
+    standing.mean = 0.0;
+    standing.low = -INFINITY;
+    standing.high = INFINITY;
+    if (_deals == 0) return standing;
+
+    double sum = 0.0;
+    double squares = 0.0;
+    for (long long deal = 0; deal < _deals; deal++) {
+        const double* scores = &_scores[deal * numSeats];
+        double score = second < 0 ? scores[first] : scores[first] - scores[second];
+        sum += score;
+        squares += score * score;
+    }
+    standing.mean = sum / _deals;
+    if (_deals > 1) {
+        double variance = max(0.0, (squares - sum * standing.mean) / (_deals - 1));
+        double halfWidth = 1.96 * sqrt(variance / _deals);
+        standing.low = standing.mean - halfWidth;
+        standing.high = standing.mean + halfWidth;
+    }
+    return standing;
+}
+
+vector<DuplicateMatch::Standing> DuplicateMatch::getStandings() const {
+    vector<Standing> standings;
+    for (int entrant = 0; entrant < static_cast<int>(_entrants.size()); entrant++) {
+        standings.push_back(summarize(_names[entrant], entrant, -1));
+    }
+    return standings;
+}
+
+DuplicateMatch::Standing DuplicateMatch::getDifference(int first, int second) const {
+    int numSeats = static_cast<int>(_entrants.size());
+    if (first < 0 || first >= numSeats || second < 0 || second >= numSeats) {
+        throw runtime_error("Entrant index out of range");
+    }
+    return summarize(_names[first] + " - " + _names[second], first, second);
+}
+
+void DuplicateMatch::print(ostream& out) const {
+    out << _deals << " deals, " << _deals * _entrants.size() << " hands per entrant" << endl;
+    out << fixed << setprecision(1);
+    vector<Standing> rows = getStandings();
+    for (int second = 1; second < static_cast<int>(_entrants.size()); second++) {
+        rows.push_back(getDifference(0, second));
+    }
+    for (const Standing& row : rows) {
+        out << "  " << left << setw(24) << row.name << right << setw(10) << row.mean
+            << " bb/100   [" << row.low << ", " << row.high << "]" << endl;
+    }
+    out.unsetf(ios::fixed);
+    out << setprecision(6);
+}
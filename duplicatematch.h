@@ -0,0 +1,71 @@
+#ifndef DUPLICATEMATCH_H
+#define DUPLICATEMATCH_H
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+#include "player.h"
+#include "ruleset.h"
+#include "workerpool.h"
+
+// Duplicate poker between two or more bots. Each deal is played once per rotation of the
+// seats, every table seeded alike, so every bot holds every seat's cards in turn from fresh,
+// equal stacks. Card luck cancels out of a bot's total over the rotations; what is left is
+// how it played them. All-ins are settled on expected value (GameManager::setAllInEvaluation),
+// which takes out the runout luck as well. The mirrored tables of a batch run across the
+// worker pool.
+//
+// Scores are in big blinds per 100 hands, one sample per deal. getDifference() pairs two
+// bots deal by deal, which is the comparison to read: its interval is much narrower than
+// either bot's own.
+class DuplicateMatch
+{
+public:
+    // A bot for one table, with the stack to sit down with and its dice seeded.
+    using Entrant = std::function<std::shared_ptr<Player>(int chips, uint64_t seed)>;
+
+    struct Standing {
+        std::string name;
+        long long deals;
+        double mean;          // bb/100
+        double low;           // 95% interval of the mean
+        double high;
+    };
+
+    explicit DuplicateMatch(const RuleSet& rules, int numThreads = 0);   // 0 = one per hardware thread
+
+    // Seats in the order added; the rotations move everyone along from there.
+    void addEntrant(const std::string& name, Entrant entrant);
+    void setSeed(uint64_t seed);
+
+    // Plays this many more deals, after any already played. The tables play quietly.
+    void play(int deals);
+
+    // One table of a duplicate deal, shared with LeagueRunner: seat s holds entrants[(s +
+    // rotation) % n], the deck and each seat's dice are seeded from seed and deal alone, and
+    // each entrant's chips won (all-ins on expected value) are added to won. With
+    // decisionSeconds, the time inside each entrant's makeDecision is added there as well.
+    static void playTable(const RuleSet& rules, uint64_t seed, long long deal, int rotation,
+                          const std::vector<Entrant>& entrants, double* won, double* decisionSeconds = nullptr);
+
+    long long getDeals() const;
+    std::vector<Standing> getStandings() const;
+    // first minus second, paired over the deals
+    Standing getDifference(int first, int second) const;
+    void print(std::ostream& out) const;
+
+private:
+    RuleSet _rules;
+    WorkerPool _pool;
+    std::vector<std::string> _names;
+    std::vector<Entrant> _entrants;
+    uint64_t _seed;
+    long long _deals;
+    std::vector<double> _scores;   // bb/100 per deal and entrant, deal-major
+
+    Standing summarize(const std::string& name, int first, int second) const;
+};
+
+#endif // DUPLICATEMATCH_H
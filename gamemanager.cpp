@@ -1,4 +1,6 @@
 #include "gamemanager.h"
+#include <algorithm>
+#include <stdexcept>
 
 // member Vars
 // RuleSet _rules;
@@ -16,19 +18,26 @@
 
 GameManager::GameManager()
     : _rules(),  // Uses RuleSet default constructor
+    _current(),
     _smallBlindAmt(_rules.getSmallBlind()),
     _bigBlindAmt(_rules.getBigBlind()),
     _maxRaises(_rules.getMaxRaises()),
     _startingChips(_rules.getStartingChips()),
     _handNumber(0),
     _gameActive(false),
-    _anyPlayerActedThisRound(false),
     _handInProgress(false),
-    _current() {
+    _actedThisRound(0),
+    _allInRunouts(0),
+    _allInEvaluated(false),
+    _verbose(true) {
+    _current.setSeats(&_seats);
+    _current.setBlinds(_smallBlindAmt, _bigBlindAmt);
+    _current.setLegalActionsRule(getLegalActionsRule(_rules.getBettingType()), _maxRaises);
 }
 
 GameManager::GameManager(const RuleSet& rules)
     : _rules(rules),
+    _current(),
     _smallBlindAmt(_rules.getSmallBlind()),
     _bigBlindAmt(_rules.getBigBlind()),
     _maxRaises(_rules.getMaxRaises()),
@@ -36,12 +45,18 @@ GameManager::GameManager(const RuleSet& rules)
     _handNumber(0),
     _gameActive(false),
     _handInProgress(false),
-    _anyPlayerActedThisRound(false),
-    _current() {
+    _actedThisRound(0),
+    _allInRunouts(0),
+    _allInEvaluated(false),
+    _verbose(true) {
+    _current.setSeats(&_seats);
+    _current.setBlinds(_smallBlindAmt, _bigBlindAmt);
+    _current.setLegalActionsRule(getLegalActionsRule(_rules.getBettingType()), _maxRaises);
 }
 
 GameManager::GameManager(int smallBlind, int bigBlind, int startingChips)
     : _rules(smallBlind, bigBlind, startingChips),  // Create RuleSet with these values
+    _current(),
     _smallBlindAmt(_rules.getSmallBlind()),
     _bigBlindAmt(_rules.getBigBlind()),
     _maxRaises(_rules.getMaxRaises()),
@@ -49,34 +64,90 @@ GameManager::GameManager(int smallBlind, int bigBlind, int startingChips)
     _handNumber(0),
     _gameActive(false),
     _handInProgress(false),
-    _anyPlayerActedThisRound(false),
-    _current() {
+    _actedThisRound(0),
+    _allInRunouts(0),
+    _allInEvaluated(false),
+    _verbose(true) {
+    _current.setSeats(&_seats);
+    _current.setBlinds(_smallBlindAmt, _bigBlindAmt);
+    _current.setLegalActionsRule(getLegalActionsRule(_rules.getBettingType()), _maxRaises);
 }
 
 GameManager::~GameManager(){
-
+    // players outlive the table; they keep their stacks but not a pointer into it
+    for (auto& player : _players) {
+        player->bindSeat(nullptr, -1);
+    }
 }
 
 std::vector<std::shared_ptr<Player>> GameManager::getPlayers() {
     return _players;
 }
 
+const std::shared_ptr<Player>& GameManager::getPlayer(int playerIndex) const {
+    return _players[playerIndex];
+}
+
 void GameManager::addPlayer(std::shared_ptr<Player> player){
+    int seat = _seats.addSeat(player->getChips());
+    player->bindSeat(&_seats, seat);
     _players.push_back(player);
 }
 
+void GameManager::rebindSeats() {
+    for (int i = 0; i < _players.size(); i++) {
+        _players[i]->bindSeat(&_seats, i);
+    }
+}
+
+void GameManager::setOpponentStats(std::shared_ptr<OpponentStats> stats) {
+    _opponentStats = stats;
+    _current.setOpponentStats(stats.get());
+}
+
+void GameManager::setPlaystyleClassifier(std::shared_ptr<const PlaystyleClassifier> classifier) {
+    _playstyleClassifier = classifier;
+    _current.setPlaystyleClassifier(classifier.get());
+}
+
+void GameManager::setRangeTracker(std::shared_ptr<RangeTracker> tracker) {
+    _rangeTracker = tracker;
+    _current.setRangeTracker(tracker.get());
+}
+
+void GameManager::setSeed(uint64_t seed) {
+    _deck.seed(seed);
+    rng.seed(static_cast<std::mt19937::result_type>(seed));
+}
+
+void GameManager::setAllInEvaluation(int runouts) {
+    if (runouts < 0) throw std::runtime_error("All-in evaluation needs a runout count of zero or more");
+    _allInRunouts = runouts;
+}
+
+void GameManager::setVerbose(bool verbose) {
+    _verbose = verbose;
+}
+
+std::ostream& GameManager::getLog() const {
+    // a stream without a buffer drops everything; one per thread, as tables run in parallel
+    static thread_local std::ostream quiet(nullptr);
+    return _verbose ? std::cout : quiet;
+}
+
 void GameManager::startNewHand(){
-    std::cout << "\n=== STARTING HAND " << _handNumber + 1 << " ===\n";
+    getLog() << "\n=== STARTING HAND " << _handNumber + 1 << " ===\n";
 
     // Show player chip counts
     for (int i = 0; i < _players.size(); i++) {
-        std::cout << _players[i]->getName() << ": $" << _players[i]->getChips() << " chips\n";
+        getLog() << _players[i]->getName() << ": $" << _seats.stacks[i] << " chips\n";
     }
 
 
 
     _deck.shuffle();
     _current.reset();
+    _seats.resetForHand();
 
     for (auto& player : _players) {
         player->reset();
@@ -87,31 +158,43 @@ void GameManager::startNewHand(){
     setCurrentPlayerToFirstActive();
     _handInProgress = true;
     _handNumber++;
+    _allInEvaluated = false;
+
+    if (_opponentStats) {
+        std::vector<std::string> names;
+        for (auto& player : _players) {
+            names.push_back(player->getName());
+        }
+        _opponentStats->startHand(_current, names);
+    }
+    if (_rangeTracker) {
+        _rangeTracker->startHand(_current);
+    }
 
-    std::cout << "Dealer: Position " << _current.getDealerPosition()
+    getLog() << "Dealer: Position " << _current.getDealerPosition()
               << ", SB: Position " << _current.getSmallBlindPosition()
               << ", BB: Position " << _current.getBigBlindPosition() << "\n";
 }
 
 void GameManager::dealHoleCards(){
     for (int numCards = 0; numCards < 2; numCards++) {
-        for (auto& player : _players) {
-            if (isPlayerActive(player->getPosition())) {
-                player->dealtCard(_deck.deal());
+        unsigned dealtIn = _seats.canActMask();
+        for (int seat = 0; seat < _seats.size(); seat++) {
+            if (dealtIn & (1u << seat)) {
+                _seats.dealCard(seat, _deck.deal());
             }
         }
     }
 }
 
 void GameManager::startNewBettingRound(){
-    for (auto& player : _players) {
-        player->clearRoundBet();
-    }
+    _seats.clearRoundBets();
     return;
 }
 
 void GameManager::runBettingRound() {
-    _anyPlayerActedThisRound = false;
+    _actedThisRound = 0;
+    _current.setRaisesThisRound(0);
 
 
     while (!isBettingRoundComplete()) {
@@ -121,7 +204,7 @@ void GameManager::runBettingRound() {
         PlayerAction action = player->makeDecision(_current, this);
         handlePlayerAction(action, currentPlayerIndex);
 
-        _anyPlayerActedThisRound = true;
+        _actedThisRound |= 1u << currentPlayerIndex;
 
         if (isHandComplete()) break;  // This might be triggering
 
@@ -129,9 +212,9 @@ void GameManager::runBettingRound() {
         _current.setCurrentPlayerIndex(getNextActivePlayer(currentPlayerIndex));
     }
 
-    std::cout << "Betting round loop completed, calling collectBets()\n";
+    getLog() << "Betting round loop completed, calling collectBets()\n";
     collectBets();
-    std::cout << "collectBets() completed\n";
+    getLog() << "collectBets() completed\n";
 }
 
 std::string GameManager::actionToString(const PlayerAction& action) {
@@ -147,120 +230,298 @@ std::string GameManager::actionToString(const PlayerAction& action) {
 }
 
 void GameManager::handlePlayerAction(const PlayerAction& playerAct, int playerIndex){
-    auto player = _players[playerIndex];
-
-    // 1. Validate the action is legal
-    if (!validateAction(playerAct, playerIndex)) {
-        // For now, just return - in real game might ask again
+    // 1. Validate the action is legal; illegal answers fall back to check, or fold when facing
+    // a bet, the same as TableEngine::playHand
+    LegalActions legal = _current.getLegalActions(playerIndex);
+    if (legal.mask == 0) {
         return;
     }
+    PlayerAction action = playerAct;
+    if (!validateAction(action, playerIndex)) {
+        action = PlayerAction(legal.has(Action::check) ? Action::check : Action::fold);
+    }
+    if (action.actionType == Action::call) {
+        action.amount = legal.callAmount;
+    } else if (action.actionType == Action::all_in) {
+        action.amount = legal.allInTo;
+    }
+    if (_opponentStats) {
+        _opponentStats->recordAction(_current, playerIndex, action);
+    }
+    if (_rangeTracker) {
+        _rangeTracker->recordAction(_current, playerIndex, action);
+    }
 
     // 2. Apply the action effects
-    switch(playerAct.actionType) {
+    int currentBet = _current.getCurrentBet();
+    switch(action.actionType) {
     case Action::fold:
-        player->fold();
+        _seats.fold(playerIndex);
         break;
 
     case Action::check:
-        player->check();
+        _seats.check(playerIndex);
         break;
 
-    case Action::call: {
-        int currentBet = _current.getCurrentBet();
-        int callAmount = currentBet - player->getRoundBet();
-        player->addToBet(callAmount);
+    case Action::call:
+        _seats.addToBet(playerIndex, legal.callAmount);
         break;
-    }
 
     case Action::bet:
-    case Action::raise: {
-
-        int betAmount = playerAct.amount;
-        int addAmount = betAmount - player->getRoundBet();
-        player->addToBet(addAmount);
-        _current.setCurrentBet(betAmount);
+    case Action::raise:
+        _seats.addToBet(playerIndex, action.amount - _seats.roundBets[playerIndex]);
         break;
-    }
 
     case Action::all_in:
-        player->goAllIn();
-        int totalBet = player->getRoundBet() + player->getChips();
-        _current.setCurrentBet(std::max(_current.getCurrentBet(), totalBet));
+        _seats.goAllIn(playerIndex);
         break;
     }
+    if (_seats.roundBets[playerIndex] > currentBet) {
+        _current.setCurrentBet(_seats.roundBets[playerIndex]);
+        _current.setRaisesThisRound(_current.getRaisesThisRound() + 1);
+    }
 
-    // 3. Record action for history/ML (optional for now)
-    // _current.addActionToHistory(action, playerIndex);
+    // 3. Record action for history/ML
+    _current.addActionToHistory(action, playerIndex);
 
     // 4. Check for special conditions
-    if (player->getChips() == 0 && playerAct.actionType != Action::all_in) {
-        player->goAllIn();  // Went all-in accidentally
+    if (_seats.stacks[playerIndex] == 0 && action.actionType != Action::all_in) {
+        _seats.goAllIn(playerIndex);  // Went all-in accidentally
     }
 }
 
 std::shared_ptr<Player> GameManager::determineWinner(const std::vector<int>& elligiblePlayerIndices) {
-    std::vector<std::pair<std::shared_ptr<Player>, Hand>> playerHands;
+    uint8_t board[5];
+    int boardSize = getBoard(board);
+    std::vector<int> winners = getPotWinners(elligiblePlayerIndices, board, boardSize);
+    if (winners.empty()) return nullptr;
+    return _players[winners[0]];
+}
 
-    // Collect hands from eligible players
-    for (int playerIndex : elligiblePlayerIndices) {
-        auto player = _players[playerIndex];
-        if (!player->isFolded()) {
-            playerHands.push_back({player, player->getHand()});
-        }
+void GameManager::playHand() {
+    beginHand();
+    while (isAwaitingDecision()) {
+        int seat = getDecisionSeat();
+        applyDecision(_players[seat]->makeDecision(_current, this));
     }
-
-    if (playerHands.empty()) return nullptr;
-
-    auto winner = std::max_element(playerHands.begin(), playerHands.end(),[](const auto& a, const auto& b) {
-        return b.second > a.second;
-    });
-
-    return winner->first;
 }
 
-void GameManager::playHand() {
+void GameManager::beginHand() {
     startNewHand();
     dealHoleCards();
     collectBlinds();
+    openBettingRound();
+}
+
+bool GameManager::isAwaitingDecision() const {
+    return _handInProgress;
+}
+
+int GameManager::getDecisionSeat() const {
+    return _handInProgress ? _current.getCurrentPlayerIndex() : -1;
+}
+
+void GameManager::applyDecision(const PlayerAction& action) {
+    int currentPlayerIndex = _current.getCurrentPlayerIndex();
+    handlePlayerAction(action, currentPlayerIndex);
+    _actedThisRound |= 1u << currentPlayerIndex;
 
-    // Preflop betting
-    runBettingRound();
     if (isHandComplete()) {
+        finishBettingRound();
+        return;
+    }
+
+    int nextPlayerIndex = getNextActivePlayer(currentPlayerIndex);
+    _current.setCurrentPlayerIndex(nextPlayerIndex);
+    if (nextPlayerIndex < 0 || isBettingRoundComplete()) {
+        finishBettingRound();
+    }
+}
+
+void GameManager::loadPosition(const SeatState& seats, const Gamestate& state) {
+    if (seats.size() != static_cast<int>(_players.size())) {
+        throw std::runtime_error("Position needs one seat per player");
+    }
+    _seats = seats;
+    _current = state;
+    _current.setSeats(&_seats);
+    _current.setLegalActionsRule(getLegalActionsRule(_rules.getBettingType()), _maxRaises);
+    _current.setOpponentStats(_opponentStats.get());
+    _current.setPlaystyleClassifier(_playstyleClassifier.get());
+    _current.setRangeTracker(_rangeTracker.get());
+    rebindSeats();
+    _handInProgress = true;
+    _actedThisRound = 0;
+}
+
+void GameManager::openBettingRound() {
+    _actedThisRound = 0;
+    _current.setRaisesThisRound(0);
+    if (_current.getCurrentPlayerIndex() < 0) {
+        _current.setCurrentPlayerIndex(getNextActivePlayer(_current.getDealerPosition()));
+    }
+    // nobody left to ask (e.g. the blinds put everyone all in), or the one player left has
+    // nothing to call: close the round at once
+    if (_current.getCurrentPlayerIndex() < 0 || isBettingRoundComplete()) {
+        finishBettingRound();
+    }
+}
+
+void GameManager::finishBettingRound() {
+    getLog() << "Betting round loop completed, calling collectBets()\n";
+    collectBets();
+    getLog() << "collectBets() completed\n";
+    bool allIn = SeatState::count(_seats.inHandMask()) >= 2 && !canMoreBettingOccur();
+    if (_current.getCurrentPhase() == GamePhase::river || (isHandComplete() && !allIn)) {
         endHand();
         return;
     }
 
-    // Flop
-    advancePhase();
-    dealFlop();
-    if (canMoreBettingOccur()) {
-        runBettingRound();
-        if (isHandComplete()) {
+    // fewer than two players can act: the rest of the board is dealt straight out, valued
+    // first when the table settles all-ins on expectation
+    if (allIn && _allInRunouts > 0) {
+        evaluateAllIn();
+    }
+    for (;;) {
+        advancePhase();
+        switch (_current.getCurrentPhase()) {
+        case GamePhase::flop: dealFlop(); break;
+        case GamePhase::turn: dealTurn(); break;
+        default: dealRiver(); break;
+        }
+        if (!allIn) {
+            // after the flop the first player still in left of the button opens
+            _current.setCurrentPlayerIndex(getNextActivePlayer(_current.getDealerPosition()));
+            openBettingRound();
+            return;
+        }
+        if (_current.getCurrentPhase() == GamePhase::river) {
             endHand();
             return;
         }
     }
+}
 
-    // Turn
-    advancePhase();
-    dealTurn();
-    if (canMoreBettingOccur()) {
-        runBettingRound();
-        if (isHandComplete()) {
-            endHand();
-            return;
+int GameManager::getBoard(uint8_t* board) const {
+    const std::vector<Card>& cards = _current.getCommunityCards();
+    for (int i = 0; i < static_cast<int>(cards.size()); i++) {
+        board[i] = static_cast<uint8_t>(cards[i].getIndex());
+    }
+    return static_cast<int>(cards.size());
+}
+
+std::vector<int> GameManager::getPotWinners(const std::vector<int>& eligiblePlayerIndices, const uint8_t* board,
+                                            int boardSize) const {
+    std::vector<int> winners;
+    int best = -1;
+    for (int playerIndex : eligiblePlayerIndices) {
+        if (_seats.isFolded(playerIndex)) continue;
+        const std::vector<Card>& hole = _seats.holeCards[playerIndex].getCards();
+        uint8_t cards[7];
+        int count = 0;
+        for (const Card& card : hole) cards[count++] = static_cast<uint8_t>(card.getIndex());
+        for (int i = 0; i < boardSize; i++) cards[count++] = board[i];
+        int value = HandStrengthEvaluator::rankCards(cards, count);
+        if (value > best) {
+            best = value;
+            winners.clear();
+        }
+        if (value == best) winners.push_back(playerIndex);
+    }
+    std::sort(winners.begin(), winners.end());
+    return winners;
+}
+
+void GameManager::evaluateAllIn() {
+    int numSeats = _seats.size();
+    _allInExpected.assign(numSeats, 0.0);
+
+    uint8_t board[5];
+    int boardSize = getBoard(board);
+    int missing = 5 - boardSize;
+    // every card not on the board or in someone's hand, folded hands included, can come
+    uint64_t seen = 0;
+    for (int i = 0; i < boardSize; i++) seen |= 1ull << board[i];
+    std::vector<int> live;
+    std::vector<uint8_t> holes;
+    for (int seat = 0; seat < numSeats; seat++) {
+        const std::vector<Card>& hole = _seats.holeCards[seat].getCards();
+        for (const Card& card : hole) seen |= 1ull << card.getIndex();
+        if (!_seats.isFolded(seat) && hole.size() == 2) {
+            live.push_back(seat);
+            holes.push_back(static_cast<uint8_t>(hole[0].getIndex()));
+            holes.push_back(static_cast<uint8_t>(hole[1].getIndex()));
         }
     }
+    std::vector<uint8_t> unseen;
+    for (int card = 0; card < 52; card++) {
+        if (!(seen & (1ull << card))) unseen.push_back(static_cast<uint8_t>(card));
+    }
+    int numUnseen = static_cast<int>(unseen.size());
 
-    // River
-    advancePhase();
-    dealRiver();
-    if (canMoreBettingOccur()) {
-        runBettingRound();
+    // each pot by who can win it, as positions in live
+    const std::vector<Pot>& pots = _current.getPots();
+    std::vector<std::vector<int>> contenders(pots.size());
+    for (size_t pot = 0; pot < pots.size(); pot++) {
+        for (int playerIndex : pots[pot].eligiblePlayerIndices) {
+            for (size_t i = 0; i < live.size(); i++) {
+                if (live[i] == playerIndex) contenders[pot].push_back(static_cast<int>(i));
+            }
+        }
     }
 
-    // End hand (showdown or winner determination)
-    endHand();
+    double runouts = 1.0;
+    for (int i = 0; i < missing; i++) runouts = runouts * (numUnseen - i) / (i + 1);
+    bool enumerate = runouts <= _allInRunouts;
+
+    std::vector<int> values(live.size());
+    int pick[5];
+    for (int i = 0; i < missing; i++) pick[i] = i;
+    long long played = 0;
+    for (;;) {
+        if (enumerate) {
+            for (int i = 0; i < missing; i++) board[boardSize + i] = unseen[pick[i]];
+        } else {
+            // a partial shuffle of the unseen cards draws the rest of the board
+            for (int i = 0; i < missing; i++) {
+                int j = i + static_cast<int>(rng() % (numUnseen - i));
+                std::swap(unseen[i], unseen[j]);
+                board[boardSize + i] = unseen[i];
+            }
+        }
+        for (size_t i = 0; i < live.size(); i++) {
+            uint8_t cards[7] = {holes[2 * i], holes[2 * i + 1], board[0], board[1], board[2], board[3], board[4]};
+            values[i] = HandStrengthEvaluator::rankCards(cards, 7);
+        }
+        for (size_t pot = 0; pot < pots.size(); pot++) {
+            int best = -1;
+            int ties = 0;
+            for (int i : contenders[pot]) {
+                if (values[i] > best) {
+                    best = values[i];
+                    ties = 0;
+                }
+                if (values[i] == best) ties++;
+            }
+            for (int i : contenders[pot]) {
+                if (values[i] == best) _allInExpected[live[i]] += static_cast<double>(pots[pot].amount) / ties;
+            }
+        }
+        played++;
+
+        if (!enumerate) {
+            if (played >= _allInRunouts) break;
+            continue;
+        }
+        // next combination of missing positions out of the unseen cards
+        int i = missing - 1;
+        while (i >= 0 && pick[i] == numUnseen - missing + i) i--;
+        if (i < 0) break;
+        pick[i]++;
+        for (int j = i + 1; j < missing; j++) pick[j] = pick[j - 1] + 1;
+    }
+    for (double& expected : _allInExpected) expected /= played;
+    _allInEvaluated = true;
 }
 
 void GameManager::playGame(int numHands){
@@ -294,7 +555,7 @@ void GameManager::advancePhase() {
         _current.incrementBettingRound();
         break;
     }
-    _anyPlayerActedThisRound = false;
+    _actedThisRound = 0;
     return;
 }
 
@@ -303,7 +564,10 @@ const Gamestate& GameManager::getGameState() const{
 }
 
 void GameManager::removePlayer(int playerIndex){
+    _players[playerIndex]->bindSeat(nullptr, -1);
     _players.erase(_players.begin() + playerIndex);
+    _seats.removeSeat(playerIndex);
+    rebindSeats();
     return;
 }
 
@@ -344,7 +608,8 @@ void GameManager::setCurrentPlayerToFirstActive() {
 
 void GameManager::updateBlindPositions() {
     int dealerPos = _current.getDealerPosition();
-    int sbPos = getNextActivePlayer(dealerPos);
+    // heads-up the button posts the small blind, so it acts first before the flop and last after
+    int sbPos = SeatState::count(_seats.canActMask()) == 2 ? dealerPos : getNextActivePlayer(dealerPos);
     int bbPos = getNextActivePlayer(sbPos);
 
     _current.setSmallBlindPosition(sbPos);
@@ -352,7 +617,7 @@ void GameManager::updateBlindPositions() {
 }
 
 bool GameManager::isPlayerActive(int playerIndex){
-    return _players[playerIndex]->canAct();
+    return _seats.canAct(playerIndex);
 }
 
 void GameManager::dealFlop(){
@@ -381,20 +646,18 @@ void GameManager::collectBlinds(){
     int bB = _current.getBigBlindPosition();
 
     //take from small blind and handle all in case
-    auto sBPlayer = _players[sB];
-    int sBAmount = std::min(_smallBlindAmt, sBPlayer->getChips());
-    sBPlayer->setBet(sBAmount);
+    int sBAmount = std::min(_smallBlindAmt, _seats.stacks[sB]);
+    _seats.postBet(sB, sBAmount);
 
-    if (sBAmount < _smallBlindAmt) {
-        sBPlayer->goAllIn();
+    if (_seats.stacks[sB] == 0) {
+        _seats.goAllIn(sB);
     }
     //take from big blind if possible
-    auto bBPlayer = _players[bB];
-    int bBAmount = std::min(_bigBlindAmt, bBPlayer->getChips());
-    bBPlayer->setBet(bBAmount);
+    int bBAmount = std::min(_bigBlindAmt, _seats.stacks[bB]);
+    _seats.postBet(bB, bBAmount);
 
-    if (bBAmount < _bigBlindAmt) {
-        bBPlayer->goAllIn();
+    if (_seats.stacks[bB] == 0) {
+        _seats.goAllIn(bB);
     }
 
     _current.setCurrentBet(std::max(sBAmount, bBAmount));
@@ -402,68 +665,45 @@ void GameManager::collectBlinds(){
 }
 
 bool GameManager::validateAction(const PlayerAction& action, int playerIndex) {
-    auto player = _players[playerIndex];
-    int currentBet = _current.getCurrentBet();
-
-    // Basic checks
-    if (player->isFolded() || !player->canAct()) {
+    LegalActions legal = _current.getLegalActions(playerIndex);
+    if (!legal.has(action.actionType)) {
         return false;
     }
-
-    switch(action.actionType) {
-    case Action::fold:
-    case Action::check:
-    case Action::all_in:
-        return true;  // Amount doesn't matter for these
-
-    case Action::call: {
-        int callAmount = currentBet - player->getRoundBet();
-        return callAmount > 0 && player->hasEnoughChips(callAmount);
-    }
-
-    case Action::bet: {
-        return currentBet == 0 &&
-               action.amount >= _bigBlindAmt &&  // Check actual bet amount
-               player->hasEnoughChips(action.amount);
+    if (action.actionType == Action::bet || action.actionType == Action::raise) {
+        return action.amount >= legal.minRaiseTo && action.amount <= legal.maxRaiseTo;
     }
-
-    case Action::raise: {
-        int minRaise = getMinimumRaise();
-        return currentBet > 0 &&
-               action.amount >= minRaise &&     // Check actual raise amount
-               player->hasEnoughChips(action.amount - player->getRoundBet());
-    }
-    }
-
-    return false;
+    return true;  // the amount doesn't matter for the rest
 }
 
 void GameManager::collectBets() {
-    std::cout << "collectBets(): Starting\n";
+    getLog() << "collectBets(): Starting\n";
 
-    for (auto& player : getActivePlayers()) {
-        std::cout << "Clearing round bet for " << player->getName() << "\n";
-        player->clearRoundBet();
+    unsigned inHand = _seats.inHandMask();
+    for (int seat = 0; seat < _seats.size(); seat++) {
+        if (inHand & (1u << seat)) {
+            getLog() << "Clearing round bet for " << _players[seat]->getName() << "\n";
+            _seats.roundBets[seat] = 0;
+        }
     }
 
-    std::cout << "collectBets(): Calling calculatePots()\n";
+    getLog() << "collectBets(): Calling calculatePots()\n";
     calculatePots();
-    std::cout << "collectBets(): calculatePots() completed\n";
+    getLog() << "collectBets(): calculatePots() completed\n";
 
     _current.setCurrentBet(0);
-    std::cout << "collectBets(): Completed\n";
+    getLog() << "collectBets(): Completed\n";
 }
 
 void GameManager::calculatePots() {
-    std::cout << "calculatePots(): Starting\n";
+    getLog() << "calculatePots(): Starting\n";
     _current.clearPots();
 
     std::vector<std::pair<int, int>> playerContributions;
-    for (int i = 0; i < _players.size(); i++) {
-        int totalBet = _players[i]->getTotalBet();
+    for (int i = 0; i < _seats.size(); i++) {
+        int totalBet = _seats.totalBets[i];
         if (totalBet > 0) {
             playerContributions.push_back({i, totalBet});
-            std::cout << "Player " << i << " (" << _players[i]->getName()
+            getLog() << "Player " << i << " (" << _players[i]->getName()
                       << ") contributed: $" << totalBet << "\n";
         }
     }
@@ -480,11 +720,11 @@ void GameManager::calculatePots() {
         int potContribution = currentLevel - previousLevel;
 
         if (potContribution > 0) {
-            // FIXED: Count how many players are still in at this level
-            int playersAtThisLevel = playerContributions.size();  // All players contribute to this level
+            // sorted ascending, so everyone from i on put in at least this level
+            int playersAtThisLevel = playerContributions.size() - i;
             int potAmount = potContribution * playersAtThisLevel;
 
-            std::cout << "Creating pot: contribution=" << potContribution
+            getLog() << "Creating pot: contribution=" << potContribution
                       << " x " << playersAtThisLevel << " players = $" << potAmount << "\n";
 
             Pot newPot(potAmount);
@@ -492,140 +732,135 @@ void GameManager::calculatePots() {
             // Add eligible players (those who contributed at least this much and aren't folded)
             for (int j = i; j < playerContributions.size(); j++) {
                 int playerIndex = playerContributions[j].first;
-                if (!_players[playerIndex]->isFolded()) {
+                if (!_seats.isFolded(playerIndex)) {
                     newPot.eligiblePlayerIndices.push_back(playerIndex);
-                    std::cout << "  Eligible: " << _players[playerIndex]->getName() << "\n";
+                    getLog() << "  Eligible: " << _players[playerIndex]->getName() << "\n";
                 }
             }
 
-            if (!newPot.eligiblePlayerIndices.empty()) {
-                _current.addPot(newPot);
+            if (newPot.eligiblePlayerIndices.empty()) {
+                // only folded money at this level: it goes to whoever is left with the most in
+                unsigned inHand = _seats.inHandMask();
+                int most = -1;
+                for (int seat = 0; seat < _seats.size(); seat++) {
+                    if ((inHand & (1u << seat)) && (most < 0 || _seats.totalBets[seat] > _seats.totalBets[most])) {
+                        most = seat;
+                    }
+                }
+                newPot.eligiblePlayerIndices.push_back(most);
             }
+            _current.addPot(newPot);
         }
 
         previousLevel = currentLevel;
     }
 
-    std::cout << "calculatePots(): Completed\n";
+    getLog() << "calculatePots(): Completed\n";
 }
 
 bool GameManager::canMoreBettingOccur() {
-    int playersWhoCanAct = 0;
-    for (auto& player : _players) {
-        if (player->canAct()) {  // Not folded, not all-in
-            playersWhoCanAct++;
-        }
-    }
-    return playersWhoCanAct >= 2;  // Need at least 2 players who can act
+    // Not folded, not all-in; need at least 2 players who can act
+    return SeatState::count(_seats.canActMask()) >= 2;
 }
 
 int GameManager::getMinimumBet() {
-    return _rules.getMinimumRaise(_current.getCurrentBet());
+    return _current.getLegalActions(_current.getCurrentPlayerIndex()).minRaiseTo;
 }
 
 int GameManager::getMinimumRaise() {
-    return _rules.getMinimumRaise(_current.getCurrentBet());
+    return _current.getLegalActions(_current.getCurrentPlayerIndex()).minRaiseTo;
 }
 
 int GameManager::getMaximumBet(int playerIndex) {
-    auto player = _players[playerIndex];
-    return _rules.getMaximumBet(_current.getCurrentBet(), player->getChips(), _current.getTotalPotValue());
+    return _current.getLegalActions(playerIndex).maxRaiseTo;
 }
 
 bool GameManager::isBettingRoundComplete() {
-    if (!_anyPlayerActedThisRound) {
-        std::cout << "  No one has acted yet, continuing round\n";
-        return false;
-    }
-
     int currentBet = _current.getCurrentBet();
-    int activePlayers = 0;
-    int playersWhoActed = 0;
 
-    std::cout << "  Checking if betting round complete:\n";
+    // Everyone who can still act has had a turn this round and matched the current bet
+    // (folded/all-in seats are out of canAct); a lone player left to act only has to match
+    unsigned canAct = _seats.canActMask();
+    unsigned matched = canAct & _seats.matchedMask(currentBet);
+    unsigned settled = matched & _actedThisRound;
+    int activePlayers = SeatState::count(canAct);
+    int playersWhoActed = SeatState::count(settled);
 
-    for (auto& player : _players) {
-        if (player->canAct()) {
-            activePlayers++;
-            std::cout << "    " << player->getName() << ": canAct=true, roundBet=" << player->getRoundBet()
-                      << ", currentBet=" << currentBet << ", folded=" << player->isFolded()
-                      << ", allIn=" << player->isAllIn() << "\n";
-
-            if (player->getRoundBet() == currentBet || player->isFolded() || player->isAllIn()) {
-                playersWhoActed++;
-                std::cout << "      -> Counted as acted\n";
-            } else {
-                std::cout << "      -> NOT counted as acted\n";
-            }
-        } else {
-            std::cout << "    " << player->getName() << ": canAct=false\n";
-        }
-    }
-
-    // FIX: Change the condition
-    bool complete = (playersWhoActed == activePlayers) && (activePlayers >= 0);  // Remove > 1 requirement
-    std::cout << "  Result: " << playersWhoActed << "/" << activePlayers << " acted, complete=" << complete << "\n";
+    bool complete = activePlayers < 2 ? matched == canAct : settled == canAct;
+    getLog() << "  Result: " << playersWhoActed << "/" << activePlayers << " acted, complete=" << complete << "\n";
 
     return complete;
 }
 
 bool GameManager::isHandComplete() {
-    auto activePlayers = getActivePlayers();
-    int numActive = activePlayers.size();
+    unsigned inHand = _seats.inHandMask();
+    int numActive = SeatState::count(inHand);
 
-    std::cout << "  Checking if hand complete: " << numActive << " active players\n";
+    getLog() << "  Checking if hand complete: " << numActive << " active players\n";
 
     if (numActive <= 1) {
-        std::cout << "    -> Hand complete: Only " << numActive << " active players\n";
+        getLog() << "    -> Hand complete: Only " << numActive << " active players\n";
         return true;
     }
 
     if (_current.getCurrentPhase() == GamePhase::river && isBettingRoundComplete()) {
-        std::cout << "    -> Hand complete: River phase and betting complete\n";
+        getLog() << "    -> Hand complete: River phase and betting complete\n";
         return true;
     }
 
     // Check if everyone is all-in
-    for (auto& player: activePlayers) {
-        if (!player->isAllIn()) {
-            std::cout << "    -> Hand continues: " << player->getName() << " is not all-in\n";
-            return false;
-        }
+    unsigned notAllIn = inHand & ~_seats.allIn;
+    if (notAllIn != 0) {
+        getLog() << "    -> Hand continues: " << _players[SeatState::firstSeat(notAllIn)]->getName() << " is not all-in\n";
+        return false;
     }
 
-    std::cout << "    -> Hand complete: Everyone is all-in\n";
+    getLog() << "    -> Hand complete: Everyone is all-in\n";
     return true;
 }
 
 bool GameManager::isGameOver() {
     // Game ends when only 1 player has chips
-    int playersWithChips = 0;
-    for (auto& player : _players) {
-        if (player->getChips() > 0) {
-            playersWithChips++;
-        }
-    }
-    return playersWithChips <= 1;
+    return SeatState::count(_seats.withChipsMask()) <= 1;
 }
 
 void GameManager::endHand(){
-    std::cout << "\n--- HAND COMPLETE ---\n";
+    getLog() << "\n--- HAND COMPLETE ---\n";
 
     auto pots = _current.getPots();
-    std::cout << "Number of pots: " << pots.size() << "\n";
+    getLog() << "Number of pots: " << pots.size() << "\n";
     for (int i = 0; i < pots.size(); i++) {
-        std::cout << "Pot " << i+1 << ": $" << pots[i].amount << " (";
+        getLog() << "Pot " << i+1 << ": $" << pots[i].amount << " (";
         for (int playerIdx : pots[i].eligiblePlayerIndices) {
-            std::cout << _players[playerIdx]->getName() << " ";
+            getLog() << _players[playerIdx]->getName() << " ";
         }
-        std::cout << ")\n";
+        getLog() << ")\n";
     }
 
+    std::vector<int> stacksBefore = _seats.stacks;
     distributeWinnings();
 
-    std::cout << "\nFinal chip counts:\n";
-    for (auto& player : _players) {
-        std::cout << player->getName() << ": $" << player->getChips() << "\n";
+    if (_allInEvaluated) {
+        for (int seat = 0; seat < _seats.size(); seat++) {
+            int won = _seats.stacks[seat] - stacksBefore[seat];
+            _players[seat]->addAllInAdjustment(_allInExpected[seat] - won);
+        }
+        _allInEvaluated = false;
+    }
+
+    if (_opponentStats) {
+        unsigned inHand = _seats.inHandMask();
+        unsigned showdown = SeatState::count(inHand) >= 2 ? inHand : 0;
+        unsigned winners = 0;
+        for (int seat = 0; seat < _seats.size(); seat++) {
+            if (_seats.stacks[seat] > stacksBefore[seat]) winners |= 1u << seat;
+        }
+        _opponentStats->endHand(_current, showdown, winners & showdown);
+    }
+
+    getLog() << "\nFinal chip counts:\n";
+    for (int i = 0; i < _players.size(); i++) {
+        getLog() << _players[i]->getName() << ": $" << _seats.stacks[i] << "\n";
     }
 
     // Update statistics
@@ -642,77 +877,73 @@ void GameManager::endHand(){
     // Check if game should end
     removeEliminatedPlayers();  // Players with 0 chips -- need to implement
     if (isGameOver()) {
-        std::cout << "\n*** GAME OVER ***\n";
+        getLog() << "\n*** GAME OVER ***\n";
         _gameActive = false;
     }
 }
 
 void GameManager::removeEliminatedPlayers() {
     for (int i = _players.size() - 1; i >= 0; i--) {
-        if (_players[i]->getChips() <= 0) {
+        if (_seats.stacks[i] <= 0) {
+            _players[i]->bindSeat(nullptr, -1);
             _players.erase(_players.begin() + i);
+            _seats.removeSeat(i);
         }
     }
+    rebindSeats();
 }
 
 std::vector<std::shared_ptr<Player>> GameManager::getActivePlayers() {
     std::vector<std::shared_ptr<Player>> activePlayers;
-    for (auto& player : _players) {
-        // Active = not folded (all-in players are still active for hand completion)
-        if (!player->isFolded()) {
-            activePlayers.push_back(player);
+    // Active = not folded (all-in players are still active for hand completion)
+    unsigned inHand = _seats.inHandMask();
+    for (int seat = 0; seat < _seats.size(); seat++) {
+        if (inHand & (1u << seat)) {
+            activePlayers.push_back(_players[seat]);
         }
     }
     return activePlayers;
 }
 
 void GameManager::distributeWinnings(){
+    uint8_t board[5];
+    int boardSize = getBoard(board);
     for (Pot pot: _current.getPots()) {
         if (pot.amount == 0) continue;
 
-        auto winner = determineWinner(pot.eligiblePlayerIndices);
-
-        if (winner) {
-            winner->addChips(pot.amount);
+        // hands are judged with the board; a tie splits the pot, odd chips to the first
+        // winners left of the button
+        std::vector<int> winners = getPotWinners(pot.eligiblePlayerIndices, board, boardSize);
+        int numWinners = static_cast<int>(winners.size());
+        int firstSeat = _current.getDealerPosition() + 1;
+        std::rotate(winners.begin(), std::lower_bound(winners.begin(), winners.end(), firstSeat), winners.end());
+        for (int i = 0; i < numWinners; i++) {
+            _seats.addChips(winners[i], pot.amount / numWinners + (i < pot.amount % numWinners ? 1 : 0));
         }
     }
 }
 
-// Change the return type
 std::vector<PlayerAction> GameManager::getLegalActions(int playerIndex) {
     std::vector<PlayerAction> legalActions;
-    auto player = _players[playerIndex];
-    int currentBet = _current.getCurrentBet();
-
-    // Actions that don't need amounts
-    if (!player->isFolded()) {
+    LegalActions legal = _current.getLegalActions(playerIndex);
+    if (legal.has(Action::fold)) {
         legalActions.push_back(PlayerAction(Action::fold));
     }
-
-    if (currentBet == 0 || player->getRoundBet() == currentBet) {
+    if (legal.has(Action::check)) {
         legalActions.push_back(PlayerAction(Action::check));
     }
-
-    if (currentBet > player->getRoundBet() && player->canCall(currentBet)) {
-        int callAmount = currentBet - player->getRoundBet();
-        legalActions.push_back(PlayerAction(Action::call, callAmount));  // Add amount
+    if (legal.has(Action::call)) {
+        legalActions.push_back(PlayerAction(Action::call, legal.callAmount));
     }
-
-    // Actions that need amounts
-    if (currentBet == 0 && player->getChips() > 0) {
-        int minBet = _bigBlindAmt;
-        legalActions.push_back(PlayerAction(Action::bet, minBet));
+    // bets and raises carry the smallest legal size; anything up to getMaximumBet() goes
+    if (legal.has(Action::bet)) {
+        legalActions.push_back(PlayerAction(Action::bet, legal.minRaiseTo));
     }
-
-    if (currentBet > 0 && player->canRaise(currentBet, getMinimumRaise())) {
-        int minRaise = getMinimumRaise();
-        legalActions.push_back(PlayerAction(Action::raise, minRaise));
+    if (legal.has(Action::raise)) {
+        legalActions.push_back(PlayerAction(Action::raise, legal.minRaiseTo));
     }
-
-    if (player->getChips() > 0) {
-        int allInAmount = player->getRoundBet() + player->getChips();
-        legalActions.push_back(PlayerAction(Action::all_in, allInAmount));
+    if (legal.has(Action::all_in)) {
+        legalActions.push_back(PlayerAction(Action::all_in, legal.allInTo));
     }
-
     return legalActions;
 }
@@ -3,6 +3,7 @@
 #include <string>
 #include "deck.h"
 #include "player.h"
+#include "seatstate.h"
 #include <vector>
 #include "poker_info.h"
 #include "gamestate.h"
@@ -11,6 +12,9 @@
 #include <chrono>
 #include <random>
 #include "ruleset.h"
+#include "opponentstats.h"
+#include "playstyleclassifier.h"
+#include "rangetracker.h"
 #include "console.h"
 #include <iostream>
 
@@ -31,6 +35,16 @@ public:
     void handlePlayerAction(const PlayerAction& playerAct, int playerIndex);
     std::shared_ptr<Player> determineWinner(const std::vector<int>& elligiblePlayerIndices);
     void playHand();
+    // Resumable hand: beginHand() runs up to the first decision, applyDecision() applies the
+    // choice of the seat to act and runs on to the next one. playHand() is these in a loop.
+    void beginHand();
+    bool isAwaitingDecision() const;
+    int getDecisionSeat() const;
+    void applyDecision(const PlayerAction& action);
+    // Puts the table straight into a mid-hand position - seat arrays (one per player) and
+    // public state as given - without dealing or asking anyone, so analysis tools can query
+    // a player's decision at a chosen spot.
+    void loadPosition(const SeatState& seats, const Gamestate& state);
     void playGame(int numHands);
     void advancePhase();
     const Gamestate& getGameState() const;
@@ -56,18 +70,49 @@ public:
     void endHand();
     std::vector<std::shared_ptr<Player>> getActivePlayers();
     std::vector<std::shared_ptr<Player>> getPlayers();
+    const std::shared_ptr<Player>& getPlayer(int playerIndex) const;
     void distributeWinnings();
     std::vector<PlayerAction> getLegalActions(int playerIndex);
     void removeEliminatedPlayers();
     bool canMoreBettingOccur();
+    void rebindSeats();
+    // Tracks every hand played here into stats, which bots then see through the Gamestate.
+    void setOpponentStats(std::shared_ptr<OpponentStats> stats);
+    // Passed on to bots through the Gamestate alongside the stats.
+    void setPlaystyleClassifier(std::shared_ptr<const PlaystyleClassifier> classifier);
+    // Narrows every seat's range on each action; bots read it through the Gamestate.
+    void setRangeTracker(std::shared_ptr<RangeTracker> tracker);
+    // Seeds the deck, so tables given the same seed deal the same cards.
+    void setSeed(uint64_t seed);
+    // Also settles all-ins on expected value: once betting is over before the river, every
+    // runout (or this many random ones, when there are more) is played out against the pots,
+    // and each player is credited the difference between its expected share and what the
+    // dealt runout gave it (Player::getAllInAdjustment). Stacks still follow the dealt runout.
+    // 0 turns it off.
+    void setAllInEvaluation(int runouts = 1000);
+    // The table narrates every hand to cout unless this is turned off. Players that narrate
+    // their decisions write to getLog(), so they go quiet along with the table.
+    void setVerbose(bool verbose);
+    std::ostream& getLog() const;
 
 
     //place for all the rules and game flow logic
     //inlcude things like getting the position of the next active player
 private:
+    void openBettingRound();
+    void finishBettingRound();   // collects bets, then deals on or ends the hand
+    int getBoard(uint8_t* board) const;
+    // live seats among the eligible holding the best hand on the board, in seat order
+    std::vector<int> getPotWinners(const std::vector<int>& eligiblePlayerIndices, const uint8_t* board, int boardSize) const;
+    void evaluateAllIn();        // fills _allInExpected from the pots and the board so far
+
     RuleSet _rules;
     Gamestate _current;
     std::vector<std::shared_ptr<Player>> _players;
+    SeatState _seats; // chips, bets and status for every seat, indexed like _players
+    std::shared_ptr<OpponentStats> _opponentStats;
+    std::shared_ptr<const PlaystyleClassifier> _playstyleClassifier;
+    std::shared_ptr<RangeTracker> _rangeTracker;
     Deck _deck;
     int _smallBlindAmt;
     int _bigBlindAmt;
@@ -78,7 +123,11 @@ private:
     bool _gameActive;
     bool _handInProgress;
     // all optional stuff
-    bool _anyPlayerActedThisRound;
+    unsigned _actedThisRound;     // seats that have had a turn since the betting round opened
+    int _allInRunouts;            // 0 = all-ins settle on the dealt runout only
+    bool _allInEvaluated;         // this hand went to an all-in runout that was valued
+    std::vector<double> _allInExpected;   // each seat's expected winnings from the pots
+    bool _verbose;                // narrate to cout
 
 
     std::mt19937 rng; // - Random number generator for shuffling
@@ -3,22 +3,47 @@
 
 using namespace std;
 
-Gamestate::Gamestate() {
+Gamestate::Gamestate()
+    : _seats(nullptr),
+    _opponentStats(nullptr),
+    _playstyleClassifier(nullptr),
+    _rangeTracker(nullptr),
+    _currentPlayerIndex(0),
+    currentPhase(GamePhase::preflop),
+    _currentBet(0),
+    _dealerPosition(0),
+    _smallBlindPosition(0),
+    _bigBlindPosition(0),
+    _roundBet(0),
+    _bettingRound(1),
+    _smallBlind(0),
+    _bigBlind(0),
+    _legalActionsRule(getLegalActionsRule(BettingStructure::NO_LIMIT)),
+    _maxRaises(0),
+    _raisesThisRound(0) {
+    _actionHistory.reserve(kMaxActionHistory);
 
 }
 
 Gamestate::Gamestate(const std::vector<std::shared_ptr<Player>>& players)
     : _players(players),
+    _seats(nullptr),
+    _opponentStats(nullptr),
+    _playstyleClassifier(nullptr),
+    _rangeTracker(nullptr),
+    _currentPlayerIndex(0),
     currentPhase(GamePhase::preflop),
     _currentBet(0),
-    _roundBet(0),
-    _currentPlayerIndex(0),
     _dealerPosition(0),
     _smallBlindPosition(0),
     _bigBlindPosition(0),
+    _roundBet(0),
+    _bettingRound(1),
     _smallBlind(0),
     _bigBlind(0),
-    _bettingRound(1) {
+    _legalActionsRule(getLegalActionsRule(BettingStructure::NO_LIMIT)),
+    _maxRaises(0),
+    _raisesThisRound(0) {
     _communityCards.clear();
 }
 
@@ -26,14 +51,45 @@ Gamestate::~Gamestate(){
 
 }
 
+void Gamestate::setSeats(const SeatState* seats) {
+    _seats = seats;
+}
+
+const SeatState* Gamestate::getSeats() const {
+    return _seats;
+}
+
+void Gamestate::setOpponentStats(const OpponentStats* stats) {
+    _opponentStats = stats;
+}
+
+const OpponentStats* Gamestate::getOpponentStats() const {
+    return _opponentStats;
+}
+
+void Gamestate::setPlaystyleClassifier(const PlaystyleClassifier* classifier) {
+    _playstyleClassifier = classifier;
+}
+
+const PlaystyleClassifier* Gamestate::getPlaystyleClassifier() const {
+    return _playstyleClassifier;
+}
+
+void Gamestate::setRangeTracker(const RangeTracker* tracker) {
+    _rangeTracker = tracker;
+}
+
+const RangeTracker* Gamestate::getRangeTracker() const {
+    return _rangeTracker;
+}
+
 double Gamestate::getPotOdds() const {
     if (_currentBet == 0) return 0.0;
 
 
-    if (_currentPlayerIndex >= _players.size()) return 0.0;
+    if (!_seats || _currentPlayerIndex < 0 || _currentPlayerIndex >= _seats->size()) return 0.0;
 
-    auto currentPlayer = _players[_currentPlayerIndex];
-    int playerCurrentBet = currentPlayer->getRoundBet();
+    int playerCurrentBet = _seats->roundBets[_currentPlayerIndex];
     int callAmount = _currentBet - playerCurrentBet;
 
     if (callAmount <= 0) return 0.0;
@@ -44,7 +100,7 @@ double Gamestate::getPotOdds() const {
 std::vector<std::shared_ptr<Player>> Gamestate::getActivePlayers(){
     vector<std::shared_ptr<Player>> active;
     for (auto& player: _players) {
-        if (player->getAction() == 2) {
+        if (player->canAct()) {
             active.push_back(player);
         }
     }
@@ -99,12 +155,26 @@ int Gamestate::getCurrentBet() const {
     return _currentBet;
 }
 
+int Gamestate::getSmallBlind() const {
+    return _smallBlind;
+}
+
+int Gamestate::getBigBlind() const {
+    return _bigBlind;
+}
+
+void Gamestate::setBlinds(int smallBlind, int bigBlind) {
+    _smallBlind = smallBlind;
+    _bigBlind = bigBlind;
+}
+
 int Gamestate::getRoundBet()  const{
     return _roundBet;
 }
 
 bool Gamestate::isPlayerActive(int index){
-    return _players[index]->getAction() == 2;
+    if (_seats) return _seats->canAct(index);
+    return _players[index]->canAct();
 }
 
 void Gamestate::setBettingRound(int round) {
@@ -163,8 +233,9 @@ void Gamestate::reset() {
     _currentBet = 0;
     _currentPlayerIndex = 0;
     _bettingRound = 1;
+    _raisesThisRound = 0;
     _communityCards.clear();
-    // _actionHistory.clear();
+    _actionHistory.clear();
     return;
 }
 
@@ -173,6 +244,19 @@ void Gamestate::setCurrentPhase(GamePhase phase) {
     return;
 }
 
+void Gamestate::addActionToHistory(const PlayerAction& action, int playerIndex) {
+    ActionRecord record;
+    record.seat = static_cast<int8_t>(playerIndex);
+    record.phase = currentPhase;
+    record.actionType = action.actionType;
+    record.amount = action.amount;
+    _actionHistory.push_back(record);
+}
+
+const std::vector<ActionRecord>& Gamestate::getActionHistory() const {
+    return _actionHistory;
+}
+
 void Gamestate::addPot(const Pot& pot) {
     _pots.push_back(pot);
 }
@@ -191,3 +275,32 @@ int Gamestate::getTotalPotValue() const {
     return sum;
 }
 
+void Gamestate::setLegalActionsRule(LegalActionsRule rule, int maxRaises) {
+    _legalActionsRule = rule;
+    _maxRaises = maxRaises;
+}
+
+int Gamestate::getRaisesThisRound() const {
+    return _raisesThisRound;
+}
+
+void Gamestate::setRaisesThisRound(int raises) {
+    _raisesThisRound = raises;
+}
+
+LegalActions Gamestate::getLegalActions(int seat) const {
+    if (!_seats || seat < 0 || seat >= _seats->size()) return LegalActions{0, 0, 0, 0, 0};
+    BettingSpot spot;
+    spot.stack = _seats->stacks[seat];
+    spot.roundBet = _seats->roundBets[seat];
+    spot.currentBet = _currentBet;
+    spot.potSize = 0;
+    for (int bet : _seats->totalBets) spot.potSize += bet;
+    spot.bigBlind = _bigBlind;
+    spot.raisesThisRound = _raisesThisRound;
+    spot.maxRaises = _maxRaises;
+    spot.opponentsCanAct = (_seats->canActMask() & ~(1u << seat)) != 0;
+    LegalActions legal = _legalActionsRule(spot);
+    if (!_seats->canAct(seat)) legal.mask = 0;
+    return legal;
+}
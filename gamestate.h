@@ -3,11 +3,16 @@
 #include <string>
 #include "poker_info.h"
 #include "card.h"
+#include "seatstate.h"
+#include "bettinglimits.h"
 #include <vector>
 #include "console.h"
 #include <iostream>
 
 class Player;
+class OpponentStats;
+class PlaystyleClassifier;
+class RangeTracker;
 
 
 struct Pot {
@@ -22,6 +27,17 @@ public:
     Gamestate();
     Gamestate(const std::vector<std::shared_ptr<Player>>& players);
     ~Gamestate();
+    void setSeats(const SeatState* seats);
+    const SeatState* getSeats() const;
+    // the table's opponent statistics, null when nothing is tracked; survives reset()
+    void setOpponentStats(const OpponentStats* stats);
+    const OpponentStats* getOpponentStats() const;
+    // styles of the players in those stats, for makeDecision; null when not set
+    void setPlaystyleClassifier(const PlaystyleClassifier* classifier);
+    const PlaystyleClassifier* getPlaystyleClassifier() const;
+    // every seat's range over hole cards this hand; null when not tracked
+    void setRangeTracker(const RangeTracker* tracker);
+    const RangeTracker* getRangeTracker() const;
     double getPotOdds() const;
     std::vector<std::shared_ptr<Player>> getActivePlayers();
     std::vector<std::shared_ptr<Player>> getPlayers() const;
@@ -44,6 +60,9 @@ public:
     void setBigBlindPosition(int position);
     void setCurrentPlayerIndex(int index);
     void setCurrentPhase(GamePhase phase);
+    void setBlinds(int smallBlind, int bigBlind);
+    void addActionToHistory(const PlayerAction& action, int playerIndex);
+    const std::vector<ActionRecord>& getActionHistory() const;
 
     // Position incrementers/rotators
     void rotateDealerPosition();
@@ -58,8 +77,18 @@ public:
     const std::vector<Pot>& getPots() const;
     void clearPots();
     int getTotalPotValue() const;
+    // the table's betting rule (GameManager sets it from its RuleSet); survives reset()
+    void setLegalActionsRule(LegalActionsRule rule, int maxRaises);
+    int getRaisesThisRound() const;
+    void setRaisesThisRound(int raises);
+    // what the seat may do now, by the table's rule; an empty mask when it can't act
+    LegalActions getLegalActions(int seat) const;
 private:
     std::vector<std::shared_ptr<Player>> _players;
+    const SeatState* _seats; // the table's seat arrays, set by GameManager
+    const OpponentStats* _opponentStats;
+    const PlaystyleClassifier* _playstyleClassifier;
+    const RangeTracker* _rangeTracker;
     std::vector<Card> _communityCards;
     int _currentPlayerIndex;
     GamePhase currentPhase;
@@ -72,7 +101,10 @@ private:
     int _bettingRound;
     int _smallBlind; // fiNinsoivnsovisndvoisndgoisdnfosindfosidnfosidnjfklksfbnisdufnoksdfjnsdfknsdifjn
     int _bigBlind;
-    // std::vector<ActionHistory> _actionHistory;
+    std::vector<ActionRecord> _actionHistory;
+    LegalActionsRule _legalActionsRule;
+    int _maxRaises;
+    int _raisesThisRound;    // bets and raises so far this betting round
 };
 
 #endif // GAMESTATE_H
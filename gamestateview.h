@@ -0,0 +1,61 @@
+#ifndef GAMESTATEVIEW_H
+#define GAMESTATEVIEW_H
+#include <cstdint>
+#include <vector>
+#include "gamestate.h"
+#include "tableengine.h"
+
+// Presents a GameManager table (Gamestate + its SeatState) through the table engine getters,
+// so code written against TableEngine (InfoState, BetAbstraction, ...) runs on it unchanged.
+// Only the given seat's hole cards are converted; they and the board are kept on the stack.
+class GamestateView
+{
+public:
+    GamestateView(const Gamestate& state, int seat)
+        : _state(state), _seats(*state.getSeats()), _boardSize(0) {
+        const std::vector<Card>& hole = _seats.holeCards[seat].getCards();
+        _hole[0] = hole.size() > 0 ? static_cast<uint8_t>(hole[0].getIndex()) : 0;
+        _hole[1] = hole.size() > 1 ? static_cast<uint8_t>(hole[1].getIndex()) : 0;
+        for (const Card& card : state.getCommunityCards()) {
+            if (_boardSize < 5) _board[_boardSize++] = static_cast<uint8_t>(card.getIndex());
+        }
+    }
+
+    int getNumSeats() const { return _seats.size(); }
+    int getBigBlind() const { return _state.getBigBlind(); }
+    int getSmallBlind() const { return _state.getSmallBlind(); }
+    const uint8_t* getHoleCards(int) const { return _hole; }
+    const uint8_t* getBoard() const { return _board; }
+    int getBoardSize() const { return _boardSize; }
+    GamePhase getPhase() const { return _state.getCurrentPhase(); }
+    int getButton() const { return _state.getDealerPosition(); }
+    int getSmallBlindSeat() const { return _state.getSmallBlindPosition(); }
+    int getBigBlindSeat() const { return _state.getBigBlindPosition(); }
+    int getCurrentSeat() const { return _state.getCurrentPlayerIndex(); }
+    int getCurrentBet() const { return _state.getCurrentBet(); }
+    int getStack(int seat) const { return _seats.stacks[seat]; }
+    int getRoundBet(int seat) const { return _seats.roundBets[seat]; }
+    int getTotalBet(int seat) const { return _seats.totalBets[seat]; }
+    unsigned getInHandMask() const { return _seats.inHandMask(); }
+    unsigned getAllInMask() const { return _seats.allIn; }
+    const ActionRecord* getHistory() const { return _state.getActionHistory().data(); }
+    int getHistorySize() const { return static_cast<int>(_state.getActionHistory().size()); }
+
+    int getPotSize() const {
+        int pot = 0;
+        for (int seat = 0; seat < _seats.size(); seat++) pot += _seats.totalBets[seat];
+        return pot;
+    }
+
+    // the table's own rule, the one GameManager validates with
+    LegalActions getLegalActions() const { return _state.getLegalActions(getCurrentSeat()); }
+
+private:
+    const Gamestate& _state;
+    const SeatState& _seats;
+    uint8_t _hole[2];
+    uint8_t _board[5];
+    int _boardSize;
+};
+
+#endif // GAMESTATEVIEW_H
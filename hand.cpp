@@ -38,6 +38,10 @@ void Hand::clear(){
     _cards.clear();
 }
 
+const vector<Card>& Hand::getCards() const {
+    return _cards;
+}
+
 int Hand::getHandRank() const{
     if (isStraightFlush()) return STRAIGHT_FLUSH;
     if (isFourOfAKind()) return FOUR_OF_A_KIND;
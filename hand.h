@@ -15,6 +15,7 @@ public:
     void addCard(const Card& card);
     void addCards(const std::vector<Card>& cards);
     void clear();
+    const std::vector<Card>& getCards() const;
     int getHandRank() const;
     std::vector<int> getKickers() const; // tie breaking stuff
     std::vector<int> getFourOfAKindKickers(const std::unordered_map<int, int>& counts) const;
@@ -0,0 +1,51 @@
+#ifndef HANDCOMBOS_H
+#define HANDCOMBOS_H
+#include <cstdint>
+
+// The 1326 two-card starting hands, numbered so per-hand vectors (ranges, counterfactual
+// values) can be flat arrays. Cards are Card::getIndex values; combo (a, b) with a < b.
+// The tables are built at compile time so lookups inline into the solvers' inner loops.
+class HandCombos
+{
+public:
+    static const int kNumCombos = 1326;
+
+    static int getIndex(int first, int second) { return kTables.index[first][second]; }
+    static const uint8_t* getCards(int combo) { return kTables.cards[combo]; }   // lower card first
+    static uint64_t getMask(int combo) {
+        return (1ull << kTables.cards[combo][0]) | (1ull << kTables.cards[combo][1]);
+    }
+    static uint64_t getMask(const uint8_t* cards, int count) {
+        uint64_t mask = 0;
+        for (int i = 0; i < count; i++) mask |= 1ull << cards[i];
+        return mask;
+    }
+
+private:
+    struct Tables {
+        uint8_t cards[kNumCombos][2];
+        int16_t index[52][52];
+    };
+
+    static constexpr Tables makeTables() {
+        Tables tables = {};
+        int combo = 0;
+        for (int first = 0; first < 52; first++) {
+            tables.index[first][first] = -1;
+            for (int second = first + 1; second < 52; second++) {
+                tables.cards[combo][0] = static_cast<uint8_t>(first);
+                tables.cards[combo][1] = static_cast<uint8_t>(second);
+                tables.index[first][second] = static_cast<int16_t>(combo);
+                tables.index[second][first] = static_cast<int16_t>(combo);
+                combo++;
+            }
+        }
+        return tables;
+    }
+
+    static const Tables kTables;
+};
+
+inline const HandCombos::Tables HandCombos::kTables = HandCombos::makeTables();
+
+#endif // HANDCOMBOS_H
@@ -0,0 +1,261 @@
+#include "handindexer.h"
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+const int kRanks = 13;
+
+// the two rounds: hole cards, then the board as a set
+int getCardsPerRound(int street, int round) {
+    if (round == 0) return 2;
+    return round == 1 && street > 0 ? street + 2 : 0;
+}
+
+uint64_t choose(uint64_t n, int k) {
+    if (k < 0 || static_cast<uint64_t>(k) > n) return 0;
+    uint64_t result = 1;
+    for (int i = 0; i < k; i++) result = result * (n - i) / (i + 1);
+    return result;
+}
+
+int getCount(uint32_t shape, int round) {
+    return (shape >> (4 * round)) & 15;
+}
+
+int getPopCount(uint32_t bits) {
+    int count = 0;
+    for (; bits; bits &= bits - 1) count++;
+    return count;
+}
+
+// every way one suit can take part in a hand up to the street, largest first
+vector<uint32_t> makeShapes(int street) {
+    vector<uint32_t> shapes(1, 0);
+    for (int round = 0; round < 2; round++) {
+        vector<uint32_t> longer;
+        for (uint32_t shape : shapes) {
+            for (int count = 0; count <= getCardsPerRound(street, round); count++) {
+                longer.push_back(shape | static_cast<uint32_t>(count) << (4 * round));
+            }
+        }
+        shapes.swap(longer);
+    }
+    sort(shapes.rbegin(), shapes.rend());
+    return shapes;
+}
+
+uint64_t getPerSuit(uint32_t shape) {
+    uint64_t count = 1;
+    int available = kRanks;
+    for (int round = 0; round < 2; round++) {
+        count *= choose(available, getCount(shape, round));
+        available -= getCount(shape, round);
+    }
+    return count;
+}
+
+// largest b with choose(b, k) <= rank, b in [k - 1, limit]
+uint64_t findLargest(uint64_t rank, int k, uint64_t limit) {
+    uint64_t low = k - 1;
+    uint64_t high = limit;
+    while (low < high) {
+        uint64_t middle = low + (high - low + 1) / 2;
+        if (choose(middle, k) <= rank) {
+            low = middle;
+        } else {
+            high = middle - 1;
+        }
+    }
+    return low;
+}
+
+}
+
+HandIndexer::HandIndexer() {
+    for (int street = 0; street < kStreets; street++) {
+        uint32_t shapes[kSuits];
+        int remaining[2] = {getCardsPerRound(street, 0), getCardsPerRound(street, 1)};
+        enumerate(street, 0, shapes, remaining);
+
+        vector<Configuration>& configurations = _configurations[street];
+        sort(configurations.begin(), configurations.end(),
+             [](const Configuration& a, const Configuration& b) { return a.key < b.key; });
+        uint64_t offset = 0;
+        for (Configuration& configuration : configurations) {
+            configuration.offset = offset;
+            offset += configuration.size;
+        }
+    }
+}
+
+// Shapes per suit in non-increasing order, so each configuration comes up once.
+void HandIndexer::enumerate(int street, int suit, uint32_t* shapes, int* remaining) {
+    if (suit == kSuits) {
+        if (remaining[0] != 0 || remaining[1] != 0) return;
+        Configuration configuration{};
+        configuration.size = 1;
+        for (int i = 0; i < kSuits; i++) {
+            configuration.key = configuration.key << 16 | shapes[i];
+            if (i > 0 && shapes[i] == shapes[i - 1]) {
+                configuration.groups.back().suits++;
+                continue;
+            }
+            Group group;
+            group.shape = shapes[i];
+            group.suits = 1;
+            group.perSuit = getPerSuit(shapes[i]);
+            configuration.groups.push_back(group);
+        }
+        for (Group& group : configuration.groups) {
+            group.size = choose(group.perSuit + group.suits - 1, group.suits);
+            configuration.size *= group.size;
+        }
+        _configurations[street].push_back(configuration);
+        return;
+    }
+
+    static const vector<uint32_t> allShapes[kStreets] = {makeShapes(0), makeShapes(1), makeShapes(2), makeShapes(3)};
+    for (uint32_t shape : allShapes[street]) {
+        if (suit > 0 && shape > shapes[suit - 1]) continue;
+        if (getCount(shape, 0) > remaining[0] || getCount(shape, 1) > remaining[1]) continue;
+        remaining[0] -= getCount(shape, 0);
+        remaining[1] -= getCount(shape, 1);
+        shapes[suit] = shape;
+        enumerate(street, suit + 1, shapes, remaining);
+        remaining[0] += getCount(shape, 0);
+        remaining[1] += getCount(shape, 1);
+    }
+}
+
+uint64_t HandIndexer::getSize(int street) const {
+    const Configuration& last = _configurations[street].back();
+    return last.offset + last.size;
+}
+
+const HandIndexer::Configuration& HandIndexer::findConfiguration(int street, uint64_t key) const {
+    const vector<Configuration>& configurations = _configurations[street];
+    auto found = lower_bound(configurations.begin(), configurations.end(), key,
+                             [](const Configuration& configuration, uint64_t k) { return configuration.key < k; });
+    if (found == configurations.end() || found->key != key) throw runtime_error("Hand has a card twice");
+    return *found;
+}
+
+uint64_t HandIndexer::getIndex(const uint8_t* hole, const uint8_t* board, int boardSize) const {
+    if (boardSize != 0 && (boardSize < 3 || boardSize > 5)) throw runtime_error("Boards have 0, 3, 4 or 5 cards");
+    int street = boardSize == 0 ? 0 : boardSize - 2;
+    uint32_t masks[kSuits][2] = {{0}};
+    for (int i = 0; i < 2 + boardSize; i++) {
+        int card = i < 2 ? hole[i] : board[i - 2];
+        masks[card % 4][i < 2 ? 0 : 1] |= 1u << (card / 4);
+    }
+
+    // shape and rank-set index of each suit
+    uint32_t shapes[kSuits];
+    uint64_t indices[kSuits];
+    for (int suit = 0; suit < kSuits; suit++) {
+        uint32_t used = 0;
+        uint64_t multiplier = 1;
+        shapes[suit] = 0;
+        indices[suit] = 0;
+        for (int round = 0; round < 2; round++) {
+            uint32_t mask = masks[suit][round];
+            int count = getPopCount(mask);
+            uint64_t subset = 0;
+            int position = 0;
+            for (int rank = 0; rank < kRanks; rank++) {
+                if (!((mask >> rank) & 1u)) continue;
+                int compressed = rank - getPopCount(used & ((1u << rank) - 1));
+                subset += choose(compressed, ++position);
+            }
+            indices[suit] += subset * multiplier;
+            multiplier *= choose(kRanks - getPopCount(used), count);
+            shapes[suit] |= static_cast<uint32_t>(count) << (4 * round);
+            used |= mask;
+        }
+    }
+    int order[kSuits] = {0, 1, 2, 3};
+    sort(order, order + kSuits, [&](int a, int b) {
+        return shapes[a] != shapes[b] ? shapes[a] > shapes[b] : indices[a] > indices[b];
+    });
+
+    uint64_t key = 0;
+    for (int i = 0; i < kSuits; i++) key = key << 16 | shapes[order[i]];
+    const Configuration& configuration = findConfiguration(street, key);
+    uint64_t index = configuration.offset;
+    uint64_t multiplier = 1;
+    int position = 0;
+    for (const Group& group : configuration.groups) {
+        // the group's indices are non-increasing; spread them into a strictly decreasing set
+        uint64_t rank = 0;
+        for (int i = 0; i < group.suits; i++) {
+            rank += choose(indices[order[position + i]] + (group.suits - 1 - i), group.suits - i);
+        }
+        index += rank * multiplier;
+        multiplier *= group.size;
+        position += group.suits;
+    }
+    return index;
+}
+
+void HandIndexer::getHand(int street, uint64_t index, uint8_t* cards) const {
+    if (street < 0 || street >= kStreets || index >= getSize(street)) throw runtime_error("Hand index out of range");
+    const vector<Configuration>& configurations = _configurations[street];
+    auto found = upper_bound(configurations.begin(), configurations.end(), index,
+                             [](uint64_t i, const Configuration& configuration) { return i < configuration.offset; });
+    const Configuration& configuration = *(found - 1);
+
+    uint32_t shapes[kSuits];
+    uint64_t indices[kSuits];
+    uint64_t rest = index - configuration.offset;
+    int position = 0;
+    for (const Group& group : configuration.groups) {
+        uint64_t rank = rest % group.size;
+        rest /= group.size;
+        for (int i = 0; i < group.suits; i++) {
+            int k = group.suits - i;
+            uint64_t spread = findLargest(rank, k, group.perSuit + group.suits - 1);
+            rank -= choose(spread, k);
+            shapes[position + i] = group.shape;
+            indices[position + i] = spread - (group.suits - 1 - i);
+        }
+        position += group.suits;
+    }
+
+    // suits in canonical order become suits 0-3
+    int sizes[2] = {0};
+    uint8_t rounds[2][5];
+    for (int suit = 0; suit < kSuits; suit++) {
+        uint32_t used = 0;
+        uint64_t rankSets = indices[suit];
+        for (int round = 0; round < 2; round++) {
+            int count = getCount(shapes[suit], round);
+            int available = kRanks - getPopCount(used);
+            uint64_t choices = choose(available, count);
+            uint64_t subset = rankSets % choices;
+            rankSets /= choices;
+            uint32_t mask = 0;
+            for (int k = count; k > 0; k--) {
+                uint64_t compressed = findLargest(subset, k, available - 1);
+                subset -= choose(compressed, k);
+                int rank = 0;
+                for (uint64_t skipped = 0;; rank++) {
+                    if ((used >> rank) & 1u) continue;
+                    if (skipped++ == compressed) break;
+                }
+                mask |= 1u << rank;
+            }
+            for (int rank = 0; rank < kRanks; rank++) {
+                if ((mask >> rank) & 1u) rounds[round][sizes[round]++] = static_cast<uint8_t>(rank * 4 + suit);
+            }
+            used |= mask;
+        }
+    }
+    int count = 0;
+    for (int round = 0; round < 2; round++) {
+        sort(rounds[round], rounds[round] + sizes[round]);
+        for (int i = 0; i < sizes[round]; i++) cards[count++] = rounds[round][i];
+    }
+}
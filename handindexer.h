@@ -0,0 +1,54 @@
+#ifndef HANDINDEXER_H
+#define HANDINDEXER_H
+#include <cstdint>
+#include <vector>
+
+// Dense index of hole cards plus board up to suit isomorphism: two hands get the same index
+// exactly when relabelling suits turns one into the other, and indices run from 0 to
+// getSize(street) - 1 with no gaps - 169 preflop, 1,286,792 on the flop, 13,960,050 on the
+// turn, 123,156,254 on the river. The board is a set: the order it came in does not matter to
+// a hand's strength or to what the next cards can do, and keeping the turn and river apart
+// would make the river 20 times bigger.
+//
+// Each suit's cards are two rank sets, in the hole and on the board; the two counts are the
+// suit's shape. Suits are put in a canonical order by shape and then by the index of
+// their rank sets, which leaves a configuration (the sorted shapes) and, within it, a multiset
+// of rank-set indices per group of suits sharing a shape. Configurations are laid out one after
+// another and each multiset is ranked combinatorially, so indexing is a few table reads per
+// suit and needs no lookup table of hands.
+class HandIndexer
+{
+public:
+    HandIndexer();
+
+    uint64_t getSize(int street) const;   // street: 0 preflop, 1 flop, 2 turn, 3 river
+    // Cards are Card::getIndex values; boardSize 0, 3, 4 or 5.
+    uint64_t getIndex(const uint8_t* hole, const uint8_t* board, int boardSize) const;
+    // A hand with the given index: hole cards then the street's board, each sorted.
+    void getHand(int street, uint64_t index, uint8_t* cards) const;
+
+private:
+    static const int kStreets = 4;
+    static const int kSuits = 4;
+
+    struct Group {
+        uint32_t shape;     // hole and board card counts, 4 bits each
+        int suits;
+        uint64_t perSuit;   // rank-set choices for one suit of this shape
+        uint64_t size;      // multisets of that many choices
+    };
+
+    struct Configuration {
+        uint64_t key;       // the four sorted shapes
+        uint64_t offset;
+        uint64_t size;
+        std::vector<Group> groups;
+    };
+
+    std::vector<Configuration> _configurations[kStreets];   // per street, by key and by offset
+
+    void enumerate(int street, int suit, uint32_t* shapes, int* remaining);
+    const Configuration& findConfiguration(int street, uint64_t key) const;
+};
+
+#endif // HANDINDEXER_H
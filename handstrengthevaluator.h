@@ -0,0 +1,28 @@
+#ifndef HANDSTRENGTHEVALUATOR_H
+#define HANDSTRENGTHEVALUATOR_H
+#include <cstdint>
+#include "hand.h"
+
+class Gamestate;
+
+// Fast hand ranking on card indices (Card::getIndex, rank * 4 + suit).
+// Values pack the category (same numbering as HandRank, 1 = high card ... 9 = straight flush)
+// into bits 20-23 and up to five tie-break ranks into the 4-bit fields below it,
+// so a plain int compare orders hands and equal values split the pot.
+class HandStrengthEvaluator
+{
+public:
+    static int rankCards(const uint8_t* cards, int count);
+    static int rankHand(const Hand& hand);
+    static int getCategory(int handValue) { return handValue >> 20; }
+
+    // Hole cards against the game's board: all-in equity against one random hand preflop
+    // (getPreflopEquity), current strength after it (getHandStrength).
+    static double evaluateHandStrength(const Hand& hand, const Gamestate& gameState);
+    // From a table of the 169 starting hands, indexed like CardAbstraction::getPreflopClass.
+    static double getPreflopEquity(const uint8_t* hole);
+    // Share of opponent holdings the hand beats on the board now, ties counting half.
+    static double getHandStrength(const uint8_t* hole, const uint8_t* board, int boardSize);
+};
+
+#endif // HANDSTRENGTHEVALUATOR_H
@@ -0,0 +1,353 @@
+#ifndef HEADSUPENGINE_H
+#define HEADSUPENGINE_H
+#include <cstdint>
+#include "poker_info.h"
+#include "ruleset.h"
+#include "bettinglimits.h"
+#include "handstrengthevaluator.h"
+#include "tableengine.h"
+
+// Heads-up only fast path. Two seats means no seat scans and no side pots: the button posts
+// the small blind and acts first preflop, the big blind acts first after the flop, and whatever
+// one player puts in beyond the other's total is simply handed back at settlement.
+//
+// Same interface as TableEngine (startHand / getLegalActions / applyAction / playHand and the
+// getters), so anything written against a generic table engine runs on this one unchanged.
+// Bet sizing comes from BettingLimits, the same rules RuleSet uses.
+template <BettingStructure Structure>
+class HeadsUpEngine
+{
+public:
+    using Limits = BettingLimits<Structure>;
+    static constexpr int kMaxSeats = 2;
+
+    explicit HeadsUpEngine(const RuleSet& rules)
+        : _smallBlind(rules.getSmallBlind()),
+        _bigBlind(rules.getBigBlind()),
+        _maxRaises(rules.getMaxRaises()),
+        _stacks{rules.getStartingChips(), rules.getStartingChips()},
+        _roundBets{0, 0},
+        _totalBets{0, 0},
+        _payoffs{0, 0},
+        _boardSize(0),
+        _historySize(0),
+        _button(1),
+        _currentSeat(-1),
+        _currentBet(0),
+        _raisesThisRound(0),
+        _acted{false, false},
+        _allIn{false, false},
+        _folded{false, false},
+        _phase(GamePhase::showdown),
+        _handOver(true),
+        _dealPreset(false),
+        _dealStacked(false),
+        _rng(0) {
+        for (int i = 0; i < 52; i++) _deck[i] = static_cast<uint8_t>(i);
+    }
+
+    void seed(uint64_t seed) { _rng = EngineRng(seed); }
+    void setStack(int seat, int chips) { _stacks[seat] = chips; }
+    void setButton(int seat) { _button = seat; }
+    // Deals these cards in the next hand instead of drawing them: seat 0's hole cards, seat 1's,
+    // then the five board cards, all different. For replaying a deal from another table.
+    void setNextDeal(const uint8_t* cards) {
+        for (int i = 0; i < 9; i++) _nextDeal[i] = cards[i];
+        _dealPreset = true;
+    }
+
+    bool startHand() {
+        if (_stacks[0] <= 0 || _stacks[1] <= 0) return false;
+        _button ^= 1;
+        for (int seat = 0; seat < 2; seat++) {
+            _roundBets[seat] = 0;
+            _totalBets[seat] = 0;
+            _payoffs[seat] = 0;
+            _acted[seat] = false;
+            _allIn[seat] = false;
+            _folded[seat] = false;
+        }
+
+        _deckPos = 0;
+        _boardSize = 0;
+        _historySize = 0;
+        _dealStacked = _dealPreset;
+        if (_dealPreset) stackDeck();
+        _holeCards[0] = dealCard();
+        _holeCards[2] = dealCard();
+        _holeCards[1] = dealCard();
+        _holeCards[3] = dealCard();
+
+        _phase = GamePhase::preflop;
+        _handOver = false;
+        _raisesThisRound = 0;
+        int smallPosted = post(_button, _smallBlind);
+        int bigPosted = post(_button ^ 1, _bigBlind);
+        _currentBet = smallPosted > bigPosted ? smallPosted : bigPosted;
+
+        // the big blind "just acted" so the button is next to speak
+        _currentSeat = _button ^ 1;
+        advance();
+        return true;
+    }
+
+    LegalActions getLegalActions() const {
+        if (_handOver) return LegalActions{0, 0, 0, 0, 0};
+        int seat = _currentSeat;
+        BettingSpot spot;
+        spot.stack = _stacks[seat];
+        spot.roundBet = _roundBets[seat];
+        spot.currentBet = _currentBet;
+        spot.potSize = getPotSize();
+        spot.bigBlind = _bigBlind;
+        spot.raisesThisRound = _raisesThisRound;
+        spot.maxRaises = _maxRaises;
+        spot.opponentsCanAct = !_allIn[seat ^ 1];
+        return getLegalActionsAt<Structure>(spot);
+    }
+
+    bool applyAction(const PlayerAction& action) {
+        if (_handOver) return false;
+        LegalActions legal = getLegalActions();
+        if (!legal.has(action.actionType)) return false;
+
+        int seat = _currentSeat;
+        switch (action.actionType) {
+        case Action::fold:
+            _folded[seat] = true;
+            recordAction(seat, Action::fold, 0);
+            settle();
+            return true;
+
+        case Action::check:
+            break;
+
+        case Action::call:
+            putChips(seat, legal.callAmount);
+            break;
+
+        case Action::bet:
+        case Action::raise:
+            if (action.amount < legal.minRaiseTo || action.amount > legal.maxRaiseTo) return false;
+            raiseTo(seat, action.amount);
+            break;
+
+        case Action::all_in:
+            raiseTo(seat, legal.allInTo);
+            break;
+        }
+        recordAction(seat, action.actionType, action.actionType == Action::call ? legal.callAmount
+                                              : action.actionType == Action::all_in ? legal.allInTo
+                                              : action.amount);
+        _acted[seat] = true;
+        advance();
+        return true;
+    }
+
+    template <typename Policy>
+    bool playHand(Policy&& policy) {
+        if (!startHand()) return false;
+        while (!_handOver) {
+            if (!applyAction(policy(*this, _currentSeat))) {
+                applyAction(PlayerAction(_currentBet > _roundBets[_currentSeat] ? Action::fold : Action::check));
+            }
+        }
+        return true;
+    }
+
+    bool isHandOver() const { return _handOver; }
+    int getCurrentSeat() const { return _currentSeat; }
+    GamePhase getPhase() const { return _phase; }
+    int getNumSeats() const { return 2; }
+    int getButton() const { return _button; }
+    int getSmallBlindSeat() const { return _button; }
+    int getBigBlindSeat() const { return _button ^ 1; }
+    int getSmallBlind() const { return _smallBlind; }
+    int getBigBlind() const { return _bigBlind; }
+    int getCurrentBet() const { return _currentBet; }
+    int getStack(int seat) const { return _stacks[seat]; }
+    int getRoundBet(int seat) const { return _roundBets[seat]; }
+    int getTotalBet(int seat) const { return _totalBets[seat]; }
+    int getPayoff(int seat) const { return _payoffs[seat]; }
+    int getPotSize() const { return _totalBets[0] + _totalBets[1]; }
+    const uint8_t* getHoleCards(int seat) const { return &_holeCards[seat * 2]; }
+    const uint8_t* getBoard() const { return _board; }
+    int getBoardSize() const { return _boardSize; }
+    const ActionRecord* getHistory() const { return _history; }
+    int getHistorySize() const { return _historySize; }
+    unsigned getInHandMask() const { return (_folded[0] ? 0u : 1u) | (_folded[1] ? 0u : 2u); }
+    unsigned getAllInMask() const { return (_allIn[0] ? 1u : 0u) | (_allIn[1] ? 2u : 0u); }
+    unsigned canActMask() const { return getInHandMask() & ~getAllInMask(); }
+
+private:
+    int _smallBlind;
+    int _bigBlind;
+    int _maxRaises;
+
+    int _stacks[2];
+    int _roundBets[2];
+    int _totalBets[2];
+    int _payoffs[2];
+    uint8_t _holeCards[4];
+    uint8_t _deck[52];
+    int _deckPos;
+    uint8_t _board[5];
+    int _boardSize;
+    ActionRecord _history[kMaxActionHistory];
+    int _historySize;
+
+    int _button;
+    int _currentSeat;
+    int _currentBet;
+    int _raisesThisRound;
+    bool _acted[2];
+    bool _allIn[2];
+    bool _folded[2];
+    GamePhase _phase;
+    bool _handOver;
+    uint8_t _nextDeal[9];
+    bool _dealPreset;
+    bool _dealStacked;     // this hand deals the preset cards off the top of the deck
+    EngineRng _rng;
+
+    static unsigned bit(Action action) { return 1u << static_cast<int>(action); }
+
+    void recordAction(int seat, Action action, int amount) {
+        if (_historySize == kMaxActionHistory) return;
+        ActionRecord& record = _history[_historySize++];
+        record.seat = static_cast<int8_t>(seat);
+        record.phase = _phase;
+        record.actionType = action;
+        record.amount = action == Action::check || action == Action::fold ? 0 : amount;
+    }
+
+    // puts the preset cards on top of the deck in the order they are dealt
+    void stackDeck() {
+        static const int kDealOrder[9] = {0, 2, 1, 3, 4, 5, 6, 7, 8};
+        for (int i = 0; i < 9; i++) {
+            int j = i;
+            while (j < 51 && _deck[j] != _nextDeal[kDealOrder[i]]) j++;
+            uint8_t card = _deck[j];
+            _deck[j] = _deck[i];
+            _deck[i] = card;
+        }
+        _dealPreset = false;
+    }
+
+    uint8_t dealCard() {
+        if (_dealStacked) return _deck[_deckPos++];
+        int pick = _deckPos + _rng.below(52 - _deckPos);
+        uint8_t card = _deck[pick];
+        _deck[pick] = _deck[_deckPos];
+        _deck[_deckPos++] = card;
+        return card;
+    }
+
+    void putChips(int seat, int amount) {
+        _stacks[seat] -= amount;
+        _roundBets[seat] += amount;
+        _totalBets[seat] += amount;
+        if (_stacks[seat] == 0) _allIn[seat] = true;
+    }
+
+    int post(int seat, int blind) {
+        int amount = blind < _stacks[seat] ? blind : _stacks[seat];
+        putChips(seat, amount);
+        return amount;
+    }
+
+    void raiseTo(int seat, int roundTotal) {
+        putChips(seat, roundTotal - _roundBets[seat]);
+        if (roundTotal > _currentBet) {
+            _currentBet = roundTotal;
+            _raisesThisRound++;
+            _acted[seat ^ 1] = false;
+        }
+    }
+
+    // hands the turn to the opponent if they still owe a decision, otherwise closes the street
+    void advance() {
+        int other = _currentSeat ^ 1;
+        if (!_allIn[other]) {
+            bool facingBet = _roundBets[other] < _currentBet;
+            bool stillToSpeak = !_acted[other] && !_allIn[_currentSeat];
+            if (facingBet || stillToSpeak) {
+                _currentSeat = other;
+                return;
+            }
+        }
+        endBettingRound();
+    }
+
+    void endBettingRound() {
+        _roundBets[0] = _roundBets[1] = 0;
+        _currentBet = 0;
+        _raisesThisRound = 0;
+        _acted[0] = _acted[1] = false;
+
+        if (_allIn[0] || _allIn[1] || _phase == GamePhase::river) {
+            settle();
+            return;
+        }
+        switch (_phase) {
+        case GamePhase::preflop:
+            _board[0] = dealCard();
+            _board[1] = dealCard();
+            _board[2] = dealCard();
+            _boardSize = 3;
+            _phase = GamePhase::flop;
+            break;
+        case GamePhase::flop:
+            _board[_boardSize++] = dealCard();
+            _phase = GamePhase::turn;
+            break;
+        default:
+            _board[_boardSize++] = dealCard();
+            _phase = GamePhase::river;
+            break;
+        }
+        _currentSeat = _button ^ 1;
+    }
+
+    // One pot: both players win or split 2 * the smaller total; the uncalled rest goes back.
+    void settle() {
+        int won[2] = {0, 0};
+        if (_folded[0] || _folded[1]) {
+            won[_folded[0] ? 1 : 0] = getPotSize();
+        } else {
+            while (_boardSize < 5) _board[_boardSize++] = dealCard();
+            int matched = _totalBets[0] < _totalBets[1] ? _totalBets[0] : _totalBets[1];
+            for (int seat = 0; seat < 2; seat++) won[seat] = _totalBets[seat] - matched;
+
+            uint8_t cards[7];
+            for (int i = 0; i < 5; i++) cards[i + 2] = _board[i];
+            cards[0] = _holeCards[0];
+            cards[1] = _holeCards[1];
+            int value0 = HandStrengthEvaluator::rankCards(cards, 7);
+            cards[0] = _holeCards[2];
+            cards[1] = _holeCards[3];
+            int value1 = HandStrengthEvaluator::rankCards(cards, 7);
+
+            int pot = 2 * matched;
+            if (value0 > value1) {
+                won[0] += pot;
+            } else if (value1 > value0) {
+                won[1] += pot;
+            } else {
+                // odd chip to the first seat after the button, the big blind
+                won[_button] += pot / 2;
+                won[_button ^ 1] += pot - pot / 2;
+            }
+        }
+
+        for (int seat = 0; seat < 2; seat++) {
+            _stacks[seat] += won[seat];
+            _payoffs[seat] = won[seat] - _totalBets[seat];
+        }
+        _phase = GamePhase::showdown;
+        _handOver = true;
+        _currentSeat = -1;
+    }
+};
+
+#endif // HEADSUPENGINE_H
@@ -0,0 +1,36 @@
+#include "infostate.h"
+#include "gamestate.h"
+#include "gamestateview.h"
+
+namespace {
+
+template <typename T>
+void encodeGamestate(const Gamestate& state, int seat, T* out) {
+    if (!state.getSeats() || seat < 0 || seat >= state.getSeats()->size()) {
+        std::memset(out, 0, sizeof(T) * InfoState::kSize);
+        return;
+    }
+    InfoState::encode(GamestateView(state, seat), seat, out);
+}
+
+}
+
+void InfoState::encode(const Gamestate& state, int seat, float* out) {
+    encodeGamestate(state, seat, out);
+}
+
+void InfoState::encode(const Gamestate& state, int seat, int8_t* out) {
+    encodeGamestate(state, seat, out);
+}
+
+void InfoState::encodeBatch(const Gamestate* const* states, const int* seats, int count, float* out) {
+    for (int i = 0; i < count; i++) {
+        encodeGamestate(*states[i], seats[i], out + static_cast<size_t>(i) * kSize);
+    }
+}
+
+void InfoState::encodeBatch(const Gamestate* const* states, const int* seats, int count, int8_t* out) {
+    for (int i = 0; i < count; i++) {
+        encodeGamestate(*states[i], seats[i], out + static_cast<size_t>(i) * kSize);
+    }
+}
@@ -0,0 +1,130 @@
+#ifndef INFOSTATE_H
+#define INFOSTATE_H
+#include <cstdint>
+#include <cstring>
+#include "poker_info.h"
+#include "tableengine.h"
+
+class Gamestate;
+
+// Fixed-layout information-state features for one seat, written straight into a caller
+// buffer of kSize elements (no allocation). Works on a GameManager table (Gamestate) or on
+// any engine with the TableEngine interface. Chip amounts are in big blinds; everything
+// positional is relative to the encoded seat.
+//
+//   [kHoleOffset]      52  own hole cards, one-hot by Card::getIndex
+//   [kBoardOffset]     52  community cards, one-hot
+//   [kStreetOffset]     4  preflop / flop / turn / river
+//   [kPositionOffset]  10  seats after the button (0 = button)
+//   [kChipOffset]       4  pot, amount to call, own stack, own round bet
+//   [kOpponentOffset]  9x4 each later seat in turn order: stack, round bet, in hand, all in
+//   [kHistoryOffset]  16x13 most recent actions, oldest first: action one-hot (6),
+//                          street one-hot (4), seats after us / kMaxSeats, is us, amount
+//   [kLegalOffset]      6  legal Action types for the seat to act
+//
+// The int8 form stores flags as 0/1 and amounts rounded to whole big blinds, clamped to int8.
+class InfoState
+{
+public:
+    static const int kMaxSeats = 10;
+    static const int kHistoryLength = 16;
+    static const int kHistoryStride = 13;
+
+    static const int kHoleOffset = 0;
+    static const int kBoardOffset = 52;
+    static const int kStreetOffset = 104;
+    static const int kPositionOffset = 108;
+    static const int kChipOffset = kPositionOffset + kMaxSeats;
+    static const int kOpponentOffset = kChipOffset + 4;
+    static const int kHistoryOffset = kOpponentOffset + (kMaxSeats - 1) * 4;
+    static const int kLegalOffset = kHistoryOffset + kHistoryLength * kHistoryStride;
+    static const int kSize = kLegalOffset + 6;
+
+    static void encode(const Gamestate& state, int seat, float* out);
+    static void encode(const Gamestate& state, int seat, int8_t* out);
+    // states[i] / seats[i] -> out + i * kSize
+    static void encodeBatch(const Gamestate* const* states, const int* seats, int count, float* out);
+    static void encodeBatch(const Gamestate* const* states, const int* seats, int count, int8_t* out);
+
+    template <typename Table, typename T>
+    static void encode(const Table& table, int seat, T* out) {
+        write(table, seat, out);
+    }
+
+    template <typename Table, typename T>
+    static void encodeBatch(const Table* const* tables, const int* seats, int count, T* out) {
+        for (int i = 0; i < count; i++) {
+            write(*tables[i], seats[i], out + static_cast<size_t>(i) * kSize);
+        }
+    }
+
+private:
+    static void store(float* out, int index, float value) { out[index] = value; }
+    static void store(int8_t* out, int index, float value) {
+        float rounded = value < 0 ? value - 0.5f : value + 0.5f;
+        if (rounded > 127.0f) rounded = 127.0f;
+        if (rounded < -128.0f) rounded = -128.0f;
+        out[index] = static_cast<int8_t>(rounded);
+    }
+
+    // Table needs the TableEngine getters (stacks, bets, cards, masks, history, legal actions)
+    template <typename Table, typename T>
+    static void write(const Table& table, int seat, T* out) {
+        std::memset(out, 0, sizeof(T) * kSize);
+        int numSeats = table.getNumSeats();
+        float bigBlind = static_cast<float>(table.getBigBlind() > 0 ? table.getBigBlind() : 1);
+
+        const uint8_t* hole = table.getHoleCards(seat);
+        store(out, kHoleOffset + hole[0], 1.0f);
+        store(out, kHoleOffset + hole[1], 1.0f);
+        const uint8_t* board = table.getBoard();
+        for (int i = 0; i < table.getBoardSize(); i++) {
+            store(out, kBoardOffset + board[i], 1.0f);
+        }
+
+        int phase = static_cast<int>(table.getPhase());
+        if (phase < 4) store(out, kStreetOffset + phase, 1.0f);
+        int position = (seat - table.getButton() + numSeats) % numSeats;
+        if (position < kMaxSeats) store(out, kPositionOffset + position, 1.0f);
+
+        store(out, kChipOffset, table.getPotSize() / bigBlind);
+        store(out, kChipOffset + 1, (table.getCurrentBet() - table.getRoundBet(seat)) / bigBlind);
+        store(out, kChipOffset + 2, table.getStack(seat) / bigBlind);
+        store(out, kChipOffset + 3, table.getRoundBet(seat) / bigBlind);
+
+        unsigned inHand = table.getInHandMask();
+        unsigned allIn = table.getAllInMask();
+        for (int k = 1; k < numSeats && k < kMaxSeats; k++) {
+            int other = (seat + k) % numSeats;
+            int base = kOpponentOffset + (k - 1) * 4;
+            store(out, base, table.getStack(other) / bigBlind);
+            store(out, base + 1, table.getRoundBet(other) / bigBlind);
+            store(out, base + 2, (inHand >> other) & 1u ? 1.0f : 0.0f);
+            store(out, base + 3, (allIn >> other) & 1u ? 1.0f : 0.0f);
+        }
+
+        const ActionRecord* history = table.getHistory();
+        int historySize = table.getHistorySize();
+        int first = historySize > kHistoryLength ? historySize - kHistoryLength : 0;
+        for (int i = first; i < historySize; i++) {
+            const ActionRecord& record = history[i];
+            int base = kHistoryOffset + (i - first) * kHistoryStride;
+            int relative = (record.seat - seat + numSeats) % numSeats;
+            store(out, base + static_cast<int>(record.actionType), 1.0f);
+            int street = static_cast<int>(record.phase);
+            if (street < 4) store(out, base + 6 + street, 1.0f);
+            store(out, base + 10, static_cast<float>(relative) / kMaxSeats);
+            store(out, base + 11, relative == 0 ? 1.0f : 0.0f);
+            store(out, base + 12, record.amount / bigBlind);
+        }
+
+        if (table.getCurrentSeat() == seat) {
+            LegalActions legal = table.getLegalActions();
+            for (int action = 0; action < 6; action++) {
+                if ((legal.mask >> action) & 1u) store(out, kLegalOffset + action, 1.0f);
+            }
+        }
+    }
+};
+
+#endif // INFOSTATE_H
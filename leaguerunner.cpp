@@ -0,0 +1,403 @@
+#include "leaguerunner.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+const uint32_t kMagic = 0x474c4b50;   // 'PKLG'
+const uint32_t kVersion = 1;
+const double kEloScale = 400.0 / log(10.0);
+
+struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t numBots;
+    uint32_t tableSize;
+    uint64_t seed;
+    uint64_t rounds;
+    uint64_t numMatchups;
+    int64_t tableHands;
+    double tableSeconds;
+};
+
+double getSeconds(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+double sigmoid(double x) {
+    return 1.0 / (1.0 + exp(-x));
+}
+
+// Inverts a symmetric positive definite matrix in place (Gauss-Jordan, no pivoting needed).
+void invert(vector<double>& matrix, int size) {
+    vector<double> inverse(static_cast<size_t>(size) * size, 0.0);
+    for (int i = 0; i < size; i++) inverse[i * size + i] = 1.0;
+    for (int column = 0; column < size; column++) {
+        double pivot = matrix[column * size + column];
+        for (int j = 0; j < size; j++) {
+            matrix[column * size + j] /= pivot;
+            inverse[column * size + j] /= pivot;
+        }
+        for (int row = 0; row < size; row++) {
+            double factor = matrix[row * size + column];
+            if (row == column || factor == 0.0) continue;
+            for (int j = 0; j < size; j++) {
+                matrix[row * size + j] -= factor * matrix[column * size + j];
+                inverse[row * size + j] -= factor * inverse[column * size + j];
+            }
+        }
+    }
+    matrix.swap(inverse);
+}
+
+}
+
+LeagueTable::LeagueTable(int numBots)
+    : numBots(numBots),
+    pairings(static_cast<size_t>(numBots) * numBots, Pairing{0, 0.0, 0.0, 0.0}),
+    hands(numBots, 0),
+    decisionSeconds(numBots, 0.0),
+    tableHands(0),
+    tableSeconds(0.0) {
+}
+
+void LeagueTable::addDeal(int first, int second, double difference) {
+    double win = difference > 0.0 ? 1.0 : (difference < 0.0 ? 0.0 : 0.5);
+    Pairing& forward = pairings[first * numBots + second];
+    forward.deals++;
+    forward.wins += win;
+    forward.sum += difference;
+    forward.squares += difference * difference;
+    Pairing& backward = pairings[second * numBots + first];
+    backward.deals++;
+    backward.wins += 1.0 - win;
+    backward.sum -= difference;
+    backward.squares += difference * difference;
+}
+
+void LeagueTable::merge(const LeagueTable& other) {
+    if (other.numBots != numBots) throw runtime_error("League tables differ in size");
+    for (size_t i = 0; i < pairings.size(); i++) {
+        pairings[i].deals += other.pairings[i].deals;
+        pairings[i].wins += other.pairings[i].wins;
+        pairings[i].sum += other.pairings[i].sum;
+        pairings[i].squares += other.pairings[i].squares;
+    }
+    for (int bot = 0; bot < numBots; bot++) {
+        hands[bot] += other.hands[bot];
+        decisionSeconds[bot] += other.decisionSeconds[bot];
+    }
+    tableHands += other.tableHands;
+    tableSeconds += other.tableSeconds;
+}
+
+const LeagueTable::Pairing& LeagueTable::getPairing(int first, int second) const {
+    return pairings[first * numBots + second];
+}
+
+double LeagueTable::getHandsPerSecond(int bot) const {
+    return decisionSeconds[bot] > 0.0 ? hands[bot] / decisionSeconds[bot] : 0.0;
+}
+
+LeagueRunner::LeagueRunner(const RuleSet& rules, int numThreads)
+    : _rules(rules), _pool(numThreads), _tableSize(2), _dealsPerRound(1000), _jobSeconds(0.25), _seed(0),
+    _rounds(0) {
+}
+
+void LeagueRunner::addBot(const string& name, DuplicateMatch::Entrant bot) {
+    if (!_matchups.empty()) throw runtime_error("Bots must be added before the league starts");
+    _names.push_back(name);
+    _bots.push_back(bot);
+}
+
+void LeagueRunner::setTableSize(int seats) {
+    if (!_matchups.empty()) throw runtime_error("The table size is fixed once the league starts");
+    if (seats < 2 || seats > SeatState::kMaxSeats) throw runtime_error("Tables seat from two players up");
+    _tableSize = seats;
+}
+
+void LeagueRunner::setSchedule(int dealsPerRound, double jobSeconds) {
+    if (dealsPerRound <= 0 || jobSeconds <= 0.0) throw runtime_error("A round needs deals and jobs need time");
+    _dealsPerRound = dealsPerRound;
+    _jobSeconds = jobSeconds;
+}
+
+void LeagueRunner::setSeed(uint64_t seed) {
+    _seed = seed;
+}
+
+void LeagueRunner::setCheckpoint(const string& path) {
+    _checkpoint = path;
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) return;
+    fclose(file);
+    load(path);
+}
+
+void LeagueRunner::schedule() {
+    if (!_matchups.empty()) return;
+    int numBots = static_cast<int>(_bots.size());
+    if (numBots < _tableSize) throw runtime_error("A league needs at least a table's worth of bots");
+
+    // every combination of tableSize bots, in order
+    vector<int> seats(_tableSize);
+    for (int i = 0; i < _tableSize; i++) seats[i] = i;
+    for (;;) {
+        _matchups.push_back(seats);
+        int i = _tableSize - 1;
+        while (i >= 0 && seats[i] == numBots - _tableSize + i) i--;
+        if (i < 0) break;
+        seats[i]++;
+        for (int j = i + 1; j < _tableSize; j++) seats[j] = seats[j - 1] + 1;
+    }
+    _matchupDeals.assign(_matchups.size(), 0);
+    _table = LeagueTable(numBots);
+}
+
+// Seconds one hand takes at a table of these bots: their own decision time per hand plus what
+// the table spends dealing and settling. 0 until something has been measured.
+double LeagueRunner::getHandSeconds(const vector<int>& bots) const {
+    if (_table.tableHands == 0) return 0.0;
+    double decisions = 0.0;
+    long long hands = 0;
+    for (int bot = 0; bot < _table.numBots; bot++) {
+        decisions += _table.decisionSeconds[bot];
+        hands += _table.hands[bot];
+    }
+    double overhead = max(0.0, _table.tableSeconds - decisions) / _table.tableHands;
+    double unmeasured = hands > 0 ? decisions / hands : 0.0;   // an average bot
+    double seconds = overhead;
+    for (int bot : bots) {
+        seconds += _table.hands[bot] > 0 ? _table.decisionSeconds[bot] / _table.hands[bot] : unmeasured;
+    }
+    return seconds;
+}
+
+void LeagueRunner::playJob(const Job& job, LeagueTable& table) const {
+    const vector<int>& bots = _matchups[job.matchup];
+    int numSeats = _tableSize;
+    double scale = 100.0 / _rules.getBigBlind() / numSeats;
+    vector<DuplicateMatch::Entrant> entrants(numSeats);
+    for (int slot = 0; slot < numSeats; slot++) entrants[slot] = _bots[bots[slot]];
+    vector<double> won(numSeats);
+    vector<double> decisionSeconds(numSeats, 0.0);
+    auto jobStart = chrono::steady_clock::now();
+
+    // every matchup plays deal d from the same seeds, so all of them see the same cards
+    for (long long deal = job.firstDeal; deal < job.firstDeal + job.deals; deal++) {
+        fill(won.begin(), won.end(), 0.0);
+        for (int rotation = 0; rotation < numSeats; rotation++) {
+            DuplicateMatch::playTable(_rules, _seed, deal, rotation, entrants, won.data(), decisionSeconds.data());
+        }
+        for (int first = 0; first < numSeats; first++) {
+            table.hands[bots[first]] += numSeats;
+            for (int second = first + 1; second < numSeats; second++) {
+                table.addDeal(bots[first], bots[second], (won[first] - won[second]) * scale);
+            }
+        }
+    }
+    for (int slot = 0; slot < numSeats; slot++) table.decisionSeconds[bots[slot]] += decisionSeconds[slot];
+    table.tableHands += job.deals * numSeats;
+    table.tableSeconds += getSeconds(jobStart);
+}
+
+void LeagueRunner::run(int rounds) {
+    schedule();
+    while (_rounds < rounds) {
+        // cut each matchup's deals into jobs of about jobSeconds, then hand out the longest first
+        vector<Job> jobs;
+        for (int matchup = 0; matchup < static_cast<int>(_matchups.size()); matchup++) {
+            double dealSeconds = getHandSeconds(_matchups[matchup]) * _tableSize;
+            int chunk = dealSeconds > 0.0 ? static_cast<int>(_jobSeconds / dealSeconds) : _dealsPerRound / 4;
+            chunk = max(1, min(chunk, _dealsPerRound));
+            for (int deal = 0; deal < _dealsPerRound; deal += chunk) {
+                Job job;
+                job.matchup = matchup;
+                job.firstDeal = _matchupDeals[matchup] + deal;
+                job.deals = min(chunk, _dealsPerRound - deal);
+                job.cost = dealSeconds > 0.0 ? job.deals * dealSeconds : job.deals;
+                jobs.push_back(job);
+            }
+        }
+        sort(jobs.begin(), jobs.end(), [](const Job& a, const Job& b) { return a.cost > b.cost; });
+
+        vector<LeagueTable> tables(_pool.size(), LeagueTable(_table.numBots));
+        atomic<size_t> next(0);
+        _pool.run([&](int worker) {
+            for (size_t index = next++; index < jobs.size(); index = next++) {
+                playJob(jobs[index], tables[worker]);
+            }
+        });
+        for (const LeagueTable& table : tables) _table.merge(table);
+        for (long long& deals : _matchupDeals) deals += _dealsPerRound;
+        _rounds++;
+        if (!_checkpoint.empty()) save(_checkpoint);
+    }
+}
+
+int LeagueRunner::getRounds() const {
+    return _rounds;
+}
+
+const LeagueTable& LeagueRunner::getTable() const {
+    return _table;
+}
+
+vector<LeagueRunner::Rating> LeagueRunner::getRatings() const {
+    int numBots = static_cast<int>(_bots.size());
+    const LeagueTable table = _table.numBots == numBots ? _table : LeagueTable(numBots);   // nothing played yet
+    vector<double> strength(numBots, 0.0);
+    vector<double> information;
+    // Newton steps on the log-likelihood; the prior is a win and a loss against strength 0
+    for (int iteration = 0; iteration < 100; iteration++) {
+        vector<double> gradient(numBots, 0.0);
+        information.assign(static_cast<size_t>(numBots) * numBots, 0.0);
+        for (int i = 0; i < numBots; i++) {
+            double prior = sigmoid(strength[i]);
+            gradient[i] += 1.0 - 2.0 * prior;
+            information[i * numBots + i] += 2.0 * prior * (1.0 - prior);
+            for (int j = 0; j < numBots; j++) {
+                const LeagueTable::Pairing& pairing = table.getPairing(i, j);
+                if (i == j || pairing.deals == 0) continue;
+                double expected = sigmoid(strength[i] - strength[j]);
+                double weight = pairing.deals * expected * (1.0 - expected);
+                gradient[i] += pairing.wins - pairing.deals * expected;
+                information[i * numBots + i] += weight;
+                information[i * numBots + j] -= weight;
+            }
+        }
+        invert(information, numBots);
+        double largest = 0.0;
+        for (int i = 0; i < numBots; i++) {
+            double step = 0.0;
+            for (int j = 0; j < numBots; j++) step += information[i * numBots + j] * gradient[j];
+            strength[i] += step;
+            largest = max(largest, fabs(step));
+        }
+        if (largest < 1e-9) break;
+    }
+
+    // only differences are known, so ratings and their errors are taken about the league mean
+    double mean = 0.0;
+    double total = 0.0;
+    vector<double> rowMeans(numBots, 0.0);
+    for (int i = 0; i < numBots; i++) {
+        mean += strength[i] / numBots;
+        for (int j = 0; j < numBots; j++) rowMeans[i] += information[i * numBots + j] / numBots;
+        total += rowMeans[i] / numBots;
+    }
+    vector<Rating> ratings;
+    for (int bot = 0; bot < numBots; bot++) {
+        Rating rating;
+        rating.name = _names[bot];
+        rating.elo = (strength[bot] - mean) * kEloScale;
+        double variance = information[bot * numBots + bot] - 2.0 * rowMeans[bot] + total;
+        rating.error = sqrt(max(0.0, variance)) * kEloScale;
+        rating.deals = 0;
+        double sum = 0.0;
+        for (int other = 0; other < numBots; other++) {
+            rating.deals += table.getPairing(bot, other).deals;
+            sum += table.getPairing(bot, other).sum;
+        }
+        rating.bbPer100 = rating.deals > 0 ? sum / rating.deals : 0.0;
+        rating.handsPerSecond = table.getHandsPerSecond(bot);
+        ratings.push_back(rating);
+    }
+    sort(ratings.begin(), ratings.end(), [](const Rating& a, const Rating& b) { return a.elo > b.elo; });
+    return ratings;
+}
+
+void LeagueRunner::print(ostream& out) const {
+    out << _rounds << " rounds, " << _matchups.size() << " matchups" << endl;
+    out << " rank  bot                          elo       +/-    bb/100      deals   hands/s" << endl;
+    vector<Rating> ratings = getRatings();
+    out << fixed;
+    for (size_t i = 0; i < ratings.size(); i++) {
+        const Rating& rating = ratings[i];
+        out << setw(5) << i + 1 << "  " << left << setw(24) << rating.name << right
+            << setprecision(0) << setw(9) << rating.elo << setw(10) << rating.error
+            << setprecision(1) << setw(10) << rating.bbPer100 << setw(11) << rating.deals
+            << setprecision(0) << setw(10) << rating.handsPerSecond << endl;
+    }
+    out.unsetf(ios::fixed);
+    out << setprecision(6);
+}
+
+void LeagueRunner::save(const string& path) const {
+    Header header = Header();
+    header.magic = kMagic;
+    header.version = kVersion;
+    header.numBots = static_cast<uint32_t>(_names.size());
+    header.tableSize = static_cast<uint32_t>(_tableSize);
+    header.seed = _seed;
+    header.rounds = static_cast<uint64_t>(_rounds);
+    header.numMatchups = _matchups.size();
+    header.tableHands = _table.tableHands;
+    header.tableSeconds = _table.tableSeconds;
+
+    string temporary = path + ".tmp";
+    FILE* file = fopen(temporary.c_str(), "wb");
+    if (!file) throw runtime_error("Could not write league checkpoint " + path);
+    bool ok = fwrite(&header, sizeof(Header), 1, file) == 1;
+    for (const string& name : _names) {
+        uint32_t length = static_cast<uint32_t>(name.size());
+        ok = ok && fwrite(&length, sizeof(length), 1, file) == 1;
+        ok = ok && fwrite(name.data(), 1, length, file) == length;
+    }
+    ok = ok && fwrite(_table.hands.data(), sizeof(long long), _table.hands.size(), file) == _table.hands.size();
+    ok = ok && fwrite(_table.decisionSeconds.data(), sizeof(double), _table.decisionSeconds.size(), file)
+        == _table.decisionSeconds.size();
+    ok = ok && fwrite(_matchupDeals.data(), sizeof(long long), _matchupDeals.size(), file) == _matchupDeals.size();
+    ok = ok && fwrite(_table.pairings.data(), sizeof(LeagueTable::Pairing), _table.pairings.size(), file)
+        == _table.pairings.size();
+    ok = fclose(file) == 0 && ok;
+    if (!ok || rename(temporary.c_str(), path.c_str()) != 0) {
+        remove(temporary.c_str());
+        throw runtime_error("Failed writing league checkpoint " + path);
+    }
+}
+
+void LeagueRunner::load(const string& path) {
+    schedule();
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) throw runtime_error("Could not read league checkpoint " + path);
+    Header header;
+    bool ok = fread(&header, sizeof(Header), 1, file) == 1 && header.magic == kMagic && header.version == kVersion;
+    bool same = ok && header.numBots == _names.size() && header.tableSize == static_cast<uint32_t>(_tableSize)
+        && header.seed == _seed && header.numMatchups == _matchups.size();
+    for (size_t bot = 0; bot < _names.size() && same; bot++) {
+        uint32_t length = 0;
+        ok = fread(&length, sizeof(length), 1, file) == 1 && length < 4096;
+        string name(ok ? length : 0, '\0');
+        ok = ok && fread(&name[0], 1, length, file) == length;
+        same = ok && name == _names[bot];
+    }
+    LeagueTable table(static_cast<int>(_names.size()));
+    vector<long long> matchupDeals(_matchups.size());
+    if (same) {
+        ok = fread(table.hands.data(), sizeof(long long), table.hands.size(), file) == table.hands.size()
+            && fread(table.decisionSeconds.data(), sizeof(double), table.decisionSeconds.size(), file)
+                == table.decisionSeconds.size()
+            && fread(matchupDeals.data(), sizeof(long long), matchupDeals.size(), file) == matchupDeals.size()
+            && fread(table.pairings.data(), sizeof(LeagueTable::Pairing), table.pairings.size(), file)
+                == table.pairings.size()
+            && fgetc(file) == EOF;
+    }
+    fclose(file);
+    if (!ok) throw runtime_error("Malformed league checkpoint " + path);
+    if (!same) throw runtime_error("League checkpoint " + path + " is for other bots, table size or seed");
+
+    table.tableHands = header.tableHands;
+    table.tableSeconds = header.tableSeconds;
+    _table = table;
+    _matchupDeals = matchupDeals;
+    _rounds = static_cast<int>(header.rounds);
+}
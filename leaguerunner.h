@@ -0,0 +1,111 @@
+#ifndef LEAGUERUNNER_H
+#define LEAGUERUNNER_H
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include "duplicatematch.h"
+#include "ruleset.h"
+#include "workerpool.h"
+
+// What a league has measured, in a form that adds up: every worker fills its own and the
+// runner merges them after each round, and a checkpoint is one of these on disk.
+class LeagueTable
+{
+public:
+    // One pair of bots from the first one's side, over the duplicate deals they shared a table.
+    struct Pairing {
+        long long deals;
+        double wins;          // deals the first came out ahead, ties counting half
+        double sum;           // first less second, bb/100
+        double squares;
+    };
+
+    explicit LeagueTable(int numBots = 0);
+
+    void addDeal(int first, int second, double difference);   // updates both sides
+    void merge(const LeagueTable& other);
+    const Pairing& getPairing(int first, int second) const;
+    // hands per second of the bot's own decisions; 0 before it has played
+    double getHandsPerSecond(int bot) const;
+
+    int numBots;
+    std::vector<Pairing> pairings;        // [first * numBots + second]
+    std::vector<long long> hands;         // per bot
+    std::vector<double> decisionSeconds;  // per bot, time inside makeDecision
+    long long tableHands;
+    double tableSeconds;                  // wall time of the tables, decisions included
+};
+
+// Round robin over many bots. Every matchup - each pair, or each combination of a larger table
+// size - plays duplicate deals (DuplicateMatch's rotations, all-ins on expected value) from the
+// same deal seeds, so all matchups see the same cards. A round gives every matchup the same
+// number of new deals, cut into jobs sized from the measured speed of the bots involved and
+// handed out longest first across the worker pool. Workers keep their own LeagueTable; the
+// round's tables are merged into the league's, and the checkpoint file, when set, is rewritten.
+//
+// Ratings are Bradley-Terry on the deal results, each pair of bots at a table scoring the deal
+// as a win, loss or tie, fitted by Newton's method with one win and one loss against an
+// average bot as prior. Elo scale about the league mean; errors are one standard deviation of
+// each centred rating, from the inverse Hessian.
+class LeagueRunner
+{
+public:
+    struct Rating {
+        std::string name;
+        double elo;
+        double error;
+        double bbPer100;      // mean margin per deal against the bots it met
+        long long deals;
+        double handsPerSecond;
+    };
+
+    explicit LeagueRunner(const RuleSet& rules, int numThreads = 0);   // 0 = one per hardware thread
+
+    void addBot(const std::string& name, DuplicateMatch::Entrant bot);
+    void setTableSize(int seats);                             // 2 (the default) plays heads-up
+    void setSchedule(int dealsPerRound, double jobSeconds = 0.25);
+    void setSeed(uint64_t seed);
+    // Saved after every round. If the file exists it is loaded now and the league resumes from
+    // it, so the bots, table size and seed must be set up as when it was written.
+    void setCheckpoint(const std::string& path);
+
+    // Plays rounds until this many are complete, counting any resumed from the checkpoint.
+    // Game output is silenced meanwhile.
+    void run(int rounds);
+
+    int getRounds() const;
+    const LeagueTable& getTable() const;
+    std::vector<Rating> getRatings() const;   // best first
+    void print(std::ostream& out) const;
+
+private:
+    struct Job {
+        int matchup;
+        long long firstDeal;
+        int deals;
+        double cost;          // estimated seconds
+    };
+
+    RuleSet _rules;
+    WorkerPool _pool;
+    std::vector<std::string> _names;
+    std::vector<DuplicateMatch::Entrant> _bots;
+    int _tableSize;
+    int _dealsPerRound;
+    double _jobSeconds;
+    uint64_t _seed;
+    std::string _checkpoint;
+    int _rounds;
+    std::vector<std::vector<int>> _matchups;   // bot indices by seat
+    std::vector<long long> _matchupDeals;
+    LeagueTable _table;
+
+    void schedule();          // builds the matchups once the bots are known
+    double getHandSeconds(const std::vector<int>& bots) const;
+    void playJob(const Job& job, LeagueTable& table) const;
+    void save(const std::string& path) const;
+    void load(const std::string& path);
+};
+
+#endif // LEAGUERUNNER_H
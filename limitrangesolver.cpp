@@ -0,0 +1,312 @@
+#include "limitrangesolver.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+using namespace std;
+
+namespace {
+
+const int kCombos = HandCombos::kNumCombos;
+
+}
+
+LimitRangeSolver::LimitRangeSolver(const RuleSet& rules, const uint8_t* board, int boardSize, int pot,
+                                   const float* bigBlindRange, const float* buttonRange, int numThreads)
+    : LimitRangeSolver(rules, PublicTree::buildFixedLimit(rules, board, boardSize, pot, rules.getStartingChips()),
+                       bigBlindRange, buttonRange, numThreads) {
+}
+
+LimitRangeSolver::LimitRangeSolver(const RuleSet& rules, PublicTree tree, const float* bigBlindRange,
+                                   const float* buttonRange, int numThreads)
+    : LimitRangeSolver(rules, move(tree), bigBlindRange, buttonRange, make_unique<WorkerPool>(numThreads), nullptr) {
+}
+
+LimitRangeSolver::LimitRangeSolver(const RuleSet& rules, PublicTree tree, const float* bigBlindRange,
+                                   const float* buttonRange, WorkerPool& pool)
+    : LimitRangeSolver(rules, move(tree), bigBlindRange, buttonRange, nullptr, &pool) {
+}
+
+LimitRangeSolver::LimitRangeSolver(const RuleSet& rules, PublicTree tree, const float* bigBlindRange,
+                                   const float* buttonRange, unique_ptr<WorkerPool> ownedPool, WorkerPool* pool)
+    : _rules(rules),
+    _tree(move(tree)),
+    _ownedPool(move(ownedPool)),
+    _pool(pool ? pool : _ownedPool.get()),
+    _maxActions(1),
+    _iterations(0),
+    _iterationsPerSecond(0.0) {
+    if (rules.getBettingType() != BettingStructure::FIXED_LIMIT) {
+        throw runtime_error("LimitRangeSolver needs fixed-limit rules");
+    }
+    const PublicTree::Node& root = _tree.getNode(0);
+    uint64_t boardMask = HandCombos::getMask(root.board, root.boardSize);
+    const float* ranges[2] = {bigBlindRange, buttonRange};
+    for (int player = 0; player < 2; player++) {
+        _ranges[player].assign(kCombos, 0.0f);
+        for (int combo = 0; combo < kCombos; combo++) {
+            if (!(HandCombos::getMask(combo) & boardMask)) _ranges[player][combo] = max(ranges[player][combo], 0.0f);
+        }
+    }
+    size_t cells = static_cast<size_t>(_tree.getNumActionSlots()) * kCombos;
+    _regrets.assign(cells, 0.0f);
+    _strategySums.assign(cells, 0.0f);
+    _vectors.assign(_tree.getNodes().size() * kCombos, 0.0f);
+    for (int index = 0; index < static_cast<int>(_tree.getNodes().size()); index++) {
+        const PublicTree::Node& node = _tree.getNode(index);
+        if (node.type == PublicTree::kFold || node.type == PublicTree::kShowdown) _terminals.push_back(index);
+        if (node.type == PublicTree::kDecision) _maxActions = max(_maxActions, node.numChildren);
+    }
+
+    _riverBoards.resize(_tree.getNumRiverBoards());
+    _pool->parallelFor(_tree.getNumRiverBoards(), [&](int begin, int end) {
+        for (int index = begin; index < end; index++) {
+            RangeEvaluator::rankBoard(_tree.getRiverBoard(index), _riverBoards[index]);
+        }
+    });
+}
+
+void LimitRangeSolver::solve(int iterations) {
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) iterate();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    _iterationsPerSecond = seconds > 0.0 ? iterations / seconds : 0.0;
+    cout << "CFR+: " << iterations << " iterations in " << seconds << " s ("
+         << _iterationsPerSecond << " it/s), " << _iterations << " total, "
+         << _tree.getNodes().size() << " public nodes" << endl;
+}
+
+int LimitRangeSolver::solveFor(double seconds) {
+    auto start = chrono::steady_clock::now();
+    int iterations = 0;
+    double elapsed = 0.0;
+    while (elapsed < seconds) {
+        iterate();
+        iterations++;
+        elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+    _iterationsPerSecond = elapsed > 0.0 ? iterations / elapsed : 0.0;
+    return iterations;
+}
+
+void LimitRangeSolver::iterate() {
+    _iterations++;
+    for (int traverser = 0; traverser < 2; traverser++) walk(traverser, false);
+}
+
+// Leaves the traverser's values at the root in getVector(0).
+void LimitRangeSolver::walk(int traverser, bool bestResponse) {
+    // a best response replies to the opponent's average strategy; CFR+ iterates on the current one
+    _pool->parallelFor(kCombos, [&](int begin, int end) {
+        reachDown(1 - traverser, bestResponse, true, begin, end);
+    });
+
+    // terminals turn the opponent's reach into the traverser's values, one terminal at a time
+    int terminals = static_cast<int>(_terminals.size());
+    atomic<int> next(0);
+    _pool->run([&](int /*worker*/) {
+        vector<float> reach(kCombos);
+        for (int i = next++; i < terminals; i = next++) {
+            const PublicTree::Node& node = _tree.getNode(_terminals[i]);
+            float* values = getVector(_terminals[i]);
+            copy(values, values + kCombos, reach.begin());
+            if (node.type == PublicTree::kFold) {
+                foldValues(node, traverser, reach.data(), values);
+            } else {
+                showdownValues(node, traverser, reach.data(), values);
+            }
+        }
+    });
+
+    _pool->parallelFor(kCombos, [&](int begin, int end) {
+        if (!bestResponse) reachDown(traverser, false, false, begin, end);
+        valuesUp(traverser, bestResponse, begin, end);
+    });
+}
+
+// One player's reach at every node for combos [begin, end), from its range at the root. Terminals
+// get theirs only when toTerminals is set: otherwise they already hold values.
+void LimitRangeSolver::reachDown(int player, bool average, bool toTerminals, int begin, int end) {
+    copy(_ranges[player].begin() + begin, _ranges[player].begin() + end, getVector(0) + begin);
+    vector<float> strategy(static_cast<size_t>(_maxActions) * kCombos);
+    int nodes = static_cast<int>(_tree.getNodes().size());
+    for (int index = 0; index < nodes; index++) {
+        const PublicTree::Node& node = _tree.getNode(index);
+        if (node.type == PublicTree::kFold || node.type == PublicTree::kShowdown) continue;
+        const float* reach = getVector(index);
+        bool acting = node.type == PublicTree::kDecision && node.player == player;
+        if (acting) getStrategy(node, average, begin, end, strategy.data());
+        for (int child = 0; child < node.numChildren; child++) {
+            const PublicTree::Node& next = _tree.getNode(node.firstChild + child);
+            if (!toTerminals && (next.type == PublicTree::kFold || next.type == PublicTree::kShowdown)) continue;
+            float* out = getVector(node.firstChild + child);
+            if (node.type == PublicTree::kChance) {
+                uint64_t cardBit = 1ull << next.dealtCard;
+                for (int combo = begin; combo < end; combo++) {
+                    out[combo] = (HandCombos::getMask(combo) & cardBit) ? 0.0f : reach[combo];
+                }
+            } else if (acting) {
+                const float* sigma = &strategy[static_cast<size_t>(child) * kCombos];
+                for (int combo = begin; combo < end; combo++) out[combo] = reach[combo] * sigma[combo];
+            } else {
+                copy(reach + begin, reach + end, out + begin);
+            }
+        }
+    }
+}
+
+// The traverser's values for combos [begin, end), leaves first; each node's reach is replaced by
+// its values once used. Without bestResponse this is also the CFR+ update of the traverser's
+// regrets and strategy sums.
+void LimitRangeSolver::valuesUp(int traverser, bool bestResponse, int begin, int end) {
+    vector<float> strategy(static_cast<size_t>(_maxActions) * kCombos);
+    for (int index = static_cast<int>(_tree.getNodes().size()) - 1; index >= 0; index--) {
+        const PublicTree::Node& node = _tree.getNode(index);
+        float* values = getVector(index);
+        int children = node.numChildren;
+        if (node.type == PublicTree::kFold || node.type == PublicTree::kShowdown) continue;
+
+        // every child deals one card; a pair of hands sees 52 - board - 4 of them, each equally likely
+        if (node.type == PublicTree::kChance) {
+            float weight = 1.0f / (52 - node.boardSize - 4);
+            fill(values + begin, values + end, 0.0f);
+            for (int child = 0; child < children; child++) {
+                uint64_t cardBit = 1ull << _tree.getNode(node.firstChild + child).dealtCard;
+                const float* out = getVector(node.firstChild + child);
+                for (int combo = begin; combo < end; combo++) {
+                    if (!(HandCombos::getMask(combo) & cardBit)) values[combo] += weight * out[combo];
+                }
+            }
+            continue;
+        }
+
+        if (node.player != traverser) {
+            fill(values + begin, values + end, 0.0f);
+            for (int child = 0; child < children; child++) {
+                const float* out = getVector(node.firstChild + child);
+                for (int combo = begin; combo < end; combo++) values[combo] += out[combo];
+            }
+            continue;
+        }
+        if (bestResponse) {
+            const float* first = getVector(node.firstChild);
+            copy(first + begin, first + end, values + begin);
+            for (int child = 1; child < children; child++) {
+                const float* out = getVector(node.firstChild + child);
+                for (int combo = begin; combo < end; combo++) values[combo] = max(values[combo], out[combo]);
+            }
+            continue;
+        }
+
+        // CFR+: strategy averaged with linearly growing weights, regrets floored at zero
+        getStrategy(node, false, begin, end, strategy.data());
+        float weight = static_cast<float>(_iterations);
+        for (int action = 0; action < children; action++) {
+            float* sums = &_strategySums[static_cast<size_t>(node.data + action) * kCombos];
+            const float* sigma = &strategy[static_cast<size_t>(action) * kCombos];
+            for (int combo = begin; combo < end; combo++) sums[combo] += weight * values[combo] * sigma[combo];
+        }
+        fill(values + begin, values + end, 0.0f);
+        for (int action = 0; action < children; action++) {
+            const float* sigma = &strategy[static_cast<size_t>(action) * kCombos];
+            const float* out = getVector(node.firstChild + action);
+            for (int combo = begin; combo < end; combo++) values[combo] += sigma[combo] * out[combo];
+        }
+        for (int action = 0; action < children; action++) {
+            float* regrets = &_regrets[static_cast<size_t>(node.data + action) * kCombos];
+            const float* out = getVector(node.firstChild + action);
+            for (int combo = begin; combo < end; combo++) {
+                regrets[combo] = max(regrets[combo] + out[combo] - values[combo], 0.0f);
+            }
+        }
+    }
+}
+
+float* LimitRangeSolver::getVector(int node) {
+    return &_vectors[static_cast<size_t>(node) * kCombos];
+}
+
+void LimitRangeSolver::getStrategy(const PublicTree::Node& node, bool average, int begin, int end,
+                                   float* strategy) const {
+    const float* source = (average ? _strategySums : _regrets).data() + static_cast<size_t>(node.data) * kCombos;
+    int actions = node.numChildren;
+    float totals[kCombos] = {0};
+    for (int action = 0; action < actions; action++) {
+        const float* row = source + static_cast<size_t>(action) * kCombos;
+        for (int combo = begin; combo < end; combo++) totals[combo] += row[combo];
+    }
+    float uniform = 1.0f / actions;
+    for (int action = 0; action < actions; action++) {
+        const float* row = source + static_cast<size_t>(action) * kCombos;
+        float* out = strategy + static_cast<size_t>(action) * kCombos;
+        for (int combo = begin; combo < end; combo++) {
+            out[combo] = totals[combo] > 0.0f ? row[combo] / totals[combo] : uniform;
+        }
+    }
+}
+
+void LimitRangeSolver::foldValues(const PublicTree::Node& node, int traverser, const float* reachOpponent,
+                                  float* values) const {
+    float payoff = node.player == traverser ? -node.contributions[traverser]
+                                            : static_cast<float>(node.contributions[1 - traverser]);
+    RangeEvaluator::foldValues(payoff, reachOpponent, values);
+}
+
+void LimitRangeSolver::showdownValues(const PublicTree::Node& node, int traverser, const float* reachOpponent,
+                                      float* values) const {
+    RangeEvaluator::showdownValues(_riverBoards[node.data], static_cast<float>(node.contributions[traverser]),
+                                   reachOpponent, values);
+}
+
+double LimitRangeSolver::getExploitability() {
+    double gain = 0.0;
+    for (int player = 0; player < 2; player++) {
+        walk(player, true);
+        const float* values = getVector(0);
+        for (int combo = 0; combo < kCombos; combo++) gain += _ranges[player][combo] * values[combo];
+    }
+
+    // number of (big blind, button) hand pairs the ranges deal, weighted
+    float total;
+    float cardSums[52];
+    RangeEvaluator::blockedTotals(_ranges[1].data(), total, cardSums);
+    double pairs = 0.0;
+    for (int combo = 0; combo < kCombos; combo++) {
+        const uint8_t* cards = HandCombos::getCards(combo);
+        pairs += _ranges[0][combo] * (total - cardSums[cards[0]] - cardSums[cards[1]] + _ranges[1][combo]);
+    }
+    if (pairs <= 0.0) return 0.0;
+    return gain / 2.0 / pairs / _rules.getBigBlind() * 1000.0;
+}
+
+int LimitRangeSolver::getIterations() const {
+    return _iterations;
+}
+
+double LimitRangeSolver::getIterationsPerSecond() const {
+    return _iterationsPerSecond;
+}
+
+const PublicTree& LimitRangeSolver::getTree() const {
+    return _tree;
+}
+
+void LimitRangeSolver::getAverageStrategy(int node, int combo, float* probabilities) const {
+    const PublicTree::Node& info = _tree.getNode(node);
+    float total = 0.0f;
+    for (int action = 0; action < info.numChildren; action++) {
+        total += _strategySums[static_cast<size_t>(info.data + action) * kCombos + combo];
+    }
+    for (int action = 0; action < info.numChildren; action++) {
+        float sum = _strategySums[static_cast<size_t>(info.data + action) * kCombos + combo];
+        probabilities[action] = total > 0.0f ? sum / total : 1.0f / info.numChildren;
+    }
+}
+
+size_t LimitRangeSolver::getBytes() const {
+    return (_regrets.size() + _strategySums.size() + _vectors.size()) * sizeof(float)
+           + _tree.getNodes().size() * sizeof(PublicTree::Node);
+}
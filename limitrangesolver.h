@@ -0,0 +1,89 @@
+#ifndef LIMITRANGESOLVER_H
+#define LIMITRANGESOLVER_H
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "ruleset.h"
+#include "publictree.h"
+#include "handcombos.h"
+#include "rangeevaluator.h"
+#include "workerpool.h"
+
+// CFR+ over a fixed-limit PublicTree with a full 1326-combo vector per node instead of
+// sampled hands: every iteration walks the whole tree once per player, carrying the
+// opponent's reach for each combo down and a counterfactual value for each combo up.
+// Showdowns are evaluated in linear time from combos sorted by strength (prefix sums, with
+// per-card sums to take out hands that share a card), folds from the opponent's total reach
+// less the blocked combos.
+//
+// A walk is three passes over the node array, each split across the worker pool: the
+// opponent's reach down the tree by opponent combo, the terminal values by terminal, then the
+// traverser's reach down and values back up by the traverser's own combos. None of them
+// needs chance nodes to share out, so a river spot uses every thread too.
+//
+// The tree is exact - no card or bet abstraction - so it starts from a postflop spot with
+// given ranges. River spots solve in well under a second and turn spots in seconds on a few
+// cores; a flop spot is the full 49 x 48 runout tree and needs memory in the tens of
+// gigabytes (see getBytes).
+class LimitRangeSolver
+{
+public:
+    // ranges: HandCombos::kNumCombos weights each, for the big blind (player 0, first to act)
+    // and the button (player 1). Combos that use a board card are ignored.
+    LimitRangeSolver(const RuleSet& rules, const uint8_t* board, int boardSize, int pot,
+                     const float* bigBlindRange, const float* buttonRange, int numThreads = 0);
+    // The same over a tree built elsewhere, e.g. a depth-limited subgame from the middle of a street.
+    LimitRangeSolver(const RuleSet& rules, PublicTree tree, const float* bigBlindRange, const float* buttonRange,
+                     int numThreads = 0);
+    // On a pool the caller keeps, for solvers built at every decision.
+    LimitRangeSolver(const RuleSet& rules, PublicTree tree, const float* bigBlindRange, const float* buttonRange,
+                     WorkerPool& pool);
+
+    // Runs more CFR+ iterations; prints iterations per second.
+    void solve(int iterations);
+    // Runs iterations until the wall clock says seconds have gone by (none if they already
+    // have) and returns how many. Quiet, for bots that solve at every decision.
+    int solveFor(double seconds);
+    int getIterations() const;
+    double getIterationsPerSecond() const;   // of the last solve() call
+
+    // How much a best response gains against the average strategy, averaged over both
+    // seats, in milli big blinds per hand dealt from the ranges.
+    double getExploitability();
+
+    const PublicTree& getTree() const;
+    // Average strategy for one combo at a decision node, one probability per child.
+    void getAverageStrategy(int node, int combo, float* probabilities) const;
+    size_t getBytes() const;
+
+private:
+    RuleSet _rules;
+    PublicTree _tree;
+    std::unique_ptr<WorkerPool> _ownedPool;
+    WorkerPool* _pool;
+    std::vector<float> _ranges[2];
+    std::vector<float> _regrets;        // per action slot x combo
+    std::vector<float> _strategySums;
+    // per node x combo: a reach on the way down, the traverser's values on the way up
+    std::vector<float> _vectors;
+    std::vector<int> _terminals;
+    int _maxActions;
+    std::vector<RangeEvaluator::Ranking> _riverBoards;
+    int _iterations;
+    double _iterationsPerSecond;
+
+    LimitRangeSolver(const RuleSet& rules, PublicTree tree, const float* bigBlindRange, const float* buttonRange,
+                     std::unique_ptr<WorkerPool> ownedPool, WorkerPool* pool);
+
+    void iterate();
+    void walk(int traverser, bool bestResponse);
+    void reachDown(int player, bool average, bool toTerminals, int begin, int end);
+    void valuesUp(int traverser, bool bestResponse, int begin, int end);
+    float* getVector(int node);
+    void getStrategy(const PublicTree::Node& node, bool average, int begin, int end, float* strategy) const;
+    void foldValues(const PublicTree::Node& node, int traverser, const float* reachOpponent, float* values) const;
+    void showdownValues(const PublicTree::Node& node, int traverser, const float* reachOpponent, float* values) const;
+};
+
+#endif // LIMITRANGESOLVER_H
@@ -0,0 +1,198 @@
+#include "mccfrsolver.h"
+#include "headsupengine.h"
+#include "workerpool.h"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+const int kStreets = 4;
+
+}
+
+// Per-thread scratch for one iteration. The engine deals from its own seeded generator, so
+// every branch of a traversal sees the same cards and a bucket is computed once per street.
+struct MccfrSolver::Traversal {
+    EngineRng rng;
+    int buckets[2][kStreets];
+
+    void clearBuckets() {
+        for (int seat = 0; seat < 2; seat++) {
+            for (int street = 0; street < kStreets; street++) buckets[seat][street] = -1;
+        }
+    }
+};
+
+MccfrSolver::MccfrSolver(const RuleSet& rules, const BetAbstraction& bets, shared_ptr<const CardAbstraction> cards,
+                         StrategyStore::Precision precision)
+    : _rules(rules), _bets(bets), _cards(cards), _iterationsPerSecond(0.0) {
+    if (!_cards) throw runtime_error("MCCFR needs a card abstraction");
+    BettingTree tree(_rules, _bets, *_cards);
+    _store.reset(new StrategyStore(tree, precision, getFingerprint()));
+}
+
+void MccfrSolver::train(long long iterations, int numThreads, uint64_t seed) {
+    if (iterations <= 0) return;
+    if (!_store->isWritable()) throw runtime_error("Strategy was loaded read-only");
+    auto start = chrono::steady_clock::now();
+    switch (_rules.getBettingType()) {
+    case BettingStructure::NO_LIMIT:
+        runIterations<HeadsUpEngine<BettingStructure::NO_LIMIT>>(iterations, numThreads, seed);
+        break;
+    case BettingStructure::POT_LIMIT:
+        runIterations<HeadsUpEngine<BettingStructure::POT_LIMIT>>(iterations, numThreads, seed);
+        break;
+    case BettingStructure::FIXED_LIMIT:
+        runIterations<HeadsUpEngine<BettingStructure::FIXED_LIMIT>>(iterations, numThreads, seed);
+        break;
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    _iterationsPerSecond = seconds > 0.0 ? iterations / seconds : 0.0;
+
+    cout << "MCCFR: " << iterations << " iterations in " << seconds << " s ("
+         << static_cast<long long>(_iterationsPerSecond) << " it/s), "
+         << getIterations() << " total, " << _store->getNumNodes() << " betting nodes, "
+         << _store->getNumCells() << " cells" << endl;
+}
+
+template <typename Engine>
+void MccfrSolver::runIterations(long long iterations, int numThreads, uint64_t seed) {
+    WorkerPool pool(numThreads);
+    atomic<long long> next(0);
+    long long base = getIterations();
+    int startingChips = _rules.getStartingChips();
+
+    pool.run([&](int worker) {
+        Engine table(_rules);
+        Traversal traversal;
+        traversal.rng = EngineRng(EngineRng::mix(seed ^ (static_cast<uint64_t>(worker) + 1) * 0x9E3779B97F4A7C15ull));
+        for (;;) {
+            long long iteration = next.fetch_add(1, memory_order_relaxed);
+            if (iteration >= iterations) break;
+
+            // the deal depends only on the seed and iteration number, not on the thread
+            uint64_t handSeed = EngineRng::mix(seed + static_cast<uint64_t>(base + iteration));
+            table.seed(handSeed);
+            table.setStack(0, startingChips);
+            table.setStack(1, startingChips);
+            table.setButton(static_cast<int>(handSeed & 1));
+            if (!table.startHand()) continue;
+
+            traversal.clearBuckets();
+            for (int traverser = 0; traverser < 2; traverser++) {
+                traverse(table, 0, traverser, traversal);
+            }
+        }
+    });
+    _store->addIterations(static_cast<uint64_t>(iterations));
+}
+
+template <typename Engine>
+double MccfrSolver::traverse(const Engine& table, int node, int traverser, Traversal& traversal) {
+    if (table.isHandOver()) {
+        return static_cast<double>(table.getPayoff(traverser)) / _rules.getBigBlind();
+    }
+    if (node == BettingTree::kNoChild) return 0.0;   // engine and tree disagree; never expected
+
+    const BettingTree::Node& info = _store->getNode(node);
+    int seat = table.getCurrentSeat();
+    int bucket = bucketFor(table, seat, traversal);
+    float strategy[BetAbstraction::kMaxActions];
+    _store->getStrategy(info, bucket, strategy);
+
+    if (seat != traverser) {
+        _store->addStrategy(info, bucket, strategy, traversal.rng);
+        float target = static_cast<float>(traversal.rng.uniform());
+        int pick = -1;
+        for (int action = 0; action < BetAbstraction::kMaxActions; action++) {
+            if (!((info.legalMask >> action) & 1u)) continue;
+            pick = action;
+            target -= strategy[action];
+            if (target <= 0.0f) break;
+        }
+
+        Engine child = table;
+        if (!child.applyAction(_bets.toPlayerAction(child, pick))) return 0.0;
+        return traverse(child, info.children[pick], traverser, traversal);
+    }
+
+    double values[BetAbstraction::kMaxActions] = {0};
+    double nodeValue = 0.0;
+    for (int action = 0; action < BetAbstraction::kMaxActions; action++) {
+        if (!((info.legalMask >> action) & 1u)) continue;
+        Engine child = table;
+        if (!child.applyAction(_bets.toPlayerAction(child, action))) continue;
+        values[action] = traverse(child, info.children[action], traverser, traversal);
+        nodeValue += strategy[action] * values[action];
+    }
+    for (int action = 0; action < BetAbstraction::kMaxActions; action++) values[action] -= nodeValue;
+    _store->addRegrets(info, bucket, values, traversal.rng);
+    return nodeValue;
+}
+
+template <typename Engine>
+int MccfrSolver::bucketFor(const Engine& table, int seat, Traversal& traversal) const {
+    int street = CardAbstraction::getStreet(table.getBoardSize());
+    int& bucket = traversal.buckets[seat][street];
+    if (bucket < 0) bucket = _cards->getBucket(table.getHoleCards(seat), table.getBoard(), table.getBoardSize());
+    return bucket;
+}
+
+long long MccfrSolver::getIterations() const {
+    return static_cast<long long>(_store->getIterations());
+}
+
+double MccfrSolver::getIterationsPerSecond() const {
+    return _iterationsPerSecond;
+}
+
+bool MccfrSolver::getAverageStrategy(int node, int bucket, float* probabilities) const {
+    return _store->getAverageStrategy(_store->getNode(node), bucket, probabilities);
+}
+
+const RuleSet& MccfrSolver::getRules() const {
+    return _rules;
+}
+
+const BetAbstraction& MccfrSolver::getBetAbstraction() const {
+    return _bets;
+}
+
+const CardAbstraction& MccfrSolver::getCardAbstraction() const {
+    return *_cards;
+}
+
+const StrategyStore& MccfrSolver::getStore() const {
+    return *_store;
+}
+
+// Everything the tree and the cell layout depend on: rules, bet sizes, bucket counts.
+uint64_t MccfrSolver::getFingerprint() const {
+    uint64_t hash = EngineRng::mix(static_cast<uint64_t>(_rules.getBettingType()) + 1);
+    hash = EngineRng::mix(hash ^ static_cast<uint64_t>(_rules.getSmallBlind()));
+    hash = EngineRng::mix(hash ^ static_cast<uint64_t>(_rules.getBigBlind()));
+    hash = EngineRng::mix(hash ^ static_cast<uint64_t>(_rules.getStartingChips()));
+    hash = EngineRng::mix(hash ^ static_cast<uint64_t>(_rules.getMaxRaises()));
+    hash = EngineRng::mix(hash ^ static_cast<uint64_t>(_bets.getMaxRaisesPerStreet()));
+    for (double fraction : _bets.getPotFractions()) hash = EngineRng::mix(hash ^ static_cast<uint64_t>(fraction * 1e6));
+    for (int street = 0; street < kStreets; street++) {
+        hash = EngineRng::mix(hash ^ static_cast<uint64_t>(_cards->getNumBuckets(street)));
+    }
+    return hash;
+}
+
+void MccfrSolver::save(const string& path) const {
+    _store->save(path);
+}
+
+void MccfrSolver::load(const string& path, bool readOnly) {
+    unique_ptr<StrategyStore> store(new StrategyStore(path, !readOnly));
+    if (store->getFingerprint() != getFingerprint()) {
+        throw runtime_error(path + " was trained with different rules or abstraction");
+    }
+    _store = move(store);
+}
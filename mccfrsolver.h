@@ -0,0 +1,64 @@
+#ifndef MCCFRSOLVER_H
+#define MCCFRSOLVER_H
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "poker_info.h"
+#include "ruleset.h"
+#include "betabstraction.h"
+#include "bettingtree.h"
+#include "cardabstraction.h"
+#include "strategystore.h"
+
+// External-sampling Monte Carlo CFR for the heads-up game a RuleSet defines (blinds,
+// starting stacks, betting structure), played on HeadsUpEngine with a BetAbstraction for the
+// actions and a CardAbstraction for the cards.
+//
+// One iteration deals a hand and walks it once per player: every action of the traversing
+// player is explored, the opponent's and chance are sampled. Worker threads run iterations
+// concurrently against one StrategyStore. An infoset is a BettingTree node (the abstract
+// betting sequence, which also fixes who acts) plus the acting player's card bucket.
+class MccfrSolver
+{
+public:
+    MccfrSolver(const RuleSet& rules, const BetAbstraction& bets, std::shared_ptr<const CardAbstraction> cards,
+                StrategyStore::Precision precision = StrategyStore::kFloat32);
+
+    // Runs more iterations on top of what is already there; prints iterations per second.
+    void train(long long iterations, int numThreads = 0, uint64_t seed = 0);
+    long long getIterations() const;
+    double getIterationsPerSecond() const;   // of the last train() call
+
+    // Checkpoint / resume. load() maps the file in place of the current strategy after checking
+    // it was trained under this solver's rules and abstraction; a read-only load is for play.
+    void save(const std::string& path) const;
+    void load(const std::string& path, bool readOnly = false);
+
+    // Average strategy over abstract action ids; false if the infoset was never reached.
+    bool getAverageStrategy(int node, int bucket, float* probabilities) const;
+
+    const RuleSet& getRules() const;
+    const BetAbstraction& getBetAbstraction() const;
+    const CardAbstraction& getCardAbstraction() const;
+    const StrategyStore& getStore() const;
+    // identifies the rules + abstraction a strategy is valid for
+    uint64_t getFingerprint() const;
+
+private:
+    struct Traversal;
+
+    RuleSet _rules;
+    BetAbstraction _bets;
+    std::shared_ptr<const CardAbstraction> _cards;
+    std::unique_ptr<StrategyStore> _store;
+    double _iterationsPerSecond;
+
+    template <typename Engine>
+    void runIterations(long long iterations, int numThreads, uint64_t seed);
+    template <typename Engine>
+    double traverse(const Engine& table, int node, int traverser, Traversal& traversal);
+    template <typename Engine>
+    int bucketFor(const Engine& table, int seat, Traversal& traversal) const;
+};
+
+#endif // MCCFRSOLVER_H
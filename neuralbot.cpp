@@ -0,0 +1,115 @@
+#include "neuralbot.h"
+#include "gamemanager.h"
+#include "infostate.h"
+#include "vectorenv.h"
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+NeuralBot::NeuralBot(const string& name, int chips, shared_ptr<const PolicyNetwork> network, int position)
+    : Player(name, chips, position), _network(network), _sampling(false), _rng(0) {
+    if (!_network || _network->getInputSize() != InfoState::kSize
+            || _network->getOutputSize() != VectorEnv::kNumActions) {
+        throw runtime_error("Policy network does not match the InfoState / VectorEnv action layout");
+    }
+}
+
+void NeuralBot::setSampling(bool sampling, unsigned seed) {
+    _sampling = sampling;
+    _rng.seed(seed);
+}
+
+PlayerAction NeuralBot::makeDecision(const Gamestate& gameState, GameManager* /*gameManager*/) {
+    float features[InfoState::kSize];
+    float probabilities[VectorEnv::kNumActions];
+    InfoState::encode(gameState, getSeat(), features);
+    _network->forward(features, probabilities);
+    return choose(gameState, getSeat(), probabilities);
+}
+
+PlayerAction NeuralBot::choose(const Gamestate& gameState, int seat, const float* probabilities) {
+    if (!_sampling) return bestAction(gameState, seat, probabilities);
+
+    uint8_t mask[VectorEnv::kNumActions];
+    getLegalMask(gameState, seat, mask);
+    float total = 0.0f;
+    for (int action = 0; action < VectorEnv::kNumActions; action++) {
+        if (mask[action]) total += probabilities[action];
+    }
+    if (total <= 0.0f) return bestAction(gameState, seat, probabilities);
+
+    float target = uniform_real_distribution<float>(0.0f, total)(_rng);
+    int pick = -1;
+    for (int action = 0; action < VectorEnv::kNumActions; action++) {
+        if (!mask[action]) continue;
+        pick = action;
+        target -= probabilities[action];
+        if (target <= 0.0f) break;
+    }
+    return toPlayerAction(gameState, seat, pick);
+}
+
+PlayerAction NeuralBot::bestAction(const Gamestate& gameState, int seat, const float* probabilities) {
+    uint8_t mask[VectorEnv::kNumActions];
+    getLegalMask(gameState, seat, mask);
+    int pick = -1;
+    for (int action = 0; action < VectorEnv::kNumActions; action++) {
+        if (mask[action] && (pick < 0 || probabilities[action] > probabilities[pick])) pick = action;
+    }
+    return pick < 0 ? PlayerAction(Action::fold) : toPlayerAction(gameState, seat, pick);
+}
+
+void NeuralBot::evaluateBatch(const PolicyNetwork& network, const Gamestate* const* states,
+                              const int* seats, int count, float* probabilities) {
+    thread_local vector<float> features;
+    features.resize(static_cast<size_t>(count) * InfoState::kSize);
+    InfoState::encodeBatch(states, seats, count, features.data());
+    network.forward(features.data(), count, probabilities);
+}
+
+namespace {
+
+// the pot after the seat calls, as VectorEnv measures its sized raises
+int getPotAfterCall(const Gamestate& gameState, int seat) {
+    const SeatState* table = gameState.getSeats();
+    if (!table || seat < 0 || seat >= table->size()) return 0;
+    const SeatState& seats = *table;
+    int pot = 0;
+    for (int other = 0; other < seats.size(); other++) pot += seats.totalBets[other];
+    return pot + gameState.getCurrentBet() - seats.roundBets[seat];
+}
+
+}
+
+void NeuralBot::getLegalMask(const Gamestate& gameState, int seat, uint8_t* mask) {
+    VectorEnv::getLegalMask(gameState.getLegalActions(seat), gameState.getCurrentBet(),
+                            getPotAfterCall(gameState, seat), mask);
+}
+
+PlayerAction NeuralBot::toPlayerAction(const Gamestate& gameState, int seat, int action) {
+    return VectorEnv::toPlayerAction(gameState.getLegalActions(seat), gameState.getCurrentBet(),
+                                     getPotAfterCall(gameState, seat), action);
+}
+
+NeuralPolicy::NeuralPolicy(shared_ptr<const PolicyNetwork> network)
+    : _network(network) {
+    if (!_network || _network->getInputSize() != InfoState::kSize
+            || _network->getOutputSize() != VectorEnv::kNumActions) {
+        throw runtime_error("Policy network does not match the InfoState / VectorEnv action layout");
+    }
+}
+
+void NeuralPolicy::decide(const DecisionRequest* requests, int count, PlayerAction* actions) {
+    _states.resize(count);
+    _seats.resize(count);
+    _probabilities.resize(static_cast<size_t>(count) * VectorEnv::kNumActions);
+    for (int i = 0; i < count; i++) {
+        _states[i] = requests[i].state;
+        _seats[i] = requests[i].seat;
+    }
+    NeuralBot::evaluateBatch(*_network, _states.data(), _seats.data(), count, _probabilities.data());
+    for (int i = 0; i < count; i++) {
+        actions[i] = NeuralBot::bestAction(*_states[i], _seats[i], &_probabilities[static_cast<size_t>(i) * VectorEnv::kNumActions]);
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef NEURALBOT_H
+#define NEURALBOT_H
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+#include "player.h"
+#include "policynetwork.h"
+#include "batchscheduler.h"
+
+class GameManager;
+
+// Plays from a PolicyNetwork trained on the VectorEnv action set: InfoState features in,
+// one probability per VectorEnv::DiscreteAction out. Illegal actions are masked before the
+// pick, which is the arg max by default or a sample when sampling is turned on.
+class NeuralBot : public Player {
+public:
+    NeuralBot(const std::string& name, int chips, std::shared_ptr<const PolicyNetwork> network,
+              int position = -1);
+    PlayerAction makeDecision(const Gamestate& gameState, GameManager* gameManager);
+    void setSampling(bool sampling, unsigned seed = 0);
+
+    // Picks from probabilities already computed for this seat (e.g. by evaluateBatch).
+    PlayerAction choose(const Gamestate& gameState, int seat, const float* probabilities);
+
+    // One network call for many tables: probabilities + i * VectorEnv::kNumActions for states[i].
+    static void evaluateBatch(const PolicyNetwork& network, const Gamestate* const* states,
+                              const int* seats, int count, float* probabilities);
+    // Which discrete actions GameManager would accept right now (1 = legal), and what they
+    // mean, both from Gamestate::getLegalActions through VectorEnv's mapping.
+    static void getLegalMask(const Gamestate& gameState, int seat, uint8_t* mask);
+    static PlayerAction toPlayerAction(const Gamestate& gameState, int seat, int action);
+    // Most probable legal action, fold if nothing is legal.
+    static PlayerAction bestAction(const Gamestate& gameState, int seat, const float* probabilities);
+
+private:
+    std::shared_ptr<const PolicyNetwork> _network;
+    bool _sampling;
+    std::mt19937 _rng;
+};
+
+// The same network as a BatchPolicy: one forward pass per batch, greedy picks.
+class NeuralPolicy : public BatchPolicy
+{
+public:
+    explicit NeuralPolicy(std::shared_ptr<const PolicyNetwork> network);
+    void decide(const DecisionRequest* requests, int count, PlayerAction* actions);
+
+private:
+    std::shared_ptr<const PolicyNetwork> _network;
+    std::vector<const Gamestate*> _states;
+    std::vector<int> _seats;
+    std::vector<float> _probabilities;
+};
+
+#endif // NEURALBOT_H
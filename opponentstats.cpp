@@ -0,0 +1,366 @@
+#include "opponentstats.h"
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "gamestate.h"
+
+using namespace std;
+
+struct OpponentStats::Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t recordBytes;
+    uint32_t reserved;
+    uint64_t capacity;
+    uint64_t count;
+    uint64_t fileSize;
+    uint8_t padding[24];
+};
+
+namespace {
+
+const uint32_t kMagic = 0x534f4b50;   // 'PKOS'
+const uint32_t kVersion = 1;
+const size_t kRecordsOffset = 64;
+const size_t kInitialRecords = 64;
+
+size_t getImageBytes(size_t records) {
+    return kRecordsOffset + records * sizeof(OpponentRecord);
+}
+
+double getRatio(uint32_t part, uint32_t whole) {
+    return whole == 0 ? 0.0 : static_cast<double>(part) / whole;
+}
+
+string getKey(const string& name) {
+    return name.substr(0, OpponentRecord::kNameBytes - 1);
+}
+
+}
+
+uint32_t OpponentRecord::getHands(int position) const {
+    uint32_t total = 0;
+    for (int p = 0; p < kNumPositions; p++) {
+        if (position < 0 || position == p) total += hands[p];
+    }
+    return total;
+}
+
+uint32_t OpponentRecord::getOpportunities(Stat stat, int position) const {
+    uint32_t total = 0;
+    for (int p = 0; p < kNumPositions; p++) {
+        if (position < 0 || position == p) total += opportunities[p][stat];
+    }
+    return total;
+}
+
+uint32_t OpponentRecord::getTaken(Stat stat, int position) const {
+    uint32_t total = 0;
+    for (int p = 0; p < kNumPositions; p++) {
+        if (position < 0 || position == p) total += taken[p][stat];
+    }
+    return total;
+}
+
+uint32_t OpponentRecord::getMoves(Move move, int street, int position) const {
+    uint32_t total = 0;
+    for (int p = 0; p < kNumPositions; p++) {
+        if (position >= 0 && position != p) continue;
+        for (int s = 0; s < kStreets; s++) {
+            if (street < 0 || street == s) total += moves[p][s][move];
+        }
+    }
+    return total;
+}
+
+double OpponentRecord::getRate(Stat stat, int position) const {
+    return getRatio(getTaken(stat, position), getOpportunities(stat, position));
+}
+
+double OpponentRecord::getAggressionFactor(int street, int position) const {
+    uint32_t aggressive = getMoves(kAggressive, street, position);
+    uint32_t calls = getMoves(kCall, street, position);
+    return calls == 0 ? aggressive : static_cast<double>(aggressive) / calls;
+}
+
+OpponentStats::OpponentStats()
+    : _mapping(nullptr), _mappedBytes(0), _fd(-1), _header(nullptr), _records(nullptr), _numSeats(0) {
+    static_assert(sizeof(Header) == kRecordsOffset, "header is 64 bytes on disk");
+    grow(kInitialRecords);
+}
+
+OpponentStats::OpponentStats(const string& path)
+    : _mapping(nullptr), _mappedBytes(0), _fd(-1), _header(nullptr), _records(nullptr), _numSeats(0) {
+    int fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) throw runtime_error("Could not open opponent stats " + path);
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw runtime_error("Could not read opponent stats " + path);
+    }
+    _fd = fd;
+    try {
+        if (info.st_size == 0) {
+            grow(kInitialRecords);
+            return;
+        }
+        size_t bytes = static_cast<size_t>(info.st_size);
+        if (bytes < kRecordsOffset) throw runtime_error("Malformed opponent stats file " + path);
+        map(bytes);
+    } catch (...) {
+        if (_mapping) munmap(_mapping, _mappedBytes);
+        close(fd);
+        throw;
+    }
+
+    bool valid = _header->magic == kMagic && _header->version == kVersion
+                 && _header->recordBytes == sizeof(OpponentRecord) && _header->count <= _header->capacity
+                 && _header->fileSize == _mappedBytes && getImageBytes(_header->capacity) <= _mappedBytes;
+    if (!valid) {
+        munmap(_mapping, _mappedBytes);
+        close(fd);
+        throw runtime_error("Malformed opponent stats file " + path);
+    }
+    for (uint64_t slot = 0; slot < _header->count; slot++) {
+        OpponentRecord& record = _records[slot];
+        record.name[OpponentRecord::kNameBytes - 1] = '\0';
+        _slots[record.name] = static_cast<int>(slot);
+    }
+}
+
+OpponentStats::~OpponentStats() {
+    if (_mapping) munmap(_mapping, _mappedBytes);
+    if (_fd >= 0) close(_fd);
+}
+
+// Maps an image of the given size, keeping what the old one held: a file is extended and
+// mapped again, anonymous memory is copied over.
+void OpponentStats::map(size_t bytes) {
+    void* mapping;
+    if (_fd >= 0) {
+        if (static_cast<size_t>(lseek(_fd, 0, SEEK_END)) < bytes && ftruncate(_fd, static_cast<off_t>(bytes)) != 0) {
+            throw runtime_error("Could not grow opponent stats file");
+        }
+        mapping = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+    } else {
+        mapping = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    }
+    if (mapping == MAP_FAILED) throw runtime_error("Could not map opponent stats");
+    if (_mapping) {
+        if (_fd < 0) memcpy(mapping, _mapping, _mappedBytes);
+        munmap(_mapping, _mappedBytes);
+    }
+    _mapping = mapping;
+    _mappedBytes = bytes;
+    _header = static_cast<Header*>(mapping);
+    _records = reinterpret_cast<OpponentRecord*>(static_cast<char*>(mapping) + kRecordsOffset);
+}
+
+void OpponentStats::grow(size_t records) {
+    map(getImageBytes(records));
+    _header->magic = kMagic;
+    _header->version = kVersion;
+    _header->recordBytes = sizeof(OpponentRecord);
+    _header->capacity = records;
+    _header->fileSize = _mappedBytes;
+}
+
+int OpponentStats::getSlot(const string& name) {
+    string key = getKey(name);
+    auto found = _slots.find(key);
+    if (found != _slots.end()) return found->second;
+
+    if (_header->count == _header->capacity) grow(_header->capacity * 2);
+    int slot = static_cast<int>(_header->count);
+    OpponentRecord& record = _records[slot];
+    memset(&record, 0, sizeof(record));
+    memcpy(record.name, key.data(), key.size());
+    _header->count++;
+    _slots[key] = slot;
+    return slot;
+}
+
+OpponentRecord& OpponentStats::getRecord(int seat) {
+    return _records[_seats[seat].slot];
+}
+
+void OpponentStats::count(int seat, OpponentRecord::Stat stat, bool taken) {
+    OpponentRecord& record = getRecord(seat);
+    int position = _seats[seat].position;
+    record.opportunities[position][stat]++;
+    if (taken) record.taken[position][stat]++;
+}
+
+// Everyone still in when the flop comes gets a chance to go to showdown.
+void OpponentStats::markSawFlop(const Gamestate& state) {
+    _flopSeen = true;
+    const SeatState* seats = state.getSeats();
+    unsigned inHand = seats ? seats->inHandMask() : 0;
+    for (int seat = 0; seat < _numSeats; seat++) {
+        if (_seats[seat].slot < 0 || !((inHand >> seat) & 1u)) continue;
+        _seats[seat].sawFlop = true;
+        getRecord(seat).opportunities[_seats[seat].position][OpponentRecord::kWentToShowdown]++;
+    }
+}
+
+void OpponentStats::startHand(const Gamestate& state, const vector<string>& names) {
+    _numSeats = names.size() < kMaxSeats ? static_cast<int>(names.size()) : kMaxSeats;
+    _preflopRaises = 0;
+    _opener = -1;
+    _aggressor = -1;
+    _flopBets = 0;
+    _continuationBet = false;
+    _flopSeen = false;
+
+    const SeatState* seats = state.getSeats();
+    unsigned dealt = seats ? seats->occupiedMask() & ~seats->sittingOut : ~0u;
+    int dealer = state.getDealerPosition();
+    int smallBlind = state.getSmallBlindPosition();
+    int bigBlind = state.getBigBlindPosition();
+
+    // seats between the big blind and the button, first to act first
+    int others[kMaxSeats];
+    int numOthers = 0;
+    for (int step = 1; step <= _numSeats; step++) {
+        int seat = (bigBlind + step) % _numSeats;
+        if (seat == dealer || seat == smallBlind || seat == bigBlind || !((dealt >> seat) & 1u)) continue;
+        others[numOthers++] = seat;
+    }
+
+    for (int seat = 0; seat < _numSeats; seat++) {
+        SeatHand& hand = _seats[seat];
+        memset(&hand, 0, sizeof(hand));
+        hand.slot = -1;
+        hand.position = -1;
+        if (!((dealt >> seat) & 1u)) continue;
+        if (seat == smallBlind) {
+            hand.position = OpponentRecord::kSmallBlind;
+        } else if (seat == bigBlind) {
+            hand.position = OpponentRecord::kBigBlind;
+        } else if (seat == dealer) {
+            hand.position = OpponentRecord::kButton;
+        }
+    }
+    for (int i = 0; i < numOthers; i++) {
+        int position = OpponentRecord::kMiddle;
+        if (i == numOthers - 1) {
+            position = OpponentRecord::kCutoff;
+        } else if (i * 2 < numOthers - 1) {
+            position = OpponentRecord::kEarly;
+        }
+        _seats[others[i]].position = position;
+    }
+
+    for (int seat = 0; seat < _numSeats; seat++) {
+        SeatHand& hand = _seats[seat];
+        if (hand.position < 0) continue;
+        hand.slot = getSlot(names[seat]);
+        OpponentRecord& record = getRecord(seat);
+        record.hands[hand.position]++;
+        record.opportunities[hand.position][OpponentRecord::kVpip]++;
+        record.opportunities[hand.position][OpponentRecord::kPfr]++;
+    }
+}
+
+// Called before the action takes effect, so the state still shows what the seat faced.
+void OpponentStats::recordAction(const Gamestate& state, int seat, const PlayerAction& action) {
+    if (seat < 0 || seat >= _numSeats || _seats[seat].slot < 0) return;
+    GamePhase street = state.getCurrentPhase();
+    if (street == GamePhase::showdown) return;
+    if (street != GamePhase::preflop && !_flopSeen) markSawFlop(state);
+
+    bool aggressive = action.actionType == Action::bet || action.actionType == Action::raise;
+    const SeatState* seats = state.getSeats();
+    if (action.actionType == Action::all_in && seats) {
+        aggressive = seats->roundBets[seat] + seats->stacks[seat] > state.getCurrentBet();
+    }
+    bool folds = action.actionType == Action::fold;
+    OpponentRecord::Move move = OpponentRecord::kCall;
+    if (aggressive) {
+        move = OpponentRecord::kAggressive;
+    } else if (folds) {
+        move = OpponentRecord::kFold;
+    } else if (action.actionType == Action::check) {
+        move = OpponentRecord::kCheck;
+    }
+
+    SeatHand& hand = _seats[seat];
+    OpponentRecord& record = getRecord(seat);
+    record.moves[hand.position][static_cast<int>(street)][move]++;
+
+    if (street == GamePhase::preflop) {
+        if (!hand.voluntary && (aggressive || move == OpponentRecord::kCall)) {
+            hand.voluntary = true;
+            record.taken[hand.position][OpponentRecord::kVpip]++;
+        }
+        if (_preflopRaises == 1 && seat != _opener && !hand.facedThreeBetChance) {
+            hand.facedThreeBetChance = true;
+            count(seat, OpponentRecord::kThreeBet, aggressive);
+        }
+        if (_preflopRaises == 2 && seat == _opener && !hand.facedFoldToThreeBet) {
+            hand.facedFoldToThreeBet = true;
+            count(seat, OpponentRecord::kFoldToThreeBet, folds);
+        }
+        if (aggressive) {
+            if (!hand.raisedPreflop) {
+                hand.raisedPreflop = true;
+                record.taken[hand.position][OpponentRecord::kPfr]++;
+            }
+            if (_preflopRaises == 0) _opener = seat;
+            _preflopRaises++;
+            _aggressor = seat;
+        }
+    } else if (street == GamePhase::flop) {
+        if (_flopBets == 0 && seat == _aggressor) {
+            count(seat, OpponentRecord::kContinuationBet, aggressive);
+            _continuationBet = aggressive;
+        } else if (_flopBets == 1 && _continuationBet && seat != _aggressor && !hand.facedContinuationBet) {
+            hand.facedContinuationBet = true;
+            count(seat, OpponentRecord::kFoldToContinuationBet, folds);
+        }
+        if (aggressive) _flopBets++;
+    }
+}
+
+void OpponentStats::endHand(const Gamestate& state, unsigned showdownMask, unsigned winnerMask) {
+    // all in before the flop: the board was still run out
+    if (!_flopSeen && state.getCommunityCards().size() >= 3) markSawFlop(state);
+    for (int seat = 0; seat < _numSeats; seat++) {
+        if (_seats[seat].slot < 0 || !((showdownMask >> seat) & 1u)) continue;
+        OpponentRecord& record = getRecord(seat);
+        int position = _seats[seat].position;
+        if (_seats[seat].sawFlop) record.taken[position][OpponentRecord::kWentToShowdown]++;
+        count(seat, OpponentRecord::kWonAtShowdown, (winnerMask >> seat) & 1u);
+    }
+}
+
+const OpponentRecord* OpponentStats::getSeatRecord(int seat) const {
+    if (seat < 0 || seat >= _numSeats || _seats[seat].slot < 0) return nullptr;
+    return &_records[_seats[seat].slot];
+}
+
+int OpponentStats::getSeatPosition(int seat) const {
+    return seat < 0 || seat >= _numSeats ? -1 : _seats[seat].position;
+}
+
+const OpponentRecord* OpponentStats::findRecord(const string& name) const {
+    auto found = _slots.find(getKey(name));
+    return found == _slots.end() ? nullptr : &_records[found->second];
+}
+
+const OpponentRecord* OpponentStats::getRecords() const {
+    return _records;
+}
+
+int OpponentStats::size() const {
+    return static_cast<int>(_header->count);
+}
+
+void OpponentStats::flush() {
+    if (_fd >= 0 && msync(_mapping, _mappedBytes, MS_SYNC) != 0) {
+        throw runtime_error("Could not flush opponent stats");
+    }
+}
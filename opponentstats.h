@@ -0,0 +1,120 @@
+#ifndef OPPONENTSTATS_H
+#define OPPONENTSTATS_H
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "poker_info.h"
+
+class Gamestate;
+
+// Everything tracked about one player, by the position they played from. Plain fixed-size
+// counters, so records sit in a file as they are in memory.
+struct OpponentRecord {
+    enum Stat {
+        kVpip,                  // put money in preflop voluntarily, per hand
+        kPfr,                   // raised preflop, per hand
+        kThreeBet,              // re-raised a single preflop raise, when facing one
+        kFoldToThreeBet,        // folded an open to a re-raise
+        kContinuationBet,       // bet the flop first as the preflop aggressor
+        kFoldToContinuationBet, // folded to that bet
+        kWentToShowdown,        // of hands where they saw the flop
+        kWonAtShowdown,         // of showdowns
+        kNumStats
+    };
+    enum Position { kSmallBlind, kBigBlind, kEarly, kMiddle, kCutoff, kButton, kNumPositions };
+    enum Move { kAggressive, kCall, kCheck, kFold, kNumMoves };
+    static const int kNameBytes = 48;
+    static const int kStreets = 4;
+
+    char name[kNameBytes];
+    uint32_t hands[kNumPositions];
+    uint32_t opportunities[kNumPositions][kNumStats];
+    uint32_t taken[kNumPositions][kNumStats];
+    uint32_t moves[kNumPositions][kStreets][kNumMoves];
+
+    // position -1 sums every position; street -1 every street. 0 when there is no sample.
+    uint32_t getHands(int position = -1) const;
+    uint32_t getOpportunities(Stat stat, int position = -1) const;
+    uint32_t getTaken(Stat stat, int position = -1) const;
+    uint32_t getMoves(Move move, int street = -1, int position = -1) const;
+    double getRate(Stat stat, int position = -1) const;
+    // bets and raises per call
+    double getAggressionFactor(int street = -1, int position = -1) const;
+};
+
+// Streaming opponent statistics for one table. GameManager reports each hand's start, every
+// action (before it is applied) and the end, and the counters move in constant time per
+// event; bots read a seat's record through Gamestate::getOpponentStats in constant time.
+//
+// Records are kept by player name in a memory image - a 64-byte header { 'PKOS', version,
+// record bytes, reserved, capacity, count, fileSize } and the records - that is either
+// anonymous memory or a shared mapping of a file, so counts reach the file as they change and
+// a later session opening the same file picks up where this one stopped. The image doubles
+// when it fills; flush() forces it to disk.
+class OpponentStats
+{
+public:
+    OpponentStats();                                  // in memory only
+    explicit OpponentStats(const std::string& path);  // opens the file, or creates it
+    ~OpponentStats();
+    OpponentStats(const OpponentStats&) = delete;
+    OpponentStats& operator=(const OpponentStats&) = delete;
+
+    // Table events. names has one entry per seat.
+    void startHand(const Gamestate& state, const std::vector<std::string>& names);
+    void recordAction(const Gamestate& state, int seat, const PlayerAction& action);
+    void endHand(const Gamestate& state, unsigned showdownMask, unsigned winnerMask);
+
+    // The record of whoever sits in a seat this hand, or null.
+    const OpponentRecord* getSeatRecord(int seat) const;
+    // Position the seat plays from this hand (an OpponentRecord::Position), -1 if unseated.
+    int getSeatPosition(int seat) const;
+    const OpponentRecord* findRecord(const std::string& name) const;
+    const OpponentRecord* getRecords() const;   // size() of them, in the order first seen
+    int size() const;
+    void flush();
+
+private:
+    struct Header;
+
+    // what the current hand has shown so far, per seat
+    struct SeatHand {
+        int slot;
+        int position;
+        bool voluntary;
+        bool raisedPreflop;
+        bool sawFlop;
+        bool facedThreeBetChance;
+        bool facedFoldToThreeBet;
+        bool facedContinuationBet;
+    };
+
+    static const int kMaxSeats = 32;
+
+    void* _mapping;
+    size_t _mappedBytes;
+    int _fd;                        // -1 in memory
+    Header* _header;
+    OpponentRecord* _records;
+    std::unordered_map<std::string, int> _slots;
+    SeatHand _seats[kMaxSeats];
+    int _numSeats;
+    GamePhase _street;
+    int _preflopRaises;
+    int _opener;                    // first preflop raiser
+    int _aggressor;                 // last preflop raiser
+    int _flopBets;
+    bool _continuationBet;          // the flop's first bet came from the aggressor
+    bool _flopSeen;
+
+    void map(size_t bytes);
+    void grow(size_t records);
+    int getSlot(const std::string& name);
+    OpponentRecord& getRecord(int seat);
+    void count(int seat, OpponentRecord::Stat stat, bool taken);
+    void markSawFlop(const Gamestate& state);
+};
+
+#endif // OPPONENTSTATS_H
@@ -41,6 +41,8 @@ PRE_TARGETDEPS       +=  $${check_version.target}
 # link against libcs106.a, add library headers to search path
 # libcs106 requires libpthread, add link here
 LIBS            +=  -lcs106 -lpthread
+# shm_open lives in librt on older glibc (trajectory ring)
+unix:!macx: LIBS +=  -lrt
 QMAKE_LFLAGS    =   -L$$shell_quote($${SPL_DIR}/lib)
 # put PWD first in search list to allow local copy to shadow if needed
 INCLUDEPATH     +=  $$PWD "$${SPL_DIR}/include"
@@ -73,41 +75,114 @@ DEFINES     +=  main=qMain qMain=studentMain
 # Afterward we glob-add files to SOURCES ourselves. Operator *= will unique
 # entries, so no worries about duplicates
 SOURCES         *=  "" \
+    abstractionbuilder.cpp \
+    agentprotocol.cpp \
     aggrobot.cpp \
+    asyncplayer.cpp \
     balancedbot.cpp \
+    batchscheduler.cpp \
+    bestresponse.cpp \
+    bettingtree.cpp \
+    botstrategy.cpp \
     card.cpp \
+    cardabstraction.cpp \
+    cfrbot.cpp \
     deck.cpp \
+    duplicatematch.cpp \
     gamehistory.cpp \
     gamemanager.cpp \
     gamestate.cpp \
     hand.cpp \
+    handindexer.cpp \
     handstrengthevaluator.cpp \
     infostate.cpp \
+    leaguerunner.cpp \
+    limitrangesolver.cpp \
+    mccfrsolver.cpp \
+    neuralbot.cpp \
+    opponentstats.cpp \
     player.cpp \
+    playstyleclassifier.cpp \
+    policynetwork.cpp \
+    publictree.cpp \
     randombot.cpp \
+    rangeevaluator.cpp \
+    rangetracker.cpp \
+    remotebot.cpp \
+    resolvingbot.cpp \
     ruleset.cpp \
-    tightbot.cpp
+    seatstate.cpp \
+    strategystore.cpp \
+    subgameresolver.cpp \
+    tableengine.cpp \
+    tableexecutor.cpp \
+    tightbot.cpp \
+    trajectoryring.cpp \
+    translationstats.cpp \
+    tuningrunner.cpp \
+    vectorenv.cpp \
+    workerpool.cpp
 HEADERS         *=  "" \
+    abstractionbuilder.h \
+    agentprotocol.h \
     aggrobot.h \
+    asyncplayer.h \
     balancedbot.h \
+    batchscheduler.h \
+    bestresponse.h \
+    betabstraction.h \
+    bettinglimits.h \
+    bettingtree.h \
+    botstrategy.h \
     card.h \
+    cardabstraction.h \
+    cfrbot.h \
     deck.h \
+    duplicatematch.h \
     gamehistory.h \
     gamemanager.h \
     gamestate.h \
+    gamestateview.h \
     hand.h \
+    handcombos.h \
+    handindexer.h \
     handstrengthevaluator.h \
+    headsupengine.h \
     infostate.h \
+    leaguerunner.h \
+    limitrangesolver.h \
+    mccfrsolver.h \
+    neuralbot.h \
+    opponentstats.h \
     player.h \
+    playstyleclassifier.h \
     poker_info.h \
+    policynetwork.h \
+    publictree.h \
     randombot.h \
+    rangeevaluator.h \
+    rangetracker.h \
+    remotebot.h \
+    resolvingbot.h \
     ruleset.h \
-    tightbot.h
+    seatstate.h \
+    strategystore.h \
+    subgameresolver.h \
+    tableengine.h \
+    tableexecutor.h \
+    tightbot.h \
+    trajectoryring.h \
+    translationstats.h \
+    tuningrunner.h \
+    vectorenv.h \
+    workerpool.h
 
 # Gather any .cpp or .h files within the project folder (student/starter code).
 # Second argument true makes search recursive
 SOURCES         *=  $$files(*.cpp, true)
 HEADERS         *=  $$files(*.h, true)
+# tests/ holds standalone checks with their own main(), built by hand (see each file)
+SOURCES         -=  $$files(tests/*.cpp, true)
 
 # Gather resource files (image/sound/etc) from res dir, list under "Other files"
 OTHER_FILES     *=  $$files(res/*, true)
@@ -124,9 +199,8 @@ OTHER_FILES     *=  $$files(*.txt, true)
 
 CONFIG          +=  sdk_no_version_check   # removes spurious warnings on Mac OS X
 
-# MinGW compiler lags, be conservative and use C++11 on all platforms
-# rather than special case
-CONFIG          +=  c++11
+# table engines are held in a std::variant and executor tables are coroutines, so C++20
+CONFIG          +=  c++20
 
 # WARN_ON has -Wall -Wextra, add/remove a few specific warnings
 QMAKE_CXXFLAGS_WARN_ON      +=  -Werror=return-type
@@ -2,115 +2,79 @@
 
 using namespace std;
 
-// handle side pot implementation by making sure to keep track of each players side pots
-
-/*
- *  std::string _name;
-    int _position;
-    int _chips;
-    int _roundBet;
-    int _totalBet;
-    int _action; //-1 = nothing, 0 = folded,  1 = all in, 2 = active, 3 = sitting out, 4 = check, 5 = bet
-    Hand _cards;
- */
+// Seat data (chips, bets, fold/all-in status, cards) is owned by the table's SeatState.
+// Until bindSeat() is called the player just reports its buy-in, and after leaving the table
+// the stack it left with.
 
 Player::Player(const std::string& name, int chips, int position)
-    : _name(name), _chips(chips), _position(position), _roundBet(0), _totalBet(0), _action(2) {
+    : _name(name), _position(position), _buyIn(chips), _seats(nullptr), _seat(-1), _allInAdjustment(0.0) {
 }
 
 Player::~Player(){
 
 }
 
+void Player::bindSeat(SeatState* seats, int seat){
+    if (_seats && !seats) _buyIn = _seats->stacks[_seat];
+    _seats = seats;
+    _seat = seat;
+}
+
+int Player::getSeat() const{
+    return _seat;
+}
+
 bool Player::canAct() const{
-    return _action != 0 && _action != 1 && _action != 3;
+    return _seats && _seats->canAct(_seat);
 }
 
 bool Player::canCall(int amount){
     if (isFolded() || isAllIn()) return false;
 
-    int callAmount = amount - _roundBet;
-    return _chips >= callAmount && callAmount > 0;
+    int callAmount = amount - getRoundBet();
+    return getChips() >= callAmount && callAmount > 0;
 }
 
 bool Player::canRaise(int currentBet, int minRaise){
     if (isFolded() || isAllIn()) return false;
 
-    int raiseAmount = (currentBet - _roundBet) + minRaise;
-    return _chips >= raiseAmount;
+    int raiseAmount = (currentBet - getRoundBet()) + minRaise;
+    return getChips() >= raiseAmount;
 }
 
 bool Player::canCheck(int currentBet){
     if (isFolded() || isAllIn()) return false;
 
-    return _roundBet == currentBet;
+    return getRoundBet() == currentBet;
 }
 
 bool Player::isFolded(){
-    return _action == 0;
+    return _seats && _seats->isFolded(_seat);
 }
 
 bool Player::isAllIn(){
-    return _action == 1;
+    return _seats && _seats->isAllIn(_seat);
 }
 
 int Player::evaluateHand() const {
-    return _cards.getHandRank();
+    return getHand().getHandRank();
 }
 
-int Player::getMaxBet() const{
-    return _chips;
+double Player::getAllInAdjustment() const {
+    return _allInAdjustment;
 }
 
-void Player::fold(){
-    _action = 0;
+void Player::addAllInAdjustment(double chips) {
+    _allInAdjustment += chips;
 }
 
-bool Player::hasActed() const {
-    return _action != 2;  // Assuming 2 = "active/waiting to act"
-}
-
-void Player::setBet(int amount){
-    if (hasEnoughChips(amount)) {
-        _roundBet = amount;
-        _totalBet += amount;
-        deductChips(amount);
-        _action = 5;
-        return;
-    }
-}
-
-void Player::addToBet(int amount){
-    _roundBet += amount;
-    _totalBet += amount;
-    _action = 5;
-    return;
-}
-
-void Player::clearBet(){
-    _roundBet = 0;
-    _totalBet = 0;
-    return;
-}
-
-void Player::check(){
-    _action = 4;
-    return;
-}
-
-void Player::goAllIn(){
-    _roundBet = _chips;
-    _totalBet += _chips;
-    _chips = 0;
-    _action = 1;
-    return;
+int Player::getMaxBet() const{
+    return _seats ? _seats->stacks[_seat] : _buyIn;
 }
 
-void Player::dealtCards(const vector<Card>& cards){
-    for (Card card: cards) {
-        _cards.addCard(card);
-    }
-    return;
+bool Player::hasActed() const {
+    if (!_seats) return false;
+    return ((_seats->acted | _seats->folded | _seats->allIn) >> _seat) & 1u;
 }
 
 std::string Player::getName(){
@@ -122,65 +86,25 @@ int Player::getPosition(){
 }
 
 int Player::getChips(){
-    return _chips;
+    return _seats ? _seats->stacks[_seat] : _buyIn;
 }
 
 const Hand& Player::getHand() const{
-    return _cards;
-}
-
-void Player::clearHand(){
-    _cards.clear();
-    return;
-}
-
-void Player::dealtCard(const Card& card) {
-    _cards.addCard(card);
-}
-
-int Player::getAction(){
-    return _action;
+    static const Hand noCards;
+    return _seats ? _seats->holeCards[_seat] : noCards;
 }
 
 int Player::getRoundBet(){
-    return _roundBet;
-}
-
-void Player::setRoundBet(int amount){
-    _roundBet = amount;
-    return;
-}
-
-void Player::clearRoundBet(){
-    _roundBet = 0;
-    return;
+    return _seats ? _seats->roundBets[_seat] : 0;
 }
 
 int Player::getTotalBet(){
-    return _totalBet;
-}
-
-void Player::addChips(int amount){
-    _chips += amount;
-    return;
-}
-
-bool Player::deductChips(int amount){
-    if (_chips >= amount) {
-        _chips -= amount;
-        return true;
-    }
-    return false;
+    return _seats ? _seats->totalBets[_seat] : 0;
 }
 
 bool Player::hasEnoughChips(int amount){
-    return _chips >= amount;
+    return getChips() >= amount;
 }
 
 void Player::reset(){
-    _cards.clear();
-    _action = 2;
-    _roundBet = 0;
-    _totalBet = 0;
-}                         // Clear folded, allIn, currentBet, hand
-
+}
@@ -4,17 +4,23 @@
 #include "poker_info.h"
 #include "hand.h"
 #include "handstrengthevaluator.h"
+#include "seatstate.h"
 
 class Gamestate;
 
 class GameManager;
 
+// A player is an identity plus a decision policy. Chips, bets, status and hole cards live
+// in the table's SeatState; the getters below read this player's seat from there.
 class Player
 {
 public:
     Player(const std::string& name, int chips, int position = -1);
     ~Player();
     virtual PlayerAction makeDecision(const Gamestate& gameState, GameManager* gameManager) = 0;
+    virtual void reset();                         // per-hand hook for bots that keep their own state
+    void bindSeat(SeatState* seats, int seat);   // null leaves the table, keeping the stack
+    int getSeat() const;
     bool hasActed() const;
     bool canAct() const;
     bool canCall(int amount);
@@ -22,42 +28,28 @@ public:
     bool canCheck(int currentBet);
     bool isFolded();
     bool isAllIn();
-    bool hasActed();
     bool canWinMainPot();
     bool canWinSidePot();
     int getMaxBet() const;
-    void fold();
-    void setBet(int amount);
-    void addToBet(int amount);
-    void check();
-    void goAllIn();
-    void clearHand();
-    void dealtCard(const Card& card);
-    void clearBet();
-    void dealtCards(const std::vector<Card>& cards);
-    void resetCards();
     std::string getName();
     int getPosition();
     int getChips();
     const Hand& getHand() const;
-    int getAction();
     int getRoundBet();
-    void setRoundBet(int amount);
-    void clearRoundBet();
     int getTotalBet();
-    void addChips(int amount);
-    bool deductChips(int amount);
     bool hasEnoughChips(int amount);
     int evaluateHand() const;
-    virtual void reset();                         // Clear folded, allIn, currentBet, hand
+    // Expected less actual chips from all-in runouts, on tables that settle all-ins on EV too;
+    // getChips() plus this is the player's result with the runout luck taken out.
+    double getAllInAdjustment() const;
+    void addAllInAdjustment(double chips);
 private:
     std::string _name;
     int _position;
-    int _chips;
-    int _roundBet;
-    int _totalBet;
-    int _action; //-1 = nothing, 0 = folded,  1 = all in, 2 = active, 3 = sitting out
-    Hand _cards;
+    int _buyIn;         // chips brought to the table, seeds the seat's stack
+    SeatState* _seats;  // null until the player is seated
+    int _seat;
+    double _allInAdjustment;
 
 };
 
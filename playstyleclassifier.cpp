@@ -0,0 +1,225 @@
+#include "playstyleclassifier.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include "gamestate.h"
+#include "workerpool.h"
+
+using namespace std;
+
+namespace {
+
+const int kStyles = PlaystyleClassifier::kNumStyles;
+const int kTendencies = PlaystyleClassifier::kNumTendencies;
+
+// VPIP, PFR, postflop bet-or-raise share of bets, raises and calls, WTSD
+const double kDefaultMeans[kStyles][kTendencies] = {
+    {0.20, 0.16, 0.55, 0.26},   // tight-aggressive
+    {0.34, 0.26, 0.60, 0.28},   // loose-aggressive
+    {0.16, 0.06, 0.30, 0.24},   // tight-passive
+    {0.45, 0.07, 0.25, 0.38},   // loose-passive
+    {0.60, 0.45, 0.75, 0.34},   // maniac
+};
+const double kDefaultWeights[kStyles] = {0.25, 0.15, 0.20, 0.30, 0.10};
+
+const double kMinMean = 0.01;
+const double kMaxMean = 0.99;
+
+void normalize(const double* logs, double* probabilities) {
+    double top = *max_element(logs, logs + kStyles);
+    double total = 0.0;
+    for (int style = 0; style < kStyles; style++) {
+        probabilities[style] = exp(logs[style] - top);
+        total += probabilities[style];
+    }
+    for (int style = 0; style < kStyles; style++) probabilities[style] /= total;
+}
+
+}
+
+PlaystyleClassifier::PlaystyleClassifier(double strength) : _strength(strength) {
+    if (strength <= 0.0) throw runtime_error("Prior strength must be positive");
+    for (int style = 0; style < kStyles; style++) {
+        setPrior(static_cast<Style>(style), kDefaultWeights[style], kDefaultMeans[style]);
+    }
+}
+
+void PlaystyleClassifier::setPrior(Style style, double weight, const double* means) {
+    Prior& prior = _priors[style];
+    prior.weight = weight;
+    for (int tendency = 0; tendency < kTendencies; tendency++) {
+        double mean = min(kMaxMean, max(kMinMean, means[tendency]));
+        prior.alpha[tendency] = mean * _strength;
+        prior.beta[tendency] = (1.0 - mean) * _strength;
+        prior.norm[tendency] = lgamma(_strength) - lgamma(prior.alpha[tendency]) - lgamma(prior.beta[tendency]);
+    }
+}
+
+double PlaystyleClassifier::getWeight(Style style) const {
+    return _priors[style].weight;
+}
+
+double PlaystyleClassifier::getMean(Style style, Tendency tendency) const {
+    return _priors[style].alpha[tendency] / _strength;
+}
+
+double PlaystyleClassifier::getPopulationMean(Tendency tendency) const {
+    double mean = 0.0;
+    double total = 0.0;
+    for (int style = 0; style < kStyles; style++) {
+        mean += _priors[style].weight * _priors[style].alpha[tendency] / _strength;
+        total += _priors[style].weight;
+    }
+    return total > 0.0 ? mean / total : 0.5;
+}
+
+void PlaystyleClassifier::getCounts(const OpponentRecord& record, Tendency tendency, uint32_t& taken, uint32_t& seen) {
+    switch (tendency) {
+    case kVoluntary:
+        taken = record.getTaken(OpponentRecord::kVpip);
+        seen = record.getOpportunities(OpponentRecord::kVpip);
+        break;
+    case kPreflopRaise:
+        taken = record.getTaken(OpponentRecord::kPfr);
+        seen = record.getOpportunities(OpponentRecord::kPfr);
+        break;
+    case kPostflopAggression:
+        taken = 0;
+        seen = 0;
+        for (int street = 1; street < OpponentRecord::kStreets; street++) {
+            uint32_t aggressive = record.getMoves(OpponentRecord::kAggressive, street);
+            taken += aggressive;
+            seen += aggressive + record.getMoves(OpponentRecord::kCall, street);
+        }
+        break;
+    default:
+        taken = record.getTaken(OpponentRecord::kWentToShowdown);
+        seen = record.getOpportunities(OpponentRecord::kWentToShowdown);
+        break;
+    }
+}
+
+// log P(style) + sum of log beta-binomial likelihoods, without the binomial coefficients
+// every style shares
+void PlaystyleClassifier::classify(const OpponentRecord& record, double* probabilities) const {
+    uint32_t taken[kTendencies];
+    uint32_t seen[kTendencies];
+    for (int tendency = 0; tendency < kTendencies; tendency++) {
+        getCounts(record, static_cast<Tendency>(tendency), taken[tendency], seen[tendency]);
+    }
+    double logs[kStyles];
+    for (int style = 0; style < kStyles; style++) {
+        const Prior& prior = _priors[style];
+        double logPosterior = prior.weight > 0.0 ? log(prior.weight) : -INFINITY;
+        for (int tendency = 0; tendency < kTendencies; tendency++) {
+            if (seen[tendency] == 0) continue;
+            double missed = seen[tendency] - taken[tendency];
+            logPosterior += prior.norm[tendency] + lgamma(taken[tendency] + prior.alpha[tendency])
+                            + lgamma(missed + prior.beta[tendency]) - lgamma(seen[tendency] + _strength);
+        }
+        logs[style] = logPosterior;
+    }
+    normalize(logs, probabilities);
+}
+
+bool PlaystyleClassifier::classify(const Gamestate& state, int seat, double* probabilities) const {
+    const OpponentStats* stats = state.getOpponentStats();
+    const OpponentRecord* record = stats ? stats->getSeatRecord(seat) : nullptr;
+    if (!record) {
+        double total = 0.0;
+        for (int style = 0; style < kStyles; style++) total += _priors[style].weight;
+        for (int style = 0; style < kStyles; style++) probabilities[style] = _priors[style].weight / total;
+        return false;
+    }
+    classify(*record, probabilities);
+    return true;
+}
+
+PlaystyleClassifier::Style PlaystyleClassifier::getMostLikely(const OpponentRecord& record) const {
+    double probabilities[kStyles];
+    classify(record, probabilities);
+    return static_cast<Style>(max_element(probabilities, probabilities + kStyles) - probabilities);
+}
+
+double PlaystyleClassifier::getShrunkRate(const OpponentRecord& record, Tendency tendency) const {
+    uint32_t taken;
+    uint32_t seen;
+    getCounts(record, tendency, taken, seen);
+    return (taken + _strength * getPopulationMean(tendency)) / (seen + _strength);
+}
+
+// E step: each record's style posterior. M step: weights are the mean posteriors, and each
+// style's mean the posterior-weighted pooled rate, with the current mean counting as
+// strength pseudo-hands so a style few records support does not collapse.
+int PlaystyleClassifier::train(const OpponentStats& stats, int rounds, int numThreads, int minHands) {
+    vector<int> used;
+    const OpponentRecord* records = stats.getRecords();
+    for (int slot = 0; slot < stats.size(); slot++) {
+        if (records[slot].getHands() >= static_cast<uint32_t>(max(minHands, 1))) used.push_back(slot);
+    }
+    if (used.empty()) return 0;
+
+    WorkerPool pool(numThreads);
+    int workers = pool.size();
+    int count = static_cast<int>(used.size());
+    // per worker and style: posterior mass, then taken and seen per tendency
+    const int stride = 1 + 2 * kTendencies;
+    vector<double> sums(static_cast<size_t>(workers) * kStyles * stride);
+
+    int round = 0;
+    while (round < rounds) {
+        round++;
+        fill(sums.begin(), sums.end(), 0.0);
+        pool.run([&](int worker) {
+            int begin = static_cast<int>(static_cast<long long>(count) * worker / workers);
+            int end = static_cast<int>(static_cast<long long>(count) * (worker + 1) / workers);
+            double* sum = &sums[static_cast<size_t>(worker) * kStyles * stride];
+            double probabilities[kStyles];
+            uint32_t taken[kTendencies];
+            uint32_t seen[kTendencies];
+            for (int i = begin; i < end; i++) {
+                const OpponentRecord& record = records[used[i]];
+                classify(record, probabilities);
+                for (int tendency = 0; tendency < kTendencies; tendency++) {
+                    getCounts(record, static_cast<Tendency>(tendency), taken[tendency], seen[tendency]);
+                }
+                for (int style = 0; style < kStyles; style++) {
+                    double* row = sum + style * stride;
+                    row[0] += probabilities[style];
+                    for (int tendency = 0; tendency < kTendencies; tendency++) {
+                        row[1 + 2 * tendency] += probabilities[style] * taken[tendency];
+                        row[2 + 2 * tendency] += probabilities[style] * seen[tendency];
+                    }
+                }
+            }
+        });
+
+        double change = 0.0;
+        for (int style = 0; style < kStyles; style++) {
+            double total[stride] = {0.0};
+            for (int worker = 0; worker < workers; worker++) {
+                const double* row = &sums[(static_cast<size_t>(worker) * kStyles + style) * stride];
+                for (int i = 0; i < stride; i++) total[i] += row[i];
+            }
+            double means[kTendencies];
+            for (int tendency = 0; tendency < kTendencies; tendency++) {
+                double mean = getMean(static_cast<Style>(style), static_cast<Tendency>(tendency));
+                means[tendency] = (total[1 + 2 * tendency] + _strength * mean) / (total[2 + 2 * tendency] + _strength);
+                change = max(change, fabs(means[tendency] - mean));
+            }
+            double weight = total[0] / count;
+            change = max(change, fabs(weight - _priors[style].weight));
+            setPrior(static_cast<Style>(style), weight, means);
+        }
+        if (change < 1e-6) break;
+    }
+    return round;
+}
+
+const char* PlaystyleClassifier::getName(Style style) {
+    static const char* const names[kStyles] = {
+        "tight-aggressive", "loose-aggressive", "tight-passive", "loose-passive", "maniac"
+    };
+    return style >= 0 && style < kStyles ? names[style] : "unknown";
+}
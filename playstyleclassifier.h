@@ -0,0 +1,61 @@
+#ifndef PLAYSTYLECLASSIFIER_H
+#define PLAYSTYLECLASSIFIER_H
+#include <cstdint>
+#include "opponentstats.h"
+
+class Gamestate;
+
+// Opponent playstyles from OpponentStats records. Each style is a population weight and a
+// Beta prior over four tendencies - how often the player enters the pot, raises before the
+// flop, bets or raises rather than calls after it, and goes to showdown once they see a flop.
+// A record's counts give the posterior over styles in closed form (a beta-binomial likelihood
+// per tendency), so classifying is some sixty lgamma calls, about a microsecond, and can be
+// redone after every action. With few hands the posterior stays near the population weights;
+// getShrunkRate pulls a single frequency toward the population mean the same way.
+//
+// train() refits the weights and means to a whole stats file by expectation-maximisation,
+// spreading each pass over the records across the worker pool.
+class PlaystyleClassifier
+{
+public:
+    enum Style { kTightAggressive, kLooseAggressive, kTightPassive, kLoosePassive, kManiac, kNumStyles };
+    enum Tendency { kVoluntary, kPreflopRaise, kPostflopAggression, kShowdown, kNumTendencies };
+
+    // strength: prior pseudo-hands per tendency; larger keeps styles apart, smaller lets
+    // players drift from them sooner
+    explicit PlaystyleClassifier(double strength = 30.0);   // priors for typical cash-game players
+
+    void setPrior(Style style, double weight, const double* means);   // kNumTendencies means
+    double getWeight(Style style) const;
+    double getMean(Style style, Tendency tendency) const;
+    double getPopulationMean(Tendency tendency) const;
+
+    // Posterior over styles, kNumStyles entries.
+    void classify(const OpponentRecord& record, double* probabilities) const;
+    // For whoever sits in the seat this hand; false, with the population weights, when the
+    // table keeps no stats.
+    bool classify(const Gamestate& state, int seat, double* probabilities) const;
+    Style getMostLikely(const OpponentRecord& record) const;
+    // (taken + strength * population mean) / (seen + strength)
+    double getShrunkRate(const OpponentRecord& record, Tendency tendency) const;
+
+    // Refits weights and means to every record of at least minHands hands, for at most
+    // rounds passes; returns the passes run.
+    int train(const OpponentStats& stats, int rounds = 50, int numThreads = 0, int minHands = 20);
+
+    static const char* getName(Style style);
+    static void getCounts(const OpponentRecord& record, Tendency tendency, uint32_t& taken, uint32_t& seen);
+
+private:
+    struct Prior {
+        double weight;
+        double alpha[kNumTendencies];
+        double beta[kNumTendencies];
+        double norm[kNumTendencies];   // lgamma(alpha + beta) - lgamma(alpha) - lgamma(beta)
+    };
+
+    Prior _priors[kNumStyles];
+    double _strength;
+};
+
+#endif // PLAYSTYLECLASSIFIER_H
@@ -1,6 +1,7 @@
 #ifndef POKER_INFO_H
 #define POKER_INFO_H
 #include <string>
+#include <cstdint>
 
 enum class Action { fold, check, call, bet, raise, all_in};
 enum class GamePhase { preflop, flop, turn, river, showdown};
@@ -11,9 +12,19 @@ struct PlayerAction {
     double confidence; // to be used later for ML seems to be important from what I've seen online
     std::string reasoning;
 
-    PlayerAction(Action action) : actionType(action), amount(0) {}
+    PlayerAction(Action action) : actionType(action), amount(0), confidence(0) {}
 
-    PlayerAction(Action action, int amt) : actionType(action), amount(amt) {}
+    PlayerAction(Action action, int amt) : actionType(action), amount(amt), confidence(0) {}
 };
 
+// One entry of a hand's betting history. Plain data so it can sit in fixed arrays.
+struct ActionRecord {
+    int8_t seat;
+    GamePhase phase;
+    Action actionType;
+    int amount; // same meaning as PlayerAction::amount
+};
+
+const int kMaxActionHistory = 64; // engines stop recording past this many actions in a hand
+
 #endif // POKER_INFO_H
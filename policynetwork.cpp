@@ -0,0 +1,272 @@
+#include "policynetwork.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define POLICY_HAVE_X86 1
+#endif
+
+using namespace std;
+
+namespace {
+
+const uint32_t kMagic = 0x4e4e4b50u;   // "PKNN"
+const uint32_t kVersion = 1;
+const size_t kAlignment = 32;
+
+float dotFloat(const float* a, const float* b, int n) {
+    float sum = 0.0f;
+    for (int i = 0; i < n; i++) sum += a[i] * b[i];
+    return sum;
+}
+
+int32_t dotInt8(const int8_t* a, const int8_t* b, int n) {
+    int32_t sum = 0;
+    for (int i = 0; i < n; i++) sum += static_cast<int32_t>(a[i]) * b[i];
+    return sum;
+}
+
+#ifdef POLICY_HAVE_X86
+__attribute__((target("avx2,fma")))
+float dotFloatAvx2(const float* a, const float* b, int n) {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+    }
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+    }
+    __m256 acc = _mm256_add_ps(acc0, acc1);
+    __m128 half = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+    half = _mm_add_ss(half, _mm_shuffle_ps(half, half, 1));
+    float sum = _mm_cvtss_f32(half);
+    for (; i < n; i++) sum += a[i] * b[i];
+    return sum;
+}
+
+// 32 bytes per step: maddubs wants unsigned x signed, so multiply |a| by b carrying a's
+// sign. Pair sums stay inside int16 because both sides are limited to [-127, 127].
+__attribute__((target("avx2")))
+int32_t dotInt8Avx2(const int8_t* a, const int8_t* b, int n) {
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i acc = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        __m256i pairs = _mm256_maddubs_epi16(_mm256_sign_epi8(va, va), _mm256_sign_epi8(vb, va));
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(pairs, ones));
+    }
+    __m128i half = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4e));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0xb1));
+    int32_t sum = _mm_cvtsi128_si32(half);
+    for (; i < n; i++) sum += static_cast<int32_t>(a[i]) * b[i];
+    return sum;
+}
+
+bool cpuHasAvx2() {
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+}
+#else
+bool cpuHasAvx2() {
+    return false;
+}
+#endif
+
+// picked once; every network in the process uses the same kernels
+struct Kernels {
+    bool avx2;
+    float (*dotFloat)(const float*, const float*, int);
+    int32_t (*dotInt8)(const int8_t*, const int8_t*, int);
+
+    Kernels() : avx2(cpuHasAvx2()), dotFloat(::dotFloat), dotInt8(::dotInt8) {
+#ifdef POLICY_HAVE_X86
+        if (avx2) {
+            dotFloat = dotFloatAvx2;
+            dotInt8 = dotInt8Avx2;
+        }
+#endif
+    }
+};
+
+const Kernels& kernels() {
+    static const Kernels instance;
+    return instance;
+}
+
+size_t alignUp(size_t offset) {
+    return (offset + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+void softmax(float* values, int count) {
+    float top = *max_element(values, values + count);
+    float total = 0.0f;
+    for (int i = 0; i < count; i++) {
+        values[i] = exp(values[i] - top);
+        total += values[i];
+    }
+    for (int i = 0; i < count; i++) values[i] /= total;
+}
+
+}
+
+PolicyNetwork::PolicyNetwork(const string& path)
+    : _path(path), _mapping(nullptr), _mappedBytes(0), _maxWidth(0) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw runtime_error("Could not open policy network " + path);
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw runtime_error("Could not read policy network " + path);
+    }
+    _mappedBytes = static_cast<size_t>(info.st_size);
+    _mapping = _mappedBytes > 0 ? mmap(nullptr, _mappedBytes, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (_mapping == MAP_FAILED) {
+        _mapping = nullptr;
+        throw runtime_error("Could not map policy network " + path);
+    }
+
+    const char* base = static_cast<const char*>(_mapping);
+    const uint32_t* header = reinterpret_cast<const uint32_t*>(base);
+    size_t offset = 16;
+    bool valid = _mappedBytes >= offset && header[0] == kMagic && header[1] == kVersion && header[2] > 0;
+    uint32_t numLayers = valid ? header[2] : 0;
+    const uint32_t* descriptors = reinterpret_cast<const uint32_t*>(base + offset);
+    offset += static_cast<size_t>(numLayers) * 16;
+    valid = valid && offset <= _mappedBytes;
+
+    for (uint32_t i = 0; valid && i < numLayers; i++) {
+        Layer layer;
+        layer.inputs = static_cast<int>(descriptors[i * 4]);
+        layer.outputs = static_cast<int>(descriptors[i * 4 + 1]);
+        layer.activation = static_cast<Activation>(descriptors[i * 4 + 2]);
+        layer.precision = static_cast<Precision>(descriptors[i * 4 + 3]);
+        layer.weights = nullptr;
+        layer.scales = nullptr;
+        layer.quantized = nullptr;
+        valid = layer.inputs > 0 && layer.outputs > 0 && descriptors[i * 4 + 2] <= kSoftmax
+                && descriptors[i * 4 + 3] <= kInt8
+                && (_layers.empty() || _layers.back().outputs == layer.inputs);
+        if (!valid) break;
+
+        size_t rows = static_cast<size_t>(layer.outputs);
+        size_t weightCount = rows * static_cast<size_t>(layer.inputs);
+        offset = alignUp(offset);
+        layer.biases = reinterpret_cast<const float*>(base + offset);
+        offset = alignUp(offset + rows * sizeof(float));
+        if (layer.precision == kInt8) {
+            layer.scales = reinterpret_cast<const float*>(base + offset);
+            offset = alignUp(offset + rows * sizeof(float));
+            layer.quantized = reinterpret_cast<const int8_t*>(base + offset);
+            offset += weightCount;
+        } else {
+            layer.weights = reinterpret_cast<const float*>(base + offset);
+            offset += weightCount * sizeof(float);
+        }
+        valid = offset <= _mappedBytes;
+        _maxWidth = max(_maxWidth, max(layer.inputs, layer.outputs));
+        _layers.push_back(layer);
+    }
+
+    if (!valid) {
+        munmap(_mapping, _mappedBytes);
+        _mapping = nullptr;
+        throw runtime_error("Malformed policy network " + path);
+    }
+}
+
+PolicyNetwork::~PolicyNetwork() {
+    if (_mapping) munmap(_mapping, _mappedBytes);
+}
+
+int PolicyNetwork::getInputSize() const {
+    return _layers.front().inputs;
+}
+
+int PolicyNetwork::getOutputSize() const {
+    return _layers.back().outputs;
+}
+
+int PolicyNetwork::getNumLayers() const {
+    return static_cast<int>(_layers.size());
+}
+
+bool PolicyNetwork::usesAvx2() const {
+    return kernels().avx2;
+}
+
+void PolicyNetwork::forward(const float* inputs, float* outputs) const {
+    forward(inputs, 1, outputs);
+}
+
+void PolicyNetwork::forward(const float* inputs, int batch, float* outputs) const {
+    if (batch <= 0) return;
+    thread_local vector<float> scratch[2];
+    size_t needed = static_cast<size_t>(batch) * _maxWidth;
+    for (vector<float>& buffer : scratch) {
+        if (buffer.size() < needed) buffer.resize(needed);
+    }
+
+    const float* in = inputs;
+    for (size_t i = 0; i < _layers.size(); i++) {
+        float* out = i + 1 == _layers.size() ? outputs : scratch[i & 1].data();
+        runLayer(_layers[i], in, batch, out);
+        in = out;
+    }
+}
+
+// Output rows on the outside so each weight row is pulled into cache once per batch.
+void PolicyNetwork::runLayer(const Layer& layer, const float* in, int batch, float* out) const {
+    const Kernels& k = kernels();
+    int inputs = layer.inputs;
+    int outputs = layer.outputs;
+
+    if (layer.precision == kFloat32) {
+        for (int o = 0; o < outputs; o++) {
+            const float* row = layer.weights + static_cast<size_t>(o) * inputs;
+            for (int b = 0; b < batch; b++) {
+                out[b * outputs + o] = k.dotFloat(row, in + static_cast<size_t>(b) * inputs, inputs) + layer.biases[o];
+            }
+        }
+    } else {
+        thread_local vector<int8_t> quantized;
+        thread_local vector<float> inputScales;
+        quantized.resize(static_cast<size_t>(batch) * inputs);
+        inputScales.resize(batch);
+        for (int b = 0; b < batch; b++) {
+            const float* x = in + static_cast<size_t>(b) * inputs;
+            float largest = 0.0f;
+            for (int i = 0; i < inputs; i++) largest = max(largest, fabs(x[i]));
+            float scale = largest > 0.0f ? largest / 127.0f : 1.0f;
+            int8_t* q = &quantized[static_cast<size_t>(b) * inputs];
+            for (int i = 0; i < inputs; i++) q[i] = static_cast<int8_t>(lrintf(x[i] / scale));
+            inputScales[b] = scale;
+        }
+        for (int o = 0; o < outputs; o++) {
+            const int8_t* row = layer.quantized + static_cast<size_t>(o) * inputs;
+            float rowScale = layer.scales[o];
+            for (int b = 0; b < batch; b++) {
+                int32_t dot = k.dotInt8(row, &quantized[static_cast<size_t>(b) * inputs], inputs);
+                out[b * outputs + o] = dot * rowScale * inputScales[b] + layer.biases[o];
+            }
+        }
+    }
+
+    if (layer.activation == kRelu) {
+        size_t count = static_cast<size_t>(batch) * outputs;
+        for (size_t i = 0; i < count; i++) out[i] = out[i] > 0.0f ? out[i] : 0.0f;
+    } else if (layer.activation == kSoftmax) {
+        for (int b = 0; b < batch; b++) softmax(out + static_cast<size_t>(b) * outputs, outputs);
+    }
+}
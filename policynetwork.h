@@ -0,0 +1,60 @@
+#ifndef POLICYNETWORK_H
+#define POLICYNETWORK_H
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Small dense MLP evaluated on the CPU, weights read straight out of a memory-mapped file.
+// Layers are fp32 or int8 (per-output-row scales, activations quantized per sample on the
+// fly); dot products use AVX2 when the CPU has it and plain loops otherwise.
+//
+// File layout, little endian, every data block starting on a 32-byte boundary:
+//   uint32 magic 'PKNN', uint32 version (1), uint32 numLayers, uint32 reserved
+//   numLayers x { uint32 inputs, uint32 outputs, uint32 activation, uint32 precision }
+//   per layer:  fp32: float biases[outputs], float weights[outputs][inputs]
+//               int8: float biases[outputs], float scales[outputs], int8 weights[outputs][inputs]
+// A weight row is dequantized as weights[o][i] * scales[o]; int8 weights must lie in [-127, 127].
+class PolicyNetwork
+{
+public:
+    enum Activation { kLinear = 0, kRelu = 1, kSoftmax = 2 };
+    enum Precision { kFloat32 = 0, kInt8 = 1 };
+
+    explicit PolicyNetwork(const std::string& path);
+    ~PolicyNetwork();
+    PolicyNetwork(const PolicyNetwork&) = delete;
+    PolicyNetwork& operator=(const PolicyNetwork&) = delete;
+
+    int getInputSize() const;
+    int getOutputSize() const;
+    int getNumLayers() const;
+    bool usesAvx2() const;
+
+    // inputs: batch x getInputSize(), outputs: batch x getOutputSize(). Safe to call from
+    // several threads at once; scratch space is per thread.
+    void forward(const float* inputs, float* outputs) const;
+    void forward(const float* inputs, int batch, float* outputs) const;
+
+private:
+    struct Layer {
+        int inputs;
+        int outputs;
+        Activation activation;
+        Precision precision;
+        const float* biases;
+        const float* weights;       // fp32 layers
+        const float* scales;        // int8 layers
+        const int8_t* quantized;    // int8 layers
+    };
+
+    std::string _path;
+    void* _mapping;
+    size_t _mappedBytes;
+    std::vector<Layer> _layers;
+    int _maxWidth;
+
+    void runLayer(const Layer& layer, const float* in, int batch, float* out) const;
+};
+
+#endif // POLICYNETWORK_H
@@ -0,0 +1,187 @@
+#include "publictree.h"
+#include "bettinglimits.h"
+#include "handcombos.h"
+#include <map>
+#include <stdexcept>
+
+using namespace std;
+
+PublicTree::PublicTree()
+    : _numActionSlots(0) {
+}
+
+PublicTree PublicTree::buildFixedLimit(const RuleSet& rules, const uint8_t* board, int boardSize, int pot, int stack) {
+    Start start;
+    for (int i = 0; i < 5; i++) start.board[i] = i < boardSize ? board[i] : 0;
+    start.boardSize = boardSize;
+    start.contributions[0] = start.contributions[1] = pot / 2;
+    start.roundBets[0] = start.roundBets[1] = 0;
+    start.raises = 0;
+    start.acted[0] = start.acted[1] = false;
+    start.toAct = 0;
+    return buildFixedLimit(rules, start, stack);
+}
+
+PublicTree PublicTree::buildFixedLimit(const RuleSet& rules, const Start& start, int stack, int bettingStreets) {
+    if (start.boardSize < 3 || start.boardSize > 5) throw runtime_error("Public trees start after the flop");
+    if (start.toAct != 0 && start.toAct != 1) throw runtime_error("Public tree start needs a player to act");
+
+    using State = Start;
+
+    struct Builder {
+        PublicTree& tree;
+        int bigBlind;
+        int cap;
+        int stack;
+        int lastBettingBoard;   // board size of the last street with betting
+        map<uint64_t, int> boards;
+
+        int addChildren(int parent, int count) {
+            int first = static_cast<int>(tree._nodes.size());
+            tree._nodes.resize(tree._nodes.size() + count);
+            tree._nodes[parent].firstChild = first;
+            tree._nodes[parent].numChildren = count;
+            return first;
+        }
+
+        void fill(int index, NodeType type, int player, const State& state, Action action, int amount, int card) {
+            Node& node = tree._nodes[index];
+            node.type = type;
+            node.player = player;
+            node.contributions[0] = state.contributions[0];
+            node.contributions[1] = state.contributions[1];
+            node.firstChild = -1;
+            node.numChildren = 0;
+            node.data = -1;
+            node.action = action;
+            node.amount = amount;
+            node.dealtCard = card;
+            for (int i = 0; i < 5; i++) node.board[i] = i < state.boardSize ? state.board[i] : 0;
+            node.boardSize = state.boardSize;
+        }
+
+        void decision(int index, const State& state) {
+            int me = state.toAct;
+            int opponent = 1 - me;
+            int toCall = state.roundBets[opponent] - state.roundBets[me];
+            int raiseTo = BettingLimits<BettingStructure::FIXED_LIMIT>::getMinimumRaise(state.roundBets[opponent], bigBlind);
+            bool canRaise = state.raises < cap && state.contributions[me] + raiseTo - state.roundBets[me] <= stack;
+
+            Action actions[3];
+            int count = 0;
+            if (toCall > 0) {
+                actions[count++] = Action::fold;
+                actions[count++] = Action::call;
+                if (canRaise) actions[count++] = Action::raise;
+            } else {
+                actions[count++] = Action::check;
+                if (canRaise) actions[count++] = Action::bet;
+            }
+            tree._nodes[index].data = tree._numActionSlots;
+            tree._numActionSlots += count;
+            int first = addChildren(index, count);
+
+            for (int i = 0; i < count; i++) {
+                State next = state;
+                int child = first + i;
+                switch (actions[i]) {
+                case Action::fold:
+                    fill(child, kFold, me, next, Action::fold, 0, -1);
+                    break;
+                case Action::check:
+                    next.acted[me] = true;
+                    fill(child, kDecision, opponent, next, Action::check, 0, -1);
+                    if (state.acted[opponent]) {
+                        endStreet(child, next);
+                    } else {
+                        next.toAct = opponent;
+                        decision(child, next);
+                    }
+                    break;
+                case Action::call:
+                    next.contributions[me] += toCall;
+                    next.roundBets[me] += toCall;
+                    fill(child, kDecision, opponent, next, Action::call, toCall, -1);
+                    endStreet(child, next);
+                    break;
+                default:
+                    next.contributions[me] += raiseTo - state.roundBets[me];
+                    next.roundBets[me] = raiseTo;
+                    next.raises++;
+                    next.acted[me] = true;
+                    next.acted[opponent] = false;
+                    next.toAct = opponent;
+                    fill(child, kDecision, opponent, next, actions[i], raiseTo, -1);
+                    decision(child, next);
+                    break;
+                }
+            }
+        }
+
+        // the child slot is already filled in as a decision; turn it into a showdown or a deal
+        void endStreet(int index, const State& state) {
+            Node& node = tree._nodes[index];
+            if (state.boardSize == 5) {
+                node.type = kShowdown;
+                node.player = -1;
+                uint64_t mask = HandCombos::getMask(state.board, 5);
+                auto found = boards.find(mask);
+                if (found == boards.end()) {
+                    found = boards.emplace(mask, static_cast<int>(boards.size())).first;
+                    tree._riverBoards.insert(tree._riverBoards.end(), state.board, state.board + 5);
+                }
+                node.data = found->second;
+                return;
+            }
+            node.type = kChance;
+            node.player = -1;
+            uint64_t used = HandCombos::getMask(state.board, state.boardSize);
+            int first = addChildren(index, 52 - state.boardSize);
+            int child = first;
+            for (int card = 0; card < 52; card++) {
+                if ((used >> card) & 1u) continue;
+                State next = state;
+                next.board[next.boardSize++] = static_cast<uint8_t>(card);
+                next.roundBets[0] = next.roundBets[1] = 0;
+                next.raises = 0;
+                next.acted[0] = next.acted[1] = false;
+                next.toAct = 0;
+                fill(child, kDecision, 0, next, Action::check, 0, card);
+                if (next.boardSize > lastBettingBoard) {
+                    endStreet(child, next);   // past the depth limit: checked down
+                } else {
+                    decision(child, next);
+                }
+                child++;
+            }
+        }
+    };
+
+    PublicTree tree;
+    int lastBettingBoard = bettingStreets > 0 ? start.boardSize + bettingStreets - 1 : 5;
+    Builder builder = {tree, rules.getBigBlind(), rules.getMaxRaises(), stack, lastBettingBoard, map<uint64_t, int>()};
+    tree._nodes.resize(1);
+    builder.fill(0, kDecision, start.toAct, start, Action::check, 0, -1);
+    builder.decision(0, start);
+    return tree;
+}
+
+const vector<PublicTree::Node>& PublicTree::getNodes() const {
+    return _nodes;
+}
+
+const PublicTree::Node& PublicTree::getNode(int index) const {
+    return _nodes[index];
+}
+
+int PublicTree::getNumActionSlots() const {
+    return _numActionSlots;
+}
+
+int PublicTree::getNumRiverBoards() const {
+    return static_cast<int>(_riverBoards.size() / 5);
+}
+
+const uint8_t* PublicTree::getRiverBoard(int index) const {
+    return &_riverBoards[static_cast<size_t>(index) * 5];
+}
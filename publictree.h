@@ -0,0 +1,69 @@
+#ifndef PUBLICTREE_H
+#define PUBLICTREE_H
+#include <cstdint>
+#include <vector>
+#include "poker_info.h"
+#include "ruleset.h"
+
+// Heads-up game tree over public information only: betting decisions, board cards, and the
+// terminals. Private cards are not in the tree; solvers carry a value per HandCombos combo at
+// every node instead. Player 0 is the big blind, who acts first after the flop; player 1 is
+// the button.
+//
+// A node's children sit next to each other at [firstChild, firstChild + numChildren), so a
+// subtree walk touches the node array in order.
+class PublicTree
+{
+public:
+    enum NodeType { kDecision, kChance, kFold, kShowdown };
+
+    struct Node {
+        NodeType type;
+        int player;              // kDecision: to act; kFold: who folded
+        int contributions[2];    // chips each player has put in this hand
+        int firstChild;
+        int numChildren;
+        int data;                // kDecision: first action slot; kShowdown: river board index
+        Action action;           // decision that led here (check for chance children)
+        int amount;              // its raise-to / call amount, as in PlayerAction
+        int dealtCard;           // card that led here from a chance node, -1 otherwise
+        uint8_t board[5];
+        int boardSize;
+    };
+
+    // Where a subgame starts: the board, what each player has put in this hand and on this
+    // street, bets and raises so far on the street, who has acted on it and who is to act.
+    struct Start {
+        uint8_t board[5];
+        int boardSize;
+        int contributions[2];
+        int roundBets[2];
+        int raises;
+        bool acted[2];
+        int toAct;
+    };
+
+    // Fixed-limit betting from a postflop spot: each player has put in pot / 2, the big blind
+    // acts first, bets and raises are RuleSet-sized with getMaxRaises per street, and nobody
+    // puts in more than stack. Streets run to the river. Throws for preflop boards.
+    static PublicTree buildFixedLimit(const RuleSet& rules, const uint8_t* board, int boardSize, int pot, int stack);
+    // The same from any point of a postflop street. With bettingStreets > 0 the tree is depth
+    // limited: after that many streets (counting the one it starts on) the remaining cards are
+    // dealt with no more betting, so the leaves are worth the pot checked down to a showdown.
+    static PublicTree buildFixedLimit(const RuleSet& rules, const Start& start, int stack, int bettingStreets = 0);
+
+    const std::vector<Node>& getNodes() const;
+    const Node& getNode(int index) const;
+    int getNumActionSlots() const;     // sum of numChildren over decision nodes
+    int getNumRiverBoards() const;
+    const uint8_t* getRiverBoard(int index) const;
+
+private:
+    std::vector<Node> _nodes;
+    std::vector<uint8_t> _riverBoards;   // 5 cards each
+    int _numActionSlots;
+
+    PublicTree();
+};
+
+#endif // PUBLICTREE_H
@@ -6,39 +6,39 @@ RandomBot::RandomBot(const std::string& name, int chips, int position)
 }
 
 PlayerAction RandomBot::makeDecision(const Gamestate& gameState, GameManager* gameManager) {
-    std::cout << "  " << getName() << " is making a decision...\n";
+    gameManager->getLog() << "  " << getName() << " is making a decision...\n";
 
     int myIndex = -1;
     auto players = gameManager->getPlayers();
 
-    std::cout << "    Number of players in gameState: " << players.size() << "\n";
-    std::cout << "    My address: " << this << "\n";
+    gameManager->getLog() << "    Number of players in gameState: " << players.size() << "\n";
+    gameManager->getLog() << "    My address: " << this << "\n";
 
     for (int i = 0; i < players.size(); i++) {
-        std::cout << "    Player " << i << " address: " << players[i].get()
+        gameManager->getLog() << "    Player " << i << " address: " << players[i].get()
         << " name: " << players[i]->getName() << "\n";
 
         if (players[i].get() == this) {
             myIndex = i;
-            std::cout << "    MATCH FOUND at index " << i << "\n";
+            gameManager->getLog() << "    MATCH FOUND at index " << i << "\n";
             break;
         }
     }
 
-    std::cout << "    My index: " << myIndex << "\n";
+    gameManager->getLog() << "    My index: " << myIndex << "\n";
 
     if (myIndex != -1) {
         auto legalActions = gameManager->getLegalActions(myIndex);
 
-        std::cout << "    Legal actions: " << legalActions.size() << "\n";
+        gameManager->getLog() << "    Legal actions: " << legalActions.size() << "\n";
 
         for (auto& action : legalActions) {
-            std::cout << "      - " << gameManager->actionToString(action) << "\n";
+            gameManager->getLog() << "      - " << gameManager->actionToString(action) << "\n";
         }
 
         if (!legalActions.empty()) {
             int randomIndex = rand() % legalActions.size();
-            std::cout << "    Choosing: " << gameManager->actionToString(legalActions[randomIndex]) << "\n";
+            gameManager->getLog() << "    Choosing: " << gameManager->actionToString(legalActions[randomIndex]) << "\n";
             return legalActions[randomIndex];
         }
     }
@@ -0,0 +1,103 @@
+#include "rangeevaluator.h"
+#include "handstrengthevaluator.h"
+#include <algorithm>
+#include <utility>
+
+using namespace std;
+
+namespace {
+
+const int kCombos = HandCombos::kNumCombos;
+
+}
+
+void RangeEvaluator::rankBoard(const uint8_t* board, Ranking& ranking) {
+    uint64_t used = HandCombos::getMask(board, 5);
+    vector<pair<int, uint16_t>> ranked;
+    ranked.reserve(kCombos);
+    uint8_t cards[7];
+    for (int i = 0; i < 5; i++) cards[i + 2] = board[i];
+    for (int combo = 0; combo < kCombos; combo++) {
+        if (HandCombos::getMask(combo) & used) continue;
+        cards[0] = HandCombos::getCards(combo)[0];
+        cards[1] = HandCombos::getCards(combo)[1];
+        ranked.emplace_back(HandStrengthEvaluator::rankCards(cards, 7), static_cast<uint16_t>(combo));
+    }
+    sort(ranked.begin(), ranked.end());
+    ranking.order.clear();
+    ranking.ranks.clear();
+    for (const pair<int, uint16_t>& entry : ranked) {
+        ranking.ranks.push_back(entry.first);
+        ranking.order.push_back(entry.second);
+    }
+}
+
+void RangeEvaluator::blockedTotals(const float* reach, float& total, float* cardSums) {
+    total = 0.0f;
+    for (int card = 0; card < 52; card++) cardSums[card] = 0.0f;
+    for (int combo = 0; combo < kCombos; combo++) {
+        if (reach[combo] == 0.0f) continue;
+        const uint8_t* cards = HandCombos::getCards(combo);
+        total += reach[combo];
+        cardSums[cards[0]] += reach[combo];
+        cardSums[cards[1]] += reach[combo];
+    }
+}
+
+// everything the opponent holds minus what shares a card (the combo itself was taken out twice)
+void RangeEvaluator::foldValues(float payoff, const float* reachOpponent, float* values) {
+    float total;
+    float cardSums[52];
+    blockedTotals(reachOpponent, total, cardSums);
+    for (int combo = 0; combo < kCombos; combo++) {
+        const uint8_t* cards = HandCombos::getCards(combo);
+        values[combo] = payoff * (total - cardSums[cards[0]] - cardSums[cards[1]] + reachOpponent[combo]);
+    }
+}
+
+// Walking up the ranking, reach of strictly weaker hands accumulates (in total and per card,
+// to drop the combos sharing a card); walking down, strictly stronger.
+void RangeEvaluator::showdownValues(const Ranking& ranking, float payoff, const float* reachOpponent,
+                                    float* values) {
+    int count = static_cast<int>(ranking.order.size());
+    fill(values, values + kCombos, 0.0f);
+
+    float below = 0.0f;
+    float belowCards[52] = {0};
+    for (int start = 0; start < count;) {
+        int end = start;
+        while (end < count && ranking.ranks[end] == ranking.ranks[start]) end++;
+        for (int i = start; i < end; i++) {
+            const uint8_t* cards = HandCombos::getCards(ranking.order[i]);
+            values[ranking.order[i]] = below - belowCards[cards[0]] - belowCards[cards[1]];
+        }
+        for (int i = start; i < end; i++) {
+            const uint8_t* cards = HandCombos::getCards(ranking.order[i]);
+            float reach = reachOpponent[ranking.order[i]];
+            below += reach;
+            belowCards[cards[0]] += reach;
+            belowCards[cards[1]] += reach;
+        }
+        start = end;
+    }
+
+    float above = 0.0f;
+    float aboveCards[52] = {0};
+    for (int end = count; end > 0;) {
+        int start = end;
+        while (start > 0 && ranking.ranks[start - 1] == ranking.ranks[end - 1]) start--;
+        for (int i = start; i < end; i++) {
+            const uint8_t* cards = HandCombos::getCards(ranking.order[i]);
+            values[ranking.order[i]] -= above - aboveCards[cards[0]] - aboveCards[cards[1]];
+        }
+        for (int i = start; i < end; i++) {
+            const uint8_t* cards = HandCombos::getCards(ranking.order[i]);
+            float reach = reachOpponent[ranking.order[i]];
+            above += reach;
+            aboveCards[cards[0]] += reach;
+            aboveCards[cards[1]] += reach;
+        }
+        end = start;
+    }
+    for (int i = 0; i < count; i++) values[ranking.order[i]] *= payoff;
+}
@@ -0,0 +1,32 @@
+#ifndef RANGEEVALUATOR_H
+#define RANGEEVALUATOR_H
+#include <cstdint>
+#include <vector>
+#include "handcombos.h"
+
+// Terminal values for full-range tree walks (LimitRangeSolver, BestResponse): for every combo
+// of one player, what it wins against an opponent reach vector over HandCombos, leaving out
+// opponent combos that share a card with it. Folds and showdowns both run in linear time -
+// per-card reach sums take out the blocked combos, showdowns walk a strength ranking with
+// prefix sums instead of comparing every pair.
+class RangeEvaluator
+{
+public:
+    // The combos that miss a five-card board, weakest first.
+    struct Ranking {
+        std::vector<uint16_t> order;
+        std::vector<int> ranks;
+    };
+
+    static void rankBoard(const uint8_t* board, Ranking& ranking);
+
+    // Opponent reach in total and per card, for taking out the combos a hand blocks.
+    static void blockedTotals(const float* reach, float& total, float* cardSums);
+
+    // payoff is what the player wins (negative: loses) against each opponent combo.
+    static void foldValues(float payoff, const float* reachOpponent, float* values);
+    // Contributions are equal at a showdown: payoff is what the stronger hand wins.
+    static void showdownValues(const Ranking& ranking, float payoff, const float* reachOpponent, float* values);
+};
+
+#endif // RANGEEVALUATOR_H
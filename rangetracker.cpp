@@ -0,0 +1,254 @@
+#include "rangetracker.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+#include "gamestate.h"
+#include "handstrengthevaluator.h"
+#include "opponentstats.h"
+#include "playstyleclassifier.h"
+
+using namespace std;
+
+namespace {
+
+const int kCombos = HandCombos::kNumCombos;
+const float kNegligible = 1e-30f;
+
+// Chen's formula: the high card, doubled for pairs, plus suitedness and connectedness
+double getChenScore(int first, int second) {
+    static const double kHighCard[13] = {1, 1.5, 2, 2.5, 3, 3.5, 4, 4.5, 5, 6, 7, 8, 10};
+    int high = max(first / 4, second / 4);
+    int low = min(first / 4, second / 4);
+    if (high == low) return max(5.0, 2.0 * kHighCard[high]);
+    static const double kGapPenalty[5] = {0, 1, 2, 4, 5};
+    int gap = high - low - 1;
+    double score = kHighCard[high] - kGapPenalty[min(gap, 4)];
+    if (first % 4 == second % 4) score += 2.0;
+    if (gap <= 1 && high < 10) score += 1.0;
+    return score;
+}
+
+// percentile of each value among the combos given, ties counting half
+void rankPercentiles(vector<pair<int, int>>& values, float* strengths) {
+    sort(values.begin(), values.end());
+    size_t count = values.size();
+    for (size_t begin = 0; begin < count;) {
+        size_t end = begin;
+        while (end < count && values[end].first == values[begin].first) end++;
+        float strength = static_cast<float>((begin + 0.5 * (end - begin)) / count);
+        for (size_t i = begin; i < end; i++) strengths[values[i].second] = strength;
+        begin = end;
+    }
+}
+
+vector<float> makePreflopStrengths() {
+    vector<pair<int, int>> values(kCombos);
+    for (int combo = 0; combo < kCombos; combo++) {
+        const uint8_t* cards = HandCombos::getCards(combo);
+        values[combo] = make_pair(static_cast<int>(getChenScore(cards[0], cards[1]) * 2.0), combo);
+    }
+    vector<float> strengths(kCombos);
+    rankPercentiles(values, strengths.data());
+    return strengths;
+}
+
+float getLogistic(float x) {
+    return 1.0f / (1.0f + exp(-x));
+}
+
+uint64_t getBoardMask(const Gamestate& state, uint8_t* board, int& boardSize) {
+    const vector<Card>& cards = state.getCommunityCards();
+    boardSize = min(static_cast<int>(cards.size()), 5);
+    for (int i = 0; i < boardSize; i++) board[i] = static_cast<uint8_t>(cards[i].getIndex());
+    return HandCombos::getMask(board, boardSize);
+}
+
+}
+
+RangeTracker::ActionModel::ActionModel()
+    : entry(0.2f), raise(0.3f), continuing(0.45f), aggression(0.3f), bluff(0.1f), softness(0.06f), floor(0.02f) {
+}
+
+RangeTracker::RangeTracker() : _numSeats(0), _boardSize(0), _board(0) {
+    for (int seat = 0; seat < kMaxSeats; seat++) setModel(seat, _defaultModel);
+    rankPreflop();
+}
+
+void RangeTracker::setDefaultModel(const ActionModel& model) {
+    _defaultModel = model;
+}
+
+RangeTracker::ActionModel RangeTracker::estimateModel(const PlaystyleClassifier& classifier, const OpponentRecord& record) {
+    ActionModel model;
+    model.entry = static_cast<float>(classifier.getShrunkRate(record, PlaystyleClassifier::kVoluntary));
+    float raises = static_cast<float>(classifier.getShrunkRate(record, PlaystyleClassifier::kPreflopRaise));
+    model.raise = model.entry > 0.0f ? min(1.0f, raises / model.entry) : 0.0f;
+    model.aggression = static_cast<float>(classifier.getShrunkRate(record, PlaystyleClassifier::kPostflopAggression));
+    // folds to continuation bets, shrunk toward the default model over ten pseudo-hands
+    const float pseudoHands = 10.0f;
+    float folds = record.getTaken(OpponentRecord::kFoldToContinuationBet);
+    float seen = record.getOpportunities(OpponentRecord::kFoldToContinuationBet);
+    model.continuing = 1.0f - (folds + pseudoHands * (1.0f - model.continuing)) / (seen + pseudoHands);
+    return model;
+}
+
+// A hand at strength s goes on with probability logistic((s - (1 - share)) / softness) and
+// raises with the same curve at the top share * raise of hands.
+void RangeTracker::setModel(int seat, const ActionModel& model) {
+    Likelihood& likelihood = _likelihoods[seat];
+    float softness = max(model.softness, 1e-3f);
+    for (int street = 0; street < 2; street++) {
+        float share = street == 0 ? model.entry : model.continuing;
+        float raise = street == 0 ? model.raise : model.aggression;
+        float continueLine = 1.0f - share;
+        float raiseLine = 1.0f - share * raise;
+        for (int bin = 0; bin < kBins; bin++) {
+            float strength = (bin + 0.5f) / kBins;
+            float goesOn = getLogistic((strength - continueLine) / softness);
+            float raises = getLogistic((strength - raiseLine) / softness);
+            float probabilities[2][kNumKinds];
+            // nobody has bet: check or bet, with some bluffs from below the line
+            probabilities[0][kAggressive] = min(1.0f, raises + model.bluff * (1.0f - goesOn));
+            probabilities[0][kPassive] = 1.0f - probabilities[0][kAggressive];
+            probabilities[0][kFold] = 0.0f;
+            // facing a bet: fold, call or raise
+            probabilities[1][kAggressive] = raises;
+            probabilities[1][kPassive] = max(0.0f, goesOn - raises);
+            probabilities[1][kFold] = 1.0f - goesOn;
+            for (int facing = 0; facing < 2; facing++) {
+                for (int kind = 0; kind < kNumKinds; kind++) {
+                    likelihood.table[street][facing][kind][bin] =
+                        model.floor + (1.0f - model.floor) * probabilities[facing][kind];
+                }
+            }
+        }
+    }
+}
+
+void RangeTracker::rankPreflop() {
+    static const vector<float> preflop = makePreflopStrengths();
+    for (int combo = 0; combo < kCombos; combo++) {
+        _strengths[combo] = preflop[combo];
+        _bins[combo] = static_cast<uint8_t>(min(kBins - 1, static_cast<int>(preflop[combo] * kBins)));
+    }
+}
+
+// Made-hand rank with the board, as a percentile among the combos the board leaves live.
+void RangeTracker::rankBoard(const uint8_t* board, int boardSize) {
+    uint64_t blocked = HandCombos::getMask(board, boardSize);
+    uint8_t cards[7];
+    copy(board, board + boardSize, cards + 2);
+    vector<pair<int, int>> values;
+    values.reserve(kCombos);
+    for (int combo = 0; combo < kCombos; combo++) {
+        _strengths[combo] = 0.0f;
+        if (HandCombos::getMask(combo) & blocked) continue;
+        const uint8_t* hole = HandCombos::getCards(combo);
+        cards[0] = hole[0];
+        cards[1] = hole[1];
+        values.push_back(make_pair(HandStrengthEvaluator::rankCards(cards, boardSize + 2), combo));
+    }
+    rankPercentiles(values, _strengths);
+    for (int combo = 0; combo < kCombos; combo++) {
+        _bins[combo] = static_cast<uint8_t>(min(kBins - 1, static_cast<int>(_strengths[combo] * kBins)));
+    }
+}
+
+// New board cards: rerank and take the combos they block out of every range.
+void RangeTracker::updateBoard(const Gamestate& state) {
+    uint8_t board[5];
+    int boardSize;
+    uint64_t mask = getBoardMask(state, board, boardSize);
+    if (mask == _board) return;
+    _board = mask;
+    _boardSize = boardSize;
+    if (boardSize >= 3) {
+        rankBoard(board, boardSize);
+    } else {
+        rankPreflop();
+    }
+    for (int combo = 0; combo < kCombos; combo++) {
+        if (!(HandCombos::getMask(combo) & mask)) continue;
+        for (int seat = 0; seat < _numSeats; seat++) _weights[seat][combo] = 0.0f;
+    }
+    for (int seat = 0; seat < _numSeats; seat++) normalize(_weights[seat]);
+}
+
+void RangeTracker::normalize(float* weights) {
+    float total = 0.0f;
+    for (int combo = 0; combo < kCombos; combo++) total += weights[combo];
+    if (total <= 0.0f) return;
+    float scale = 1.0f / total;
+    for (int combo = 0; combo < kCombos; combo++) weights[combo] *= scale;
+}
+
+void RangeTracker::startHand(const Gamestate& state) {
+    const SeatState* seats = state.getSeats();
+    _numSeats = seats ? min(seats->size(), static_cast<int>(kMaxSeats)) : 0;
+    const OpponentStats* stats = state.getOpponentStats();
+    const PlaystyleClassifier* classifier = state.getPlaystyleClassifier();
+    for (int seat = 0; seat < _numSeats; seat++) {
+        fill(_weights[seat], _weights[seat] + kCombos, 1.0f / kCombos);
+        const OpponentRecord* record = stats ? stats->getSeatRecord(seat) : nullptr;
+        setModel(seat, record && classifier ? estimateModel(*classifier, *record) : _defaultModel);
+    }
+    _board = 0;
+    _boardSize = 0;
+    rankPreflop();
+    updateBoard(state);
+}
+
+void RangeTracker::recordAction(const Gamestate& state, int seat, const PlayerAction& action) {
+    if (seat < 0 || seat >= _numSeats || state.getCurrentPhase() == GamePhase::showdown) return;
+    updateBoard(state);
+
+    const SeatState* seats = state.getSeats();
+    int currentBet = state.getCurrentBet();
+    bool facing = currentBet > seats->roundBets[seat];
+    Kind kind = kPassive;
+    if (action.actionType == Action::fold) {
+        kind = kFold;
+    } else if (action.actionType == Action::bet || action.actionType == Action::raise) {
+        kind = kAggressive;
+    } else if (action.actionType == Action::all_in && seats->roundBets[seat] + seats->stacks[seat] > currentBet) {
+        kind = kAggressive;
+    }
+    int street = state.getCurrentPhase() == GamePhase::preflop ? 0 : 1;
+    const float* table = _likelihoods[seat].table[street][facing ? 1 : 0][kind];
+
+    float* weights = _weights[seat];
+    float total = 0.0f;
+    for (int combo = 0; combo < kCombos; combo++) {
+        // combos a long hand has all but ruled out go to zero rather than denormal
+        float weight = weights[combo] * table[_bins[combo]];
+        weights[combo] = weight < kNegligible ? 0.0f : weight;
+        total += weights[combo];
+    }
+    if (total <= 0.0f) return;
+    float scale = 1.0f / total;
+    for (int combo = 0; combo < kCombos; combo++) weights[combo] *= scale;
+}
+
+void RangeTracker::getRange(const Gamestate& state, int seat, float* range, uint64_t deadCards) const {
+    uint8_t board[5];
+    int boardSize;
+    uint64_t dead = getBoardMask(state, board, boardSize) | deadCards;
+    bool tracked = seat >= 0 && seat < _numSeats;
+    float total = 0.0f;
+    for (int combo = 0; combo < kCombos; combo++) {
+        range[combo] = HandCombos::getMask(combo) & dead ? 0.0f : tracked ? _weights[seat][combo] : 1.0f;
+        total += range[combo];
+    }
+    if (total <= 0.0f) return;
+    float scale = 1.0f / total;
+    for (int combo = 0; combo < kCombos; combo++) range[combo] *= scale;
+}
+
+const float* RangeTracker::getWeights(int seat) const {
+    return _weights[seat];
+}
+
+float RangeTracker::getStrength(int combo) const {
+    return _strengths[combo];
+}
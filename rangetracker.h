@@ -0,0 +1,87 @@
+#ifndef RANGETRACKER_H
+#define RANGETRACKER_H
+#include <cstdint>
+#include "handcombos.h"
+#include "poker_info.h"
+
+class Gamestate;
+struct OpponentRecord;
+class PlaystyleClassifier;
+
+// What every seat at a table may hold, as weights over the 1326 HandCombos, narrowed by Bayes'
+// rule on each action: weight *= P(action | combo). The likelihood is a threshold model in
+// the spirit of TightBot - a player continues with roughly the strongest share of hands they
+// are known to play, raises with the top of those, and now and then bets weak hands when
+// nobody has bet - smoothed by a logistic so near misses keep some weight, with a floor so no
+// combo is ever ruled out by the model alone. Strength is a combo's percentile among all
+// combos: by a Chen-style score preflop, by made-hand rank against the board after it.
+//
+// Combo strengths are ranked once per board and shared by every seat; an action is then one
+// table lookup and multiply per combo for the seat that acted, a couple of microseconds.
+// Board cards zero the combos they block when the board changes.
+//
+// GameManager feeds it like OpponentStats - startHand, then each action before it applies -
+// and bots read it through Gamestate::getRangeTracker. Each hand a seat's model comes from its
+// OpponentStats record when the table keeps stats and a PlaystyleClassifier, and from the
+// default model otherwise.
+class RangeTracker
+{
+public:
+    struct ActionModel {
+        float entry;          // share of hands played preflop (VPIP)
+        float raise;          // share of those raised (PFR / VPIP)
+        float continuing;     // share of hands that go on facing a bet after the flop
+        float aggression;     // share of those that bet or raise
+        float bluff;          // chance of betting a hand below the continuing line unopposed
+        float softness;       // logistic width around each line, in percentile
+        float floor;          // least likelihood of any action
+
+        ActionModel();        // a TightBot at its default settings
+    };
+
+    static const int kMaxSeats = 32;
+
+    RangeTracker();
+
+    void setDefaultModel(const ActionModel& model);
+    // Model for a player from their stats, with rates shrunk toward the population.
+    static ActionModel estimateModel(const PlaystyleClassifier& classifier, const OpponentRecord& record);
+
+    void startHand(const Gamestate& state);
+    // Before the action takes effect, so the state still shows the bet the seat faced.
+    void recordAction(const Gamestate& state, int seat, const PlayerAction& action);
+
+    // The seat's range normalized to sum to one, with combos blocked by the state's board or
+    // deadCards (a mask of Card::getIndex bits, e.g. the reader's own hole cards) at zero.
+    void getRange(const Gamestate& state, int seat, float* range, uint64_t deadCards = 0) const;
+    // Raw weights, scaled to sum to one after each update; HandCombos::kNumCombos of them.
+    const float* getWeights(int seat) const;
+    // Strength percentile of a combo on the board last seen.
+    float getStrength(int combo) const;
+
+private:
+    static const int kBins = 64;
+    enum Kind { kPassive, kAggressive, kFold, kNumKinds };
+
+    // likelihood per strength bin: street (preflop, postflop), facing a bet or not, kind
+    struct Likelihood {
+        float table[2][2][kNumKinds][kBins];
+    };
+
+    alignas(64) float _weights[kMaxSeats][HandCombos::kNumCombos];
+    Likelihood _likelihoods[kMaxSeats];
+    float _strengths[HandCombos::kNumCombos];
+    uint8_t _bins[HandCombos::kNumCombos];
+    int _numSeats;
+    int _boardSize;
+    uint64_t _board;
+    ActionModel _defaultModel;
+
+    void setModel(int seat, const ActionModel& model);
+    void updateBoard(const Gamestate& state);
+    void rankPreflop();
+    void rankBoard(const uint8_t* board, int boardSize);
+    void normalize(float* weights);
+};
+
+#endif // RANGETRACKER_H
@@ -0,0 +1,102 @@
+#include "remotebot.h"
+#include "gamemanager.h"
+#include "neuralbot.h"
+#include "randombot.h"
+#include "tableexecutor.h"
+#include "vectorenv.h"
+#include <iostream>
+#include <thread>
+
+using namespace std;
+
+RemoteBot::RemoteBot(const string& name, int chips, shared_ptr<AgentConnection> connection, int position)
+    : AsyncPlayer(name, chips, position), _connection(connection), _state(nullptr), _request(0), _flushed(false) {
+}
+
+void RemoteBot::beginDecision(const Gamestate& gameState, GameManager* /*gameManager*/) {
+    int8_t features[InfoState::kSize];
+    uint8_t mask[VectorEnv::kNumActions];
+    InfoState::encode(gameState, getSeat(), features);
+    NeuralBot::getLegalMask(gameState, getSeat(), mask);
+    uint8_t legalMask = 0;
+    for (int action = 0; action < VectorEnv::kNumActions; action++) {
+        if (mask[action]) legalMask |= static_cast<uint8_t>(1u << action);
+    }
+    _state = &gameState;
+    _request = _connection->submit(features, legalMask, getSeat());
+    _flushed = false;
+}
+
+PlayerAction RemoteBot::makeDecision(const Gamestate& gameState, GameManager* gameManager) {
+    beginDecision(gameState, gameManager);
+    _connection->flush();
+    _flushed = true;
+    return waitForDecision();
+}
+
+bool RemoteBot::pollDecision(PlayerAction& action) {
+    if (_flushed) {
+        _connection->flush();
+    }
+    _flushed = true;
+    _connection->receive();
+
+    int choice = 0;
+    if (!_connection->takeResponse(_request, choice)) return false;
+    action = NeuralBot::toPlayerAction(*_state, getSeat(), choice);
+    return true;
+}
+
+int RemoteBot::getWaitFd() const {
+    return _connection->getFd();
+}
+
+RemoteBenchmarkResult benchmarkRemoteAgent(const string& socketPath, int numTables, int handsPerTable,
+                                           int maxBatch, bool startStandIn) {
+    unique_ptr<AgentServer> server;
+    thread serverThread;
+    if (startStandIn) {
+        server.reset(new AgentServer(socketPath));
+        serverThread = thread([&server]() { server->serve(); });
+    }
+
+    RemoteBenchmarkResult result = {};
+    try {
+        auto connection = make_shared<AgentConnection>(socketPath, maxBatch);
+        TableExecutor executor;
+        for (int table = 0; table < numTables; table++) {
+            auto game = make_shared<GameManager>();
+            game->setVerbose(false);
+            game->addPlayer(make_shared<RemoteBot>("remote", 1000, connection, 0));
+            game->addPlayer(make_shared<RandomBot>("random", 1000, 1));
+            executor.addTable(game, handsPerTable);
+        }
+
+        auto start = chrono::steady_clock::now();
+        executor.run();
+        result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        result.hands = executor.getHandsPlayed();
+        result.decisions = connection->getResponses();
+        result.decisionsPerSecond = result.seconds > 0 ? result.decisions / result.seconds : 0.0;
+        result.meanBatchSize = connection->getFramesSent() > 0
+                ? static_cast<double>(connection->getRequestsSent()) / connection->getFramesSent() : 0.0;
+        result.meanLatencyMicros = connection->getMeanLatencyMicros();
+        result.p50LatencyMicros = connection->getLatencyPercentileMicros(50.0);
+        result.p99LatencyMicros = connection->getLatencyPercentileMicros(99.0);
+    } catch (...) {
+        if (server) {
+            server->stop();
+            serverThread.join();
+        }
+        throw;
+    }
+    if (server) {
+        server->stop();
+        serverThread.join();
+    }
+    cout << "Remote agent: " << result.decisions << " decisions in " << result.seconds << "s ("
+         << result.decisionsPerSecond << "/s), mean batch " << result.meanBatchSize
+         << ", latency mean " << result.meanLatencyMicros << "us p50 " << result.p50LatencyMicros
+         << "us p99 " << result.p99LatencyMicros << "us\n";
+    return result;
+}
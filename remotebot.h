@@ -0,0 +1,48 @@
+#ifndef REMOTEBOT_H
+#define REMOTEBOT_H
+#include <memory>
+#include <string>
+#include "asyncplayer.h"
+#include "agentprotocol.h"
+
+class GameManager;
+
+// Proxies decisions to an external agent over an AgentConnection. Many RemoteBots (one per
+// seat, across any number of tables) share one connection, so under a TableExecutor the
+// requests of every parked table travel to the agent together as one frame.
+class RemoteBot : public AsyncPlayer {
+public:
+    RemoteBot(const std::string& name, int chips, std::shared_ptr<AgentConnection> connection,
+              int position = -1);
+    // Blocking play has no other tables to batch with, so the request is sent before waiting.
+    PlayerAction makeDecision(const Gamestate& gameState, GameManager* gameManager);
+    void beginDecision(const Gamestate& gameState, GameManager* gameManager);
+    bool pollDecision(PlayerAction& action);
+    int getWaitFd() const;
+
+private:
+    std::shared_ptr<AgentConnection> _connection;
+    const Gamestate* _state;
+    uint64_t _request;
+    bool _flushed;      // left queued on the first poll so the executor can batch it
+};
+
+struct RemoteBenchmarkResult {
+    long long hands;
+    long long decisions;
+    double seconds;
+    double decisionsPerSecond;
+    double meanBatchSize;
+    double meanLatencyMicros;
+    double p50LatencyMicros;
+    double p99LatencyMicros;
+};
+
+// Plays numTables heads-up tables (RemoteBot vs RandomBot) on one TableExecutor against the
+// agent at socketPath. With startStandIn the bundled AgentServer is started on that path in
+// a background thread first. Table logging is silenced for the run.
+RemoteBenchmarkResult benchmarkRemoteAgent(const std::string& socketPath, int numTables,
+                                           int handsPerTable, int maxBatch = 256,
+                                           bool startStandIn = true);
+
+#endif // REMOTEBOT_H
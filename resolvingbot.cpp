@@ -0,0 +1,28 @@
+#include "resolvingbot.h"
+#include <vector>
+
+using namespace std;
+
+ResolvingBot::ResolvingBot(const string& name, int chips, shared_ptr<const MccfrSolver> blueprint,
+                           double budgetSeconds, int numThreads, int position)
+    : CfrBot(name, chips, blueprint, position), _resolver(blueprint, budgetSeconds, numThreads) {
+}
+
+PlayerAction ResolvingBot::makeDecision(const Gamestate& gameState, GameManager* gameManager) {
+    vector<PlayerAction> actions;
+    vector<float> probabilities;
+    if (!_resolver.resolve(gameState, getSeat(), actions, probabilities)) {
+        return CfrBot::makeDecision(gameState, gameManager);
+    }
+    int pick = pickAction(probabilities.data(), static_cast<int>(probabilities.size()));
+    if (pick < 0) return CfrBot::makeDecision(gameState, gameManager);
+    return actions[pick];
+}
+
+SubgameResolver& ResolvingBot::getResolver() {
+    return _resolver;
+}
+
+const SubgameResolver::Report& ResolvingBot::getLastReport() const {
+    return _resolver.getLastReport();
+}
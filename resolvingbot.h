@@ -0,0 +1,25 @@
+#ifndef RESOLVINGBOT_H
+#define RESOLVINGBOT_H
+#include <memory>
+#include "cfrbot.h"
+#include "subgameresolver.h"
+
+// CfrBot that plays its blueprint preflop and on the flop, and re-solves every turn and river
+// decision in real time with a SubgameResolver inside its time budget. Spots the resolver does
+// not handle (no-limit rules, more than two seats), or that use up the budget before the
+// first iteration, are played from the blueprint.
+class ResolvingBot : public CfrBot {
+public:
+    ResolvingBot(const std::string& name, int chips, std::shared_ptr<const MccfrSolver> blueprint,
+                 double budgetSeconds = 0.2, int numThreads = 0, int position = -1);
+    PlayerAction makeDecision(const Gamestate& gameState, GameManager* gameManager);
+
+    SubgameResolver& getResolver();
+    // Convergence of the last re-solved decision.
+    const SubgameResolver::Report& getLastReport() const;
+
+private:
+    SubgameResolver _resolver;
+};
+
+#endif // RESOLVINGBOT_H
@@ -1,6 +1,7 @@
 
 // ruleset.cpp
 #include "ruleset.h"
+#include "bettinglimits.h"
 #include <algorithm>
 
 // Default constructor - creates standard Texas Hold'em rules
@@ -91,6 +92,7 @@ RuleSet RuleSet::createFixedLimit(int smallBlind, int bigBlind) {
 }
 
 // Rule validation methods
+// The sizing itself lives in BettingLimits so the specialized engines share it
 bool RuleSet::isValidBet(int amount, int currentBet, int playerChips) const {
     if (amount < 0 || amount > playerChips) {
         return false;
@@ -98,17 +100,13 @@ bool RuleSet::isValidBet(int amount, int currentBet, int playerChips) const {
 
     switch (_bettingType) {
     case BettingStructure::NO_LIMIT:
-        // In no-limit, any amount up to all chips is valid
-        return amount >= getMinimumRaise(currentBet) || amount == playerChips;
+        return BettingLimits<BettingStructure::NO_LIMIT>::isValidBet(amount, currentBet, playerChips, _bigBlind);
 
     case BettingStructure::FIXED_LIMIT:
-        // In fixed limit, only specific bet sizes allowed
-        return amount == _bigBlind || amount == currentBet + _bigBlind;
+        return BettingLimits<BettingStructure::FIXED_LIMIT>::isValidBet(amount, currentBet, playerChips, _bigBlind);
 
     case BettingStructure::POT_LIMIT:
-        // In pot limit, maximum bet is pot size
-        // This would need pot size parameter - simplified for now
-        return amount >= getMinimumRaise(currentBet);
+        return BettingLimits<BettingStructure::POT_LIMIT>::isValidBet(amount, currentBet, playerChips, _bigBlind);
     }
 
     return false;
@@ -117,13 +115,13 @@ bool RuleSet::isValidBet(int amount, int currentBet, int playerChips) const {
 int RuleSet::getMinimumRaise(int currentBet) const {
     switch (_bettingType) {
     case BettingStructure::NO_LIMIT:
-        return currentBet + _bigBlind;
+        return BettingLimits<BettingStructure::NO_LIMIT>::getMinimumRaise(currentBet, _bigBlind);
 
     case BettingStructure::FIXED_LIMIT:
-        return currentBet + _bigBlind;
+        return BettingLimits<BettingStructure::FIXED_LIMIT>::getMinimumRaise(currentBet, _bigBlind);
 
     case BettingStructure::POT_LIMIT:
-        return currentBet + _bigBlind;
+        return BettingLimits<BettingStructure::POT_LIMIT>::getMinimumRaise(currentBet, _bigBlind);
     }
 
     return currentBet + _bigBlind;
@@ -132,13 +130,13 @@ int RuleSet::getMinimumRaise(int currentBet) const {
 int RuleSet::getMaximumBet(int currentBet, int playerChips, int potSize) const {
     switch (_bettingType) {
     case BettingStructure::NO_LIMIT:
-        return playerChips; // Can bet all chips
+        return BettingLimits<BettingStructure::NO_LIMIT>::getMaximumBet(currentBet, playerChips, potSize, _bigBlind);
 
     case BettingStructure::FIXED_LIMIT:
-        return currentBet + _bigBlind; // Fixed increment
+        return BettingLimits<BettingStructure::FIXED_LIMIT>::getMaximumBet(currentBet, playerChips, potSize, _bigBlind);
 
     case BettingStructure::POT_LIMIT:
-        return std::min(playerChips, currentBet + potSize); // Pot-sized bet
+        return BettingLimits<BettingStructure::POT_LIMIT>::getMaximumBet(currentBet, playerChips, potSize, _bigBlind);
     }
 
     return playerChips;
@@ -0,0 +1,114 @@
+#include "seatstate.h"
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+// drops bit `seat` and shifts the higher seats down one
+unsigned removeBit(unsigned mask, int seat) {
+    unsigned low = mask & ((1u << seat) - 1);
+    unsigned high = seat >= 31 ? 0 : (mask >> (seat + 1)) << seat;
+    return low | high;
+}
+
+}
+
+SeatState::SeatState()
+    : folded(0),
+    allIn(0),
+    sittingOut(0),
+    acted(0) {
+}
+
+int SeatState::addSeat(int chips) {
+    if (size() >= kMaxSeats) throw runtime_error("Table full");
+    stacks.push_back(chips);
+    roundBets.push_back(0);
+    totalBets.push_back(0);
+    holeCards.push_back(Hand());
+    return size() - 1;
+}
+
+void SeatState::removeSeat(int seat) {
+    stacks.erase(stacks.begin() + seat);
+    roundBets.erase(roundBets.begin() + seat);
+    totalBets.erase(totalBets.begin() + seat);
+    holeCards.erase(holeCards.begin() + seat);
+    folded = removeBit(folded, seat);
+    allIn = removeBit(allIn, seat);
+    sittingOut = removeBit(sittingOut, seat);
+    acted = removeBit(acted, seat);
+}
+
+void SeatState::resetForHand() {
+    for (int seat = 0; seat < size(); seat++) {
+        roundBets[seat] = 0;
+        totalBets[seat] = 0;
+        holeCards[seat].clear();
+    }
+    folded = 0;
+    allIn = 0;
+    acted = 0;
+}
+
+void SeatState::clearRoundBets() {
+    for (int seat = 0; seat < size(); seat++) {
+        roundBets[seat] = 0;
+    }
+}
+
+void SeatState::postBet(int seat, int amount) {
+    if (stacks[seat] >= amount) {
+        roundBets[seat] = amount;
+        totalBets[seat] += amount;
+        stacks[seat] -= amount;
+        acted |= 1u << seat;
+    }
+}
+
+void SeatState::addToBet(int seat, int amount) {
+    roundBets[seat] += amount;
+    totalBets[seat] += amount;
+    stacks[seat] -= amount;
+    acted |= 1u << seat;
+}
+
+void SeatState::goAllIn(int seat) {
+    roundBets[seat] += stacks[seat];
+    totalBets[seat] += stacks[seat];
+    stacks[seat] = 0;
+    allIn |= 1u << seat;
+}
+
+void SeatState::fold(int seat) {
+    folded |= 1u << seat;
+}
+
+void SeatState::check(int seat) {
+    acted |= 1u << seat;
+}
+
+void SeatState::addChips(int seat, int amount) {
+    stacks[seat] += amount;
+}
+
+void SeatState::dealCard(int seat, const Card& card) {
+    holeCards[seat].addCard(card);
+}
+
+unsigned SeatState::withChipsMask() const {
+    unsigned mask = 0;
+    for (int seat = 0; seat < size(); seat++) {
+        if (stacks[seat] > 0) mask |= 1u << seat;
+    }
+    return mask;
+}
+
+unsigned SeatState::matchedMask(int currentBet) const {
+    unsigned mask = 0;
+    for (int seat = 0; seat < size(); seat++) {
+        if (roundBets[seat] == currentBet) mask |= 1u << seat;
+    }
+    return mask;
+}
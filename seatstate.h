@@ -0,0 +1,52 @@
+#ifndef SEATSTATE_H
+#define SEATSTATE_H
+#include <vector>
+#include "card.h"
+#include "hand.h"
+
+// Table-level seat storage, struct-of-arrays style. Chip counts are parallel arrays indexed
+// by seat and each status flag is one bit per seat, so table-wide questions ("how many players
+// can still act?") are mask operations instead of a walk over Player objects.
+// GameManager owns one of these; a Player only remembers which seat it is bound to.
+struct SeatState {
+    static const int kMaxSeats = 32; // one bit per seat in the masks
+
+    std::vector<int> stacks;
+    std::vector<int> roundBets;
+    std::vector<int> totalBets;
+    std::vector<Hand> holeCards;
+    unsigned folded;
+    unsigned allIn;
+    unsigned sittingOut;
+    unsigned acted;     // checked, bet or posted since the hand started
+
+    SeatState();
+    int addSeat(int chips);
+    void removeSeat(int seat);
+    int size() const { return static_cast<int>(stacks.size()); }
+    void resetForHand();   // clears bets, status and cards, keeps stacks
+    void clearRoundBets();
+
+    void postBet(int seat, int amount);   // sets the round bet (blinds)
+    void addToBet(int seat, int amount);
+    void goAllIn(int seat);
+    void fold(int seat);
+    void check(int seat);
+    void addChips(int seat, int amount);
+    void dealCard(int seat, const Card& card);
+
+    unsigned occupiedMask() const { return size() >= 32 ? ~0u : (1u << size()) - 1; }
+    unsigned canActMask() const { return occupiedMask() & ~(folded | allIn | sittingOut); }
+    unsigned inHandMask() const { return occupiedMask() & ~(folded | sittingOut); }
+    unsigned withChipsMask() const;
+    unsigned matchedMask(int currentBet) const;
+    bool canAct(int seat) const { return (canActMask() >> seat) & 1u; }
+    bool isFolded(int seat) const { return (folded >> seat) & 1u; }
+    bool isAllIn(int seat) const { return (allIn >> seat) & 1u; }
+    bool hasActed(int seat) const { return (acted >> seat) & 1u; }
+
+    static int count(unsigned mask) { return __builtin_popcount(mask); }
+    static int firstSeat(unsigned mask) { return mask == 0 ? -1 : __builtin_ctz(mask); }
+};
+
+#endif // SEATSTATE_H
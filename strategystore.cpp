@@ -0,0 +1,290 @@
+#include "strategystore.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+struct StrategyStore::Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t precision;
+    uint32_t reserved;
+    uint64_t fingerprint;
+    uint64_t iterations;
+    uint64_t numNodes;
+    uint64_t numCells;
+    uint64_t nodesOffset;
+    uint64_t regretsOffset;
+    uint64_t sumsOffset;
+    uint64_t fileSize;
+    uint8_t padding[48];
+};
+
+namespace {
+
+const uint32_t kMagic = 0x54534b50;   // 'PKST'
+const uint32_t kVersion = 1;
+const int kInt16Limit = 32767;
+
+size_t alignUp(size_t offset) {
+    return (offset + 63) & ~static_cast<size_t>(63);
+}
+
+size_t cellSize(StrategyStore::Precision precision) {
+    return precision == StrategyStore::kInt16 ? sizeof(int16_t) : sizeof(float);
+}
+
+void normalize(const float* weights, const BettingTree::Node& node, float* probabilities) {
+    float total = 0.0f;
+    int legal = 0;
+    for (int action = 0; action < BetAbstraction::kMaxActions; action++) {
+        bool allowed = (node.legalMask >> action) & 1u;
+        probabilities[action] = allowed && weights[action] > 0.0f ? weights[action] : 0.0f;
+        total += probabilities[action];
+        legal += allowed ? 1 : 0;
+    }
+    for (int action = 0; action < BetAbstraction::kMaxActions; action++) {
+        bool allowed = (node.legalMask >> action) & 1u;
+        if (total > 0.0f) {
+            probabilities[action] /= total;
+        } else {
+            probabilities[action] = allowed ? 1.0f / legal : 0.0f;
+        }
+    }
+}
+
+void addFloat(float* cell, float value) {
+    float current;
+    __atomic_load(cell, &current, __ATOMIC_RELAXED);
+    float next = current + value;
+    while (!__atomic_compare_exchange(cell, &current, &next, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        next = current + value;
+    }
+}
+
+void halveRow(int16_t* row, int count) {
+    for (int i = 0; i < count; i++) {
+        int16_t current = __atomic_load_n(&row[i], __ATOMIC_RELAXED);
+        while (!__atomic_compare_exchange_n(&row[i], &current, static_cast<int16_t>(current / 2), true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        }
+    }
+}
+
+// adds a step already in cell units; halves the row instead of overflowing
+void addInt16(int16_t* row, int count, int slot, int step) {
+    if (step > kInt16Limit) step = kInt16Limit;
+    if (step < -kInt16Limit) step = -kInt16Limit;
+    int16_t current = __atomic_load_n(&row[slot], __ATOMIC_RELAXED);
+    for (;;) {
+        int next = current + step;
+        if (next > kInt16Limit || next < -kInt16Limit) {
+            halveRow(row, count);
+            current = __atomic_load_n(&row[slot], __ATOMIC_RELAXED);
+            continue;
+        }
+        if (__atomic_compare_exchange_n(&row[slot], &current, static_cast<int16_t>(next), true,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            return;
+        }
+    }
+}
+
+}
+
+StrategyStore::StrategyStore(const BettingTree& tree, Precision precision, uint64_t fingerprint)
+    : _mapping(nullptr), _mappedBytes(0), _writable(true), _header(nullptr), _nodes(nullptr),
+    _regrets(nullptr), _sums(nullptr) {
+    static_assert(sizeof(Header) == 128, "header is 128 bytes on disk");
+    const vector<BettingTree::Node>& nodes = tree.getNodes();
+    size_t nodesOffset = sizeof(Header);
+    size_t regretsOffset = alignUp(nodesOffset + nodes.size() * sizeof(BettingTree::Node));
+    size_t arrayBytes = static_cast<size_t>(tree.getNumCells()) * cellSize(precision);
+    size_t sumsOffset = alignUp(regretsOffset + arrayBytes);
+    _mappedBytes = alignUp(sumsOffset + arrayBytes);
+
+    // anonymous pages are zero and only become real memory once written
+    _mapping = mmap(nullptr, _mappedBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (_mapping == MAP_FAILED) {
+        _mapping = nullptr;
+        throw runtime_error("Could not allocate strategy store");
+    }
+    char* base = static_cast<char*>(_mapping);
+    _header = reinterpret_cast<Header*>(base);
+    _header->magic = kMagic;
+    _header->version = kVersion;
+    _header->precision = precision;
+    _header->fingerprint = fingerprint;
+    _header->numNodes = nodes.size();
+    _header->numCells = tree.getNumCells();
+    _header->nodesOffset = nodesOffset;
+    _header->regretsOffset = regretsOffset;
+    _header->sumsOffset = sumsOffset;
+    _header->fileSize = _mappedBytes;
+    memcpy(base + nodesOffset, nodes.data(), nodes.size() * sizeof(BettingTree::Node));
+
+    _nodes = reinterpret_cast<const BettingTree::Node*>(base + nodesOffset);
+    _regrets = base + regretsOffset;
+    _sums = base + sumsOffset;
+}
+
+StrategyStore::StrategyStore(const string& path, bool writable)
+    : _mapping(nullptr), _mappedBytes(0), _writable(writable), _header(nullptr), _nodes(nullptr),
+    _regrets(nullptr), _sums(nullptr) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw runtime_error("Could not open strategy " + path);
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw runtime_error("Could not read strategy " + path);
+    }
+    _mappedBytes = static_cast<size_t>(info.st_size);
+    int protection = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+    int flags = writable ? MAP_PRIVATE : MAP_SHARED;
+    _mapping = _mappedBytes >= sizeof(Header) ? mmap(nullptr, _mappedBytes, protection, flags, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (_mapping == MAP_FAILED) {
+        _mapping = nullptr;
+        throw runtime_error("Could not map strategy " + path);
+    }
+
+    char* base = static_cast<char*>(_mapping);
+    _header = reinterpret_cast<Header*>(base);
+    size_t arrayBytes = static_cast<size_t>(_header->numCells) * cellSize(static_cast<Precision>(_header->precision));
+    bool valid = _header->magic == kMagic && _header->version == kVersion && _header->precision <= kInt16
+                 && _header->fileSize == _mappedBytes && _header->numNodes > 0
+                 && _header->nodesOffset + _header->numNodes * sizeof(BettingTree::Node) <= _header->regretsOffset
+                 && _header->regretsOffset + arrayBytes <= _header->sumsOffset
+                 && _header->sumsOffset + arrayBytes <= _mappedBytes;
+    if (!valid) {
+        munmap(_mapping, _mappedBytes);
+        _mapping = nullptr;
+        throw runtime_error("Malformed strategy file " + path);
+    }
+    _nodes = reinterpret_cast<const BettingTree::Node*>(base + _header->nodesOffset);
+    _regrets = base + _header->regretsOffset;
+    _sums = base + _header->sumsOffset;
+}
+
+StrategyStore::~StrategyStore() {
+    if (_mapping) munmap(_mapping, _mappedBytes);
+}
+
+void StrategyStore::save(const string& path) const {
+    string temporary = path + ".tmp";
+    int fd = open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) throw runtime_error("Could not write strategy " + path);
+    const char* data = static_cast<const char*>(_mapping);
+    size_t written = 0;
+    while (written < _mappedBytes) {
+        ssize_t count = write(fd, data + written, _mappedBytes - written);
+        if (count <= 0) break;
+        written += static_cast<size_t>(count);
+    }
+    bool ok = written == _mappedBytes && fsync(fd) == 0;
+    close(fd);
+    if (!ok || rename(temporary.c_str(), path.c_str()) != 0) {
+        unlink(temporary.c_str());
+        throw runtime_error("Failed writing strategy " + path);
+    }
+}
+
+StrategyStore::Precision StrategyStore::getPrecision() const {
+    return static_cast<Precision>(_header->precision);
+}
+
+uint64_t StrategyStore::getFingerprint() const {
+    return _header->fingerprint;
+}
+
+bool StrategyStore::isWritable() const {
+    return _writable;
+}
+
+uint64_t StrategyStore::getIterations() const {
+    return _header->iterations;
+}
+
+void StrategyStore::addIterations(uint64_t iterations) {
+    if (!_writable) throw runtime_error("Strategy store is read-only");
+    _header->iterations += iterations;
+}
+
+int StrategyStore::getNumNodes() const {
+    return static_cast<int>(_header->numNodes);
+}
+
+uint64_t StrategyStore::getNumCells() const {
+    return _header->numCells;
+}
+
+size_t StrategyStore::getBytes() const {
+    return _mappedBytes;
+}
+
+const BettingTree::Node& StrategyStore::getNode(int index) const {
+    return _nodes[index];
+}
+
+void StrategyStore::readRow(const void* cells, const BettingTree::Node& node, int bucket, float* values) const {
+    uint64_t cell = BettingTree::getCell(node, bucket);
+    int slot = 0;
+    for (int action = 0; action < BetAbstraction::kMaxActions; action++) {
+        values[action] = 0.0f;
+        if (!((node.legalMask >> action) & 1u)) continue;
+        if (getPrecision() == kInt16) {
+            values[action] = __atomic_load_n(static_cast<const int16_t*>(cells) + cell + slot, __ATOMIC_RELAXED);
+        } else {
+            __atomic_load(static_cast<const float*>(cells) + cell + slot, &values[action], __ATOMIC_RELAXED);
+        }
+        slot++;
+    }
+}
+
+void StrategyStore::addRow(void* cells, const BettingTree::Node& node, int bucket, const float* values,
+                           float scale, EngineRng& rng) {
+    uint64_t cell = BettingTree::getCell(node, bucket);
+    int count = BettingTree::getNumActions(node);
+    int slot = 0;
+    for (int action = 0; action < BetAbstraction::kMaxActions; action++) {
+        if (!((node.legalMask >> action) & 1u)) continue;
+        if (getPrecision() == kInt16) {
+            int step = static_cast<int>(floor(values[action] * scale + rng.uniform()));
+            if (step != 0) addInt16(static_cast<int16_t*>(cells) + cell, count, slot, step);
+        } else if (values[action] != 0.0f) {
+            addFloat(static_cast<float*>(cells) + cell + slot, values[action]);
+        }
+        slot++;
+    }
+}
+
+void StrategyStore::getStrategy(const BettingTree::Node& node, int bucket, float* probabilities) const {
+    float regrets[BetAbstraction::kMaxActions];
+    readRow(_regrets, node, bucket, regrets);
+    normalize(regrets, node, probabilities);
+}
+
+bool StrategyStore::getAverageStrategy(const BettingTree::Node& node, int bucket, float* probabilities) const {
+    float sums[BetAbstraction::kMaxActions];
+    readRow(_sums, node, bucket, sums);
+    bool reached = false;
+    for (int action = 0; action < BetAbstraction::kMaxActions; action++) reached |= sums[action] > 0.0f;
+    normalize(sums, node, probabilities);
+    return reached;
+}
+
+void StrategyStore::addRegrets(const BettingTree::Node& node, int bucket, const double* values, EngineRng& rng) {
+    float regrets[BetAbstraction::kMaxActions];
+    for (int action = 0; action < BetAbstraction::kMaxActions; action++) regrets[action] = static_cast<float>(values[action]);
+    addRow(_regrets, node, bucket, regrets, kInt16Scale, rng);
+}
+
+void StrategyStore::addStrategy(const BettingTree::Node& node, int bucket, const float* probabilities, EngineRng& rng) {
+    addRow(_sums, node, bucket, probabilities, kInt16Scale, rng);
+}
@@ -0,0 +1,77 @@
+#ifndef STRATEGYSTORE_H
+#define STRATEGYSTORE_H
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "bettingtree.h"
+#include "tableengine.h"
+
+// Regrets and strategy sums for every infoset of a BettingTree, in two flat arrays indexed by
+// BettingTree::getCell. The whole store is one memory image - header, tree nodes, regrets,
+// strategy sums - so a checkpoint is a straight copy of it and opening one is a single mmap:
+// nothing is parsed or copied, pages come in as they are touched.
+//
+// Cells are fp32 or int16. int16 cells hold value * kInt16Scale (regrets in big blinds,
+// strategy sums in probability mass) with stochastic rounding, so small updates still add
+// up on average. When an update would overflow a cell, the infoset's whole row is halved
+// first; regret matching and the average strategy only depend on ratios within a row, so this
+// just discounts the row's older iterations.
+//
+// Updates are lock-free (CAS per cell), like the rest of the training code.
+//
+// File layout, little endian: 128-byte header { 'PKST', version, precision, reserved,
+// fingerprint, iterations, numNodes, numCells, nodesOffset, regretsOffset, sumsOffset,
+// fileSize }, then BettingTree::Node[numNodes], then the two cell arrays, each 64-byte aligned.
+class StrategyStore
+{
+public:
+    enum Precision { kFloat32 = 0, kInt16 = 1 };
+    static const int kInt16Scale = 256;
+
+    // Fresh, zeroed store in anonymous memory.
+    StrategyStore(const BettingTree& tree, Precision precision, uint64_t fingerprint);
+    // Maps a saved store. Writable maps are copy-on-write, so training on a loaded checkpoint
+    // never touches the file until save(); read-only maps share pages between processes.
+    StrategyStore(const std::string& path, bool writable);
+    ~StrategyStore();
+    StrategyStore(const StrategyStore&) = delete;
+    StrategyStore& operator=(const StrategyStore&) = delete;
+
+    void save(const std::string& path) const;   // via a temporary file, so readers never see half
+
+    Precision getPrecision() const;
+    uint64_t getFingerprint() const;
+    bool isWritable() const;
+    uint64_t getIterations() const;
+    void addIterations(uint64_t iterations);
+    int getNumNodes() const;
+    uint64_t getNumCells() const;
+    size_t getBytes() const;
+    const BettingTree::Node& getNode(int index) const;
+
+    // Probabilities per abstract action id (0 for actions the node does not have).
+    void getStrategy(const BettingTree::Node& node, int bucket, float* probabilities) const;
+    // false if the infoset has no strategy mass yet; probabilities are uniform then
+    bool getAverageStrategy(const BettingTree::Node& node, int bucket, float* probabilities) const;
+
+    // values / probabilities per abstract action id, like the getters
+    void addRegrets(const BettingTree::Node& node, int bucket, const double* values, EngineRng& rng);
+    void addStrategy(const BettingTree::Node& node, int bucket, const float* probabilities, EngineRng& rng);
+
+private:
+    struct Header;
+
+    void* _mapping;
+    size_t _mappedBytes;
+    bool _writable;
+    Header* _header;
+    const BettingTree::Node* _nodes;
+    void* _regrets;
+    void* _sums;
+
+    void readRow(const void* cells, const BettingTree::Node& node, int bucket, float* values) const;
+    void addRow(void* cells, const BettingTree::Node& node, int bucket, const float* values, float scale,
+                EngineRng& rng);
+};
+
+#endif // STRATEGYSTORE_H
@@ -0,0 +1,187 @@
+#include "subgameresolver.h"
+#include "cfrbot.h"
+#include "gamestateview.h"
+#include "handcombos.h"
+#include "limitrangesolver.h"
+#include "publictree.h"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <utility>
+
+using namespace std;
+
+namespace {
+
+const int kCombos = HandCombos::kNumCombos;
+
+int getBoardSize(GamePhase phase) {
+    return phase == GamePhase::preflop ? 0 : static_cast<int>(phase) + 2;
+}
+
+bool isRaise(Action action) {
+    return action == Action::bet || action == Action::raise || action == Action::all_in;
+}
+
+}
+
+SubgameResolver::SubgameResolver(shared_ptr<const MccfrSolver> blueprint, double budgetSeconds, int numThreads,
+                                 int bettingStreets)
+    : _blueprint(blueprint),
+    _budgetSeconds(budgetSeconds),
+    _bettingStreets(bettingStreets),
+    _measureExploitability(false),
+    _pool(numThreads),
+    _report() {
+    if (!_blueprint) throw runtime_error("SubgameResolver needs a blueprint solver");
+}
+
+void SubgameResolver::setBudget(double seconds) {
+    _budgetSeconds = seconds;
+}
+
+void SubgameResolver::setBettingStreets(int bettingStreets) {
+    _bettingStreets = bettingStreets;
+}
+
+void SubgameResolver::setMeasureExploitability(bool measure) {
+    _measureExploitability = measure;
+}
+
+const SubgameResolver::Report& SubgameResolver::getLastReport() const {
+    return _report;
+}
+
+bool SubgameResolver::resolve(const Gamestate& state, int seat, vector<PlayerAction>& actions,
+                              vector<float>& probabilities) {
+    auto started = chrono::steady_clock::now();
+    const RuleSet& rules = _blueprint->getRules();
+    GamestateView view(state, seat);
+    if (rules.getBettingType() != BettingStructure::FIXED_LIMIT) return false;
+    if (view.getNumSeats() != 2 || view.getCurrentSeat() != seat) return false;
+    if (view.getBoardSize() < 4) return false;
+
+    // player 0 of the public tree opens the postflop streets: the seat off the button
+    int button = view.getButton();
+    int treePlayer[2] = {button == 0 ? 1 : 0, button == 1 ? 1 : 0};
+    int seatOf[2];
+    for (int s = 0; s < 2; s++) seatOf[treePlayer[s]] = s;
+
+    PublicTree::Start start;
+    for (int i = 0; i < 5; i++) start.board[i] = i < view.getBoardSize() ? view.getBoard()[i] : 0;
+    start.boardSize = view.getBoardSize();
+    start.raises = 0;
+    int stack = 0;
+    for (int player = 0; player < 2; player++) {
+        int s = seatOf[player];
+        start.contributions[player] = view.getTotalBet(s);
+        start.roundBets[player] = view.getRoundBet(s);
+        start.acted[player] = false;
+        int chips = view.getStack(s) + view.getTotalBet(s);
+        stack = player == 0 ? chips : min(stack, chips);
+    }
+    for (const ActionRecord& record : state.getActionHistory()) {
+        if (record.phase != view.getPhase() || record.seat < 0 || record.seat > 1) continue;
+        start.acted[treePlayer[record.seat]] = true;
+        if (isRaise(record.actionType)) start.raises++;
+    }
+    start.toAct = treePlayer[seat];
+
+    vector<float> ranges[2];
+    int rangeActions = buildRanges(state, treePlayer, ranges);
+
+    LimitRangeSolver solver(rules, PublicTree::buildFixedLimit(rules, start, stack, _bettingStreets),
+                            ranges[0].data(), ranges[1].data(), _pool);
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+    int iterations = solver.solveFor(_budgetSeconds - elapsed);
+    const PublicTree& tree = solver.getTree();
+
+    _report.iterations = iterations;
+    _report.iterationsPerSecond = solver.getIterationsPerSecond();
+    _report.exploitability = _measureExploitability && iterations > 0 ? solver.getExploitability() : -1.0;
+    _report.publicNodes = static_cast<int>(tree.getNodes().size());
+    _report.rangeActions = rangeActions;
+    _report.historySize = static_cast<int>(state.getActionHistory().size());
+    if (iterations == 0) {
+        _report.seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+        return false;
+    }
+
+    // the root's children, as actions at the real table
+    const PublicTree::Node& root = tree.getNode(0);
+    LegalActions legal = view.getLegalActions();
+    vector<float> strategy(root.numChildren);
+    solver.getAverageStrategy(0, HandCombos::getIndex(view.getHoleCards(seat)[0], view.getHoleCards(seat)[1]),
+                              strategy.data());
+    actions.clear();
+    probabilities.clear();
+    for (int child = 0; child < root.numChildren; child++) {
+        const PublicTree::Node& node = tree.getNode(root.firstChild + child);
+        switch (node.action) {
+        case Action::call:
+            actions.push_back(PlayerAction(Action::call, legal.callAmount));
+            break;
+        case Action::bet:
+        case Action::raise:
+            actions.push_back(PlayerAction(node.action, min(max(node.amount, legal.minRaiseTo), legal.maxRaiseTo)));
+            break;
+        default:
+            actions.push_back(PlayerAction(node.action));
+            break;
+        }
+        probabilities.push_back(legal.has(node.action) ? strategy[child] : 0.0f);
+    }
+    _report.seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+    return true;
+}
+
+// Reach of every combo for both tree players along the part of the history the blueprint's
+// tree covers; returns how many actions that was.
+int SubgameResolver::buildRanges(const Gamestate& state, const int* treePlayer, vector<float>* ranges) {
+    vector<CfrBot::PathStep> path;
+    CfrBot::tracePath(*_blueprint, state, path);
+    ranges[0].assign(kCombos, 1.0f);
+    ranges[1].assign(kCombos, 1.0f);
+
+    uint8_t board[5];
+    int boardSize = 0;
+    for (const Card& card : state.getCommunityCards()) {
+        if (boardSize < 5) board[boardSize++] = static_cast<uint8_t>(card.getIndex());
+    }
+    float probabilities[BetAbstraction::kMaxActions];
+    for (const CfrBot::PathStep& step : path) {
+        int size = min(getBoardSize(step.phase), boardSize);
+        const vector<int>& buckets = getBuckets(board, size);
+        vector<float>& range = ranges[treePlayer[step.seat]];
+        for (int combo = 0; combo < kCombos; combo++) {
+            if (buckets[combo] < 0 || range[combo] == 0.0f) continue;
+            if (_blueprint->getAverageStrategy(step.node, buckets[combo], probabilities)) {
+                range[combo] *= probabilities[step.action];
+            }
+        }
+    }
+    // a blueprint sure it never gets here leaves nothing to go on
+    for (int player = 0; player < 2; player++) {
+        float total = 0.0f;
+        for (float weight : ranges[player]) total += weight;
+        if (total <= 0.0f) ranges[player].assign(kCombos, 1.0f);
+    }
+    return static_cast<int>(path.size());
+}
+
+// -1 for combos that use a board card
+const vector<int>& SubgameResolver::getBuckets(const uint8_t* board, int boardSize) {
+    uint64_t boardMask = HandCombos::getMask(board, boardSize);
+    if (_buckets.size() >= kMaxCachedBoards && !_buckets.count(boardMask)) _buckets.clear();
+    vector<int>& buckets = _buckets[boardMask];
+    if (!buckets.empty()) return buckets;
+    buckets.assign(kCombos, -1);
+    const CardAbstraction& cards = _blueprint->getCardAbstraction();
+    _pool.parallelFor(kCombos, [&](int begin, int end) {
+        for (int combo = begin; combo < end; combo++) {
+            if (HandCombos::getMask(combo) & boardMask) continue;
+            buckets[combo] = cards.getBucket(HandCombos::getCards(combo), board, boardSize);
+        }
+    });
+    return buckets;
+}
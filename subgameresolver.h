@@ -0,0 +1,71 @@
+#ifndef SUBGAMERESOLVER_H
+#define SUBGAMERESOLVER_H
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "gamestate.h"
+#include "mccfrsolver.h"
+#include "workerpool.h"
+
+// Re-solves a heads-up fixed-limit spot on the turn or river at decision time. The subgame
+// starts where the table is - board, money in, bets and raises so far on the street, who has
+// acted - and each player's range comes from the hand's history: every action on the
+// blueprint's betting tree multiplies each combo's weight by the probability the blueprint's
+// average strategy gives it, for that combo's bucket on the board of the time. The subgame is
+// then solved with LimitRangeSolver's vectorized CFR+, on the resolver's own worker pool, until
+// the wall-clock budget runs out. The budget counts from the start of the call, so range
+// building, the public tree and ranking its river boards all come out of it.
+//
+// On the turn the tree is depth limited to the turn's betting by default: the river is dealt
+// and checked down. Ranges come straight from the blueprint, with no safeguard keeping the
+// re-solved strategy from being exploitable where it departs from it.
+class SubgameResolver
+{
+public:
+    // How the last re-solve went.
+    struct Report {
+        int iterations;
+        double seconds;             // wall clock for the whole call, any exploitability pass included
+        double iterationsPerSecond;
+        double exploitability;      // of the subgame solution, mbb per hand from the ranges; -1 unmeasured
+        int publicNodes;
+        int rangeActions;           // history actions that shaped the ranges
+        int historySize;            // of all actions so far (more when the hand left the tree)
+    };
+
+    // numThreads 0 = one per hardware thread; bettingStreets 0 plays every street out.
+    SubgameResolver(std::shared_ptr<const MccfrSolver> blueprint, double budgetSeconds = 0.2, int numThreads = 0,
+                    int bettingStreets = 1);
+
+    void setBudget(double seconds);
+    void setBettingStreets(int bettingStreets);
+    // Also measures the solution's exploitability for the report. That is a best-response pass
+    // over the whole subgame after the budget is spent, so it is off unless asked for.
+    void setMeasureExploitability(bool measure);
+
+    // Solves the spot for the seat to act. Fills in the real actions the subgame's root offers
+    // and the solution's probabilities for the seat's cards, or returns false when the spot is
+    // not one it handles (fixed-limit rules, two seats, turn or river, the seat to act) or the
+    // budget ran out before a single iteration.
+    bool resolve(const Gamestate& state, int seat, std::vector<PlayerAction>& actions,
+                 std::vector<float>& probabilities);
+    const Report& getLastReport() const;
+
+private:
+    static const size_t kMaxCachedBoards = 16;
+
+    std::shared_ptr<const MccfrSolver> _blueprint;
+    double _budgetSeconds;
+    int _bettingStreets;
+    bool _measureExploitability;
+    WorkerPool _pool;
+    Report _report;
+    // blueprint buckets of every combo per board (by card mask); a hand asks for the same few
+    std::unordered_map<uint64_t, std::vector<int>> _buckets;
+
+    const std::vector<int>& getBuckets(const uint8_t* board, int boardSize);
+    int buildRanges(const Gamestate& state, const int* treePlayer, std::vector<float>* ranges);
+};
+
+#endif // SUBGAMERESOLVER_H
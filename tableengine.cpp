@@ -0,0 +1,40 @@
+#include "tableengine.h"
+#include <stdexcept>
+
+template class TableEngine<BettingStructure::NO_LIMIT, 2>;
+template class TableEngine<BettingStructure::NO_LIMIT, 6>;
+template class TableEngine<BettingStructure::NO_LIMIT, 10>;
+template class TableEngine<BettingStructure::POT_LIMIT, 2>;
+template class TableEngine<BettingStructure::POT_LIMIT, 6>;
+template class TableEngine<BettingStructure::POT_LIMIT, 10>;
+template class TableEngine<BettingStructure::FIXED_LIMIT, 2>;
+template class TableEngine<BettingStructure::FIXED_LIMIT, 6>;
+template class TableEngine<BettingStructure::FIXED_LIMIT, 10>;
+
+namespace {
+
+template <BettingStructure Structure>
+AnyTableEngine makeForSeats(const RuleSet& rules, int numSeats) {
+    if (numSeats <= 2) return AnyTableEngine(std::in_place_type<TableEngine<Structure, 2>>, rules, numSeats);
+    if (numSeats <= 6) return AnyTableEngine(std::in_place_type<TableEngine<Structure, 6>>, rules, numSeats);
+    return AnyTableEngine(std::in_place_type<TableEngine<Structure, 10>>, rules, numSeats);
+}
+
+}
+
+AnyTableEngine makeTableEngine(const RuleSet& rules, int numSeats) {
+    if (numSeats < 2 || numSeats > 10 || !rules.isValidPlayerCount(numSeats)) {
+        throw std::runtime_error("Unsupported table size");
+    }
+
+    switch (rules.getBettingType()) {
+    case BettingStructure::NO_LIMIT:
+        return makeForSeats<BettingStructure::NO_LIMIT>(rules, numSeats);
+    case BettingStructure::POT_LIMIT:
+        return makeForSeats<BettingStructure::POT_LIMIT>(rules, numSeats);
+    case BettingStructure::FIXED_LIMIT:
+        return makeForSeats<BettingStructure::FIXED_LIMIT>(rules, numSeats);
+    }
+
+    return makeForSeats<BettingStructure::NO_LIMIT>(rules, numSeats);
+}
@@ -0,0 +1,506 @@
+#ifndef TABLEENGINE_H
+#define TABLEENGINE_H
+#include <cstdint>
+#include <array>
+#include <variant>
+#include "poker_info.h"
+#include "ruleset.h"
+#include "bettinglimits.h"
+#include "handstrengthevaluator.h"
+
+// splitmix64 - a single word of state so every table can carry its own stream
+struct EngineRng {
+    uint64_t state;
+
+    explicit EngineRng(uint64_t seed = 0) : state(seed) {}
+    uint64_t next() { return mix(state += 0x9E3779B97F4A7C15ull); }
+    int below(int n) { return static_cast<int>(((next() >> 32) * static_cast<uint64_t>(n)) >> 32); }
+    double uniform() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+
+    // splitmix64's output function; also a cheap hash step
+    static uint64_t mix(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+    // What the (index + 1)-th next() returns after seeding with seed: one seed fans out into
+    // independent ones that any thread can derive on its own, in any order.
+    static uint64_t getStreamSeed(uint64_t seed, uint64_t index) {
+        return mix(seed + 0x9E3779B97F4A7C15ull * (index + 1));
+    }
+};
+
+// Hold'em table specialized on betting structure and seat count. Everything GameManager
+// looks up at runtime (limit type, table size) is a template parameter here, seat state
+// lives in fixed arrays and the status of each seat is a bit in a mask.
+//
+// The engine is step driven: startHand() deals and posts blinds, then applyAction() is called
+// for getCurrentSeat() until isHandOver(). playHand() wraps that loop for a policy callable.
+template <BettingStructure Structure, int MaxSeats>
+class TableEngine
+{
+public:
+    using Limits = BettingLimits<Structure>;
+    static constexpr int kMaxSeats = MaxSeats;
+    static_assert(MaxSeats >= 2 && MaxSeats <= 32, "seat masks are 32 bits");
+
+    TableEngine(const RuleSet& rules, int numSeats)
+        : _smallBlind(rules.getSmallBlind()),
+        _bigBlind(rules.getBigBlind()),
+        _maxRaises(rules.getMaxRaises()),
+        _numSeats(numSeats),
+        _button(numSeats - 1),
+        _currentSeat(-1),
+        _phase(GamePhase::showdown),
+        _handOver(true),
+        _dealPreset(false),
+        _dealStacked(false),
+        _rng(0) {
+        for (int seat = 0; seat < MaxSeats; seat++) {
+            _stacks[seat] = seat < numSeats ? rules.getStartingChips() : 0;
+            _roundBets[seat] = 0;
+            _totalBets[seat] = 0;
+            _payoffs[seat] = 0;
+        }
+        for (int i = 0; i < 52; i++) _deck[i] = static_cast<uint8_t>(i);
+        _boardSize = 0;
+        _historySize = 0;
+        clearMasks();
+    }
+
+    void seed(uint64_t seed) { _rng = EngineRng(seed); }
+    void setStack(int seat, int chips) { _stacks[seat] = chips; }
+    void setButton(int seat) { _button = seat; }
+    // Deals these cards in the next hand instead of drawing them: two hole cards for each seat
+    // in seat order, then the five board cards, all different. Seats without chips are skipped.
+    // For replaying a deal from another table.
+    void setNextDeal(const uint8_t* cards) {
+        for (int i = 0; i < 2 * _numSeats + 5; i++) _nextDeal[i] = cards[i];
+        _dealPreset = true;
+    }
+
+    // Moves the button, shuffles, deals and posts blinds. Returns false if fewer than two seats have chips.
+    bool startHand() {
+        unsigned seated = 0;
+        for (int seat = 0; seat < _numSeats; seat++) {
+            _roundBets[seat] = 0;
+            _totalBets[seat] = 0;
+            _payoffs[seat] = 0;
+            if (_stacks[seat] > 0) seated |= 1u << seat;
+        }
+        clearMasks();
+        if (__builtin_popcount(seated) < 2) return false;
+
+        _inHandMask = seated;
+        _button = nextSeat(_button, seated);
+        bool headsUp = __builtin_popcount(seated) == 2;
+        _smallBlindSeat = headsUp ? _button : nextSeat(_button, seated);
+        _bigBlindSeat = nextSeat(_smallBlindSeat, seated);
+
+        _deckPos = 0;
+        _boardSize = 0;
+        _historySize = 0;
+        _dealStacked = _dealPreset;
+        if (_dealPreset) stackDeck(seated);
+        for (int round = 0; round < 2; round++) {
+            for (int seat = 0; seat < _numSeats; seat++) {
+                if (seated & (1u << seat)) _holeCards[seat * 2 + round] = dealCard();
+            }
+        }
+
+        _phase = GamePhase::preflop;
+        _handOver = false;
+        _raisesThisRound = 0;
+        int smallPosted = post(_smallBlindSeat, _smallBlind);
+        int bigPosted = post(_bigBlindSeat, _bigBlind);
+        _currentBet = smallPosted > bigPosted ? smallPosted : bigPosted;
+
+        _currentSeat = _bigBlindSeat;
+        advance();
+        return true;
+    }
+
+    LegalActions getLegalActions() const {
+        if (_handOver) return LegalActions{0, 0, 0, 0, 0};
+        int seat = _currentSeat;
+        BettingSpot spot;
+        spot.stack = _stacks[seat];
+        spot.roundBet = _roundBets[seat];
+        spot.currentBet = _currentBet;
+        spot.potSize = getPotSize();
+        spot.bigBlind = _bigBlind;
+        spot.raisesThisRound = _raisesThisRound;
+        spot.maxRaises = _maxRaises;
+        spot.opponentsCanAct = (canActMask() & ~(1u << seat)) != 0;
+        return getLegalActionsAt<Structure>(spot);
+    }
+
+    // Applies the action for getCurrentSeat(). Illegal actions leave the table untouched and return false.
+    bool applyAction(const PlayerAction& action) {
+        if (_handOver) return false;
+        LegalActions legal = getLegalActions();
+        if (!legal.has(action.actionType)) return false;
+
+        int seat = _currentSeat;
+        unsigned seatBit = 1u << seat;
+        switch (action.actionType) {
+        case Action::fold:
+            _inHandMask &= ~seatBit;
+            break;
+
+        case Action::check:
+            break;
+
+        case Action::call:
+            putChips(seat, legal.callAmount);
+            break;
+
+        case Action::bet:
+        case Action::raise:
+            if (action.amount < legal.minRaiseTo || action.amount > legal.maxRaiseTo) return false;
+            raiseTo(seat, action.amount);
+            break;
+
+        case Action::all_in:
+            raiseTo(seat, legal.allInTo);
+            break;
+        }
+        recordAction(seat, action.actionType, action.actionType == Action::call ? legal.callAmount
+                                              : action.actionType == Action::all_in ? legal.allInTo
+                                              : action.amount);
+        _actedMask |= seatBit;
+        advance();
+        return true;
+    }
+
+    // Runs one full hand; policy(table, seat) returns the PlayerAction for that seat.
+    // Illegal answers fall back to check, or fold when facing a bet.
+    template <typename Policy>
+    bool playHand(Policy&& policy) {
+        if (!startHand()) return false;
+        while (!_handOver) {
+            if (!applyAction(policy(*this, _currentSeat))) {
+                applyAction(PlayerAction(_currentBet > _roundBets[_currentSeat] ? Action::fold : Action::check));
+            }
+        }
+        return true;
+    }
+
+    bool isHandOver() const { return _handOver; }
+    int getCurrentSeat() const { return _currentSeat; }
+    GamePhase getPhase() const { return _phase; }
+    int getNumSeats() const { return _numSeats; }
+    int getButton() const { return _button; }
+    int getSmallBlindSeat() const { return _smallBlindSeat; }
+    int getBigBlindSeat() const { return _bigBlindSeat; }
+    int getSmallBlind() const { return _smallBlind; }
+    int getBigBlind() const { return _bigBlind; }
+    int getCurrentBet() const { return _currentBet; }
+    int getStack(int seat) const { return _stacks[seat]; }
+    int getRoundBet(int seat) const { return _roundBets[seat]; }
+    int getTotalBet(int seat) const { return _totalBets[seat]; }
+    int getPayoff(int seat) const { return _payoffs[seat]; } // net chips won in the last finished hand
+    const uint8_t* getHoleCards(int seat) const { return &_holeCards[seat * 2]; }
+    const uint8_t* getBoard() const { return _board; }
+    int getBoardSize() const { return _boardSize; }
+    const ActionRecord* getHistory() const { return _history; }
+    int getHistorySize() const { return _historySize; }
+    unsigned getInHandMask() const { return _inHandMask; }
+    unsigned getAllInMask() const { return _allInMask; }
+    unsigned canActMask() const { return _inHandMask & ~_allInMask; }
+
+    int getPotSize() const {
+        int pot = 0;
+        for (int seat = 0; seat < _numSeats; seat++) pot += _totalBets[seat];
+        return pot;
+    }
+
+private:
+    int _smallBlind;
+    int _bigBlind;
+    int _maxRaises;
+    int _numSeats;
+
+    std::array<int, MaxSeats> _stacks;
+    std::array<int, MaxSeats> _roundBets;
+    std::array<int, MaxSeats> _totalBets;
+    std::array<int, MaxSeats> _payoffs;
+    std::array<uint8_t, MaxSeats * 2> _holeCards;
+    unsigned _inHandMask;   // dealt in and not folded
+    unsigned _allInMask;
+    unsigned _actedMask;    // acted since the last bet or raise
+
+    uint8_t _deck[52];
+    int _deckPos;
+    uint8_t _board[5];
+    int _boardSize;
+    ActionRecord _history[kMaxActionHistory];
+    int _historySize;
+
+    int _button;
+    int _smallBlindSeat;
+    int _bigBlindSeat;
+    int _currentSeat;
+    int _currentBet;
+    int _raisesThisRound;
+    GamePhase _phase;
+    bool _handOver;
+    std::array<uint8_t, MaxSeats * 2 + 5> _nextDeal;
+    bool _dealPreset;
+    bool _dealStacked;     // this hand deals the preset cards off the top of the deck
+    EngineRng _rng;
+
+    static unsigned bit(Action action) { return 1u << static_cast<int>(action); }
+
+    void recordAction(int seat, Action action, int amount) {
+        if (_historySize == kMaxActionHistory) return;
+        ActionRecord& record = _history[_historySize++];
+        record.seat = static_cast<int8_t>(seat);
+        record.phase = _phase;
+        record.actionType = action;
+        record.amount = action == Action::check || action == Action::fold ? 0 : amount;
+    }
+
+    void clearMasks() {
+        _inHandMask = 0;
+        _allInMask = 0;
+        _actedMask = 0;
+    }
+
+    int nextSeat(int seat, unsigned mask) const {
+        for (int i = 1; i <= _numSeats; i++) {
+            int next = (seat + i) % _numSeats;
+            if (mask & (1u << next)) return next;
+        }
+        return -1;
+    }
+
+    // moves the preset cards to the top of the deck in the order startHand() deals them
+    void stackDeck(unsigned seated) {
+        uint8_t order[MaxSeats * 2 + 5];
+        int count = 0;
+        for (int round = 0; round < 2; round++) {
+            for (int seat = 0; seat < _numSeats; seat++) {
+                if (seated & (1u << seat)) order[count++] = _nextDeal[seat * 2 + round];
+            }
+        }
+        for (int i = 0; i < 5; i++) order[count++] = _nextDeal[_numSeats * 2 + i];
+        for (int i = 0; i < count; i++) {
+            int j = i;
+            while (j < 51 && _deck[j] != order[i]) j++;
+            uint8_t card = _deck[j];
+            _deck[j] = _deck[i];
+            _deck[i] = card;
+        }
+        _dealPreset = false;
+    }
+
+    // partial Fisher-Yates, so a hand only pays for the cards it uses
+    uint8_t dealCard() {
+        if (_dealStacked) return _deck[_deckPos++];
+        int pick = _deckPos + _rng.below(52 - _deckPos);
+        uint8_t card = _deck[pick];
+        _deck[pick] = _deck[_deckPos];
+        _deck[_deckPos++] = card;
+        return card;
+    }
+
+    void putChips(int seat, int amount) {
+        _stacks[seat] -= amount;
+        _roundBets[seat] += amount;
+        _totalBets[seat] += amount;
+        if (_stacks[seat] == 0) _allInMask |= 1u << seat;
+    }
+
+    int post(int seat, int blind) {
+        int amount = blind < _stacks[seat] ? blind : _stacks[seat];
+        putChips(seat, amount);
+        return amount;
+    }
+
+    void raiseTo(int seat, int roundTotal) {
+        putChips(seat, roundTotal - _roundBets[seat]);
+        if (roundTotal > _currentBet) {
+            _currentBet = roundTotal;
+            _raisesThisRound++;
+            _actedMask = 0; // everyone else has to respond again
+        }
+    }
+
+    unsigned needsActionMask() const {
+        unsigned pending = 0;
+        unsigned canAct = canActMask();
+        for (int seat = 0; seat < _numSeats; seat++) {
+            unsigned seatBit = 1u << seat;
+            if ((canAct & seatBit) && (!(_actedMask & seatBit) || _roundBets[seat] < _currentBet)) {
+                pending |= seatBit;
+            }
+        }
+        return pending;
+    }
+
+    void advance() {
+        if (__builtin_popcount(_inHandMask) == 1) {
+            settle();
+            return;
+        }
+        unsigned pending = needsActionMask();
+        if (__builtin_popcount(canActMask()) < 2) {
+            // nobody left to bet against; only a player still facing a bet has a decision
+            for (int seat = 0; seat < _numSeats; seat++) {
+                if (_roundBets[seat] >= _currentBet) pending &= ~(1u << seat);
+            }
+        }
+        if (pending != 0) {
+            _currentSeat = nextSeat(_currentSeat, pending);
+            return;
+        }
+        endBettingRound();
+    }
+
+    void endBettingRound() {
+        while (true) {
+            for (int seat = 0; seat < _numSeats; seat++) _roundBets[seat] = 0;
+            _currentBet = 0;
+            _raisesThisRound = 0;
+            _actedMask = 0;
+
+            if (_phase == GamePhase::river) {
+                settle();
+                return;
+            }
+            dealNextStreet();
+            if (__builtin_popcount(canActMask()) >= 2) {
+                _currentSeat = nextSeat(_button, canActMask());
+                return;
+            }
+        }
+    }
+
+    void dealNextStreet() {
+        switch (_phase) {
+        case GamePhase::preflop:
+            for (int i = 0; i < 3; i++) _board[_boardSize++] = dealCard();
+            _phase = GamePhase::flop;
+            break;
+        case GamePhase::flop:
+            _board[_boardSize++] = dealCard();
+            _phase = GamePhase::turn;
+            break;
+        case GamePhase::turn:
+            _board[_boardSize++] = dealCard();
+            _phase = GamePhase::river;
+            break;
+        default:
+            break;
+        }
+    }
+
+    // Pays every pot layer (main pot first, then side pots) to the best eligible hand.
+    void settle() {
+        std::array<int, MaxSeats> won{};
+        std::array<int, MaxSeats> handValues{};
+
+        if (__builtin_popcount(_inHandMask) == 1) {
+            won[__builtin_ctz(_inHandMask)] = getPotSize();
+        } else {
+            while (_boardSize < 5) _board[_boardSize++] = dealCard();
+            uint8_t cards[7];
+            for (int i = 0; i < 5; i++) cards[i + 2] = _board[i];
+            for (int seat = 0; seat < _numSeats; seat++) {
+                if (_inHandMask & (1u << seat)) {
+                    cards[0] = _holeCards[seat * 2];
+                    cards[1] = _holeCards[seat * 2 + 1];
+                    handValues[seat] = HandStrengthEvaluator::rankCards(cards, 7);
+                }
+            }
+
+            int previousLevel = 0;
+            while (true) {
+                int level = -1;
+                for (int seat = 0; seat < _numSeats; seat++) {
+                    if (_totalBets[seat] > previousLevel && (level < 0 || _totalBets[seat] < level)) {
+                        level = _totalBets[seat];
+                    }
+                }
+                if (level < 0) break;
+
+                int layer = 0;
+                int best = -1;
+                unsigned winners = 0;
+                for (int seat = 0; seat < _numSeats; seat++) {
+                    int contributed = _totalBets[seat] < level ? _totalBets[seat] : level;
+                    if (contributed > previousLevel) layer += contributed - previousLevel;
+                    if ((_inHandMask & (1u << seat)) && _totalBets[seat] >= level) {
+                        if (handValues[seat] > best) {
+                            best = handValues[seat];
+                            winners = 1u << seat;
+                        } else if (handValues[seat] == best) {
+                            winners |= 1u << seat;
+                        }
+                    }
+                }
+                if (winners == 0) {
+                    // only folded money at this level; it goes to whoever is left with the most in
+                    for (int seat = 0; seat < _numSeats; seat++) {
+                        if ((_inHandMask & (1u << seat)) && (winners == 0 || _totalBets[seat] > _totalBets[__builtin_ctz(winners)])) {
+                            winners = 1u << seat;
+                        }
+                    }
+                }
+
+                int share = layer / __builtin_popcount(winners);
+                int oddChips = layer - share * __builtin_popcount(winners);
+                for (int i = 1; i <= _numSeats; i++) {
+                    int seat = (_button + i) % _numSeats;
+                    if (winners & (1u << seat)) {
+                        won[seat] += share;
+                        if (oddChips > 0) {
+                            won[seat]++;
+                            oddChips--;
+                        }
+                    }
+                }
+                previousLevel = level;
+            }
+        }
+
+        for (int seat = 0; seat < _numSeats; seat++) {
+            _stacks[seat] += won[seat];
+            _payoffs[seat] = won[seat] - _totalBets[seat];
+        }
+        _phase = GamePhase::showdown;
+        _handOver = true;
+        _currentSeat = -1;
+    }
+};
+
+// Every supported specialization; 2, 6 and 10 seats cover heads-up, 6-max and full ring
+using AnyTableEngine = std::variant<
+    TableEngine<BettingStructure::NO_LIMIT, 2>,
+    TableEngine<BettingStructure::NO_LIMIT, 6>,
+    TableEngine<BettingStructure::NO_LIMIT, 10>,
+    TableEngine<BettingStructure::POT_LIMIT, 2>,
+    TableEngine<BettingStructure::POT_LIMIT, 6>,
+    TableEngine<BettingStructure::POT_LIMIT, 10>,
+    TableEngine<BettingStructure::FIXED_LIMIT, 2>,
+    TableEngine<BettingStructure::FIXED_LIMIT, 6>,
+    TableEngine<BettingStructure::FIXED_LIMIT, 10>>;
+
+// Picks the specialization once, when the table is created. Drive it with std::visit so the
+// loop inside the visitor is compiled against the concrete engine:
+//     AnyTableEngine table = makeTableEngine(rules, 6);
+//     std::visit([&](auto& engine) { for (...) engine.playHand(policy); }, table);
+AnyTableEngine makeTableEngine(const RuleSet& rules, int numSeats);
+
+extern template class TableEngine<BettingStructure::NO_LIMIT, 2>;
+extern template class TableEngine<BettingStructure::NO_LIMIT, 6>;
+extern template class TableEngine<BettingStructure::NO_LIMIT, 10>;
+extern template class TableEngine<BettingStructure::POT_LIMIT, 2>;
+extern template class TableEngine<BettingStructure::POT_LIMIT, 6>;
+extern template class TableEngine<BettingStructure::POT_LIMIT, 10>;
+extern template class TableEngine<BettingStructure::FIXED_LIMIT, 2>;
+extern template class TableEngine<BettingStructure::FIXED_LIMIT, 6>;
+extern template class TableEngine<BettingStructure::FIXED_LIMIT, 10>;
+
+#endif // TABLEENGINE_H
@@ -0,0 +1,141 @@
+#include "tableexecutor.h"
+#include <thread>
+
+using namespace std;
+
+TableExecutor::TableExecutor()
+    : _numFinished(0), _handsPlayed(0), _decisions(0) {
+}
+
+TableExecutor::~TableExecutor() {
+    for (Table& table : _tables) {
+        if (table.task.handle) table.task.handle.destroy();
+    }
+}
+
+int TableExecutor::addTable(shared_ptr<GameManager> table, int numHands) {
+    int index = static_cast<int>(_tables.size());
+    _tables.push_back({table, numHands, TableTask{}, nullptr});
+    _tables[index].task = playTable(index);
+    _ready.push_back(index);
+    return index;
+}
+
+bool TableExecutor::runOnce(int timeoutMs) {
+    _running.swap(_ready);
+    exception_ptr error;
+    for (int index : _running) {
+        exception_ptr thrown = resume(index);
+        if (thrown && !error) error = thrown;
+    }
+    _running.clear();
+    if (error) rethrow_exception(error);
+
+    bool progressed = collect();
+    if (!progressed && _ready.empty() && !_waiting.empty() && timeoutMs != 0) {
+        waitForAgents(timeoutMs);
+        collect();
+    }
+    return _numFinished < static_cast<int>(_tables.size());
+}
+
+void TableExecutor::run() {
+    while (runOnce()) {
+    }
+}
+
+// The table's whole run: hands until it has played its share or the game is over, each
+// decision awaited. Locals live in the coroutine frame while the table is parked.
+TableExecutor::TableTask TableExecutor::playTable(int index) {
+    shared_ptr<GameManager> game = _tables[index].game;
+    while (_tables[index].handsLeft > 0 && !game->isGameOver()) {
+        game->beginHand();
+        _tables[index].handsLeft--;
+        _handsPlayed++;
+
+        while (game->isAwaitingDecision()) {
+            Player* player = game->getPlayer(game->getDecisionSeat()).get();
+            AsyncPlayer* async = dynamic_cast<AsyncPlayer*>(player);
+            _decisions++;
+            if (async) {
+                // a named awaiter, so the action it fills in stays put in the frame
+                Decision decision{this, index, async, PlayerAction(Action::fold)};
+                game->applyDecision(co_await decision);
+            } else {
+                game->applyDecision(player->makeDecision(game->getGameState(), game.get()));
+            }
+        }
+    }
+}
+
+// Runs the table on until it parks on a decision or finishes; returns what it threw, if it did.
+exception_ptr TableExecutor::resume(int index) {
+    coroutine_handle<TableTask::promise_type> handle = _tables[index].task.handle;
+    handle.resume();
+    if (!handle.done()) return nullptr;
+    _numFinished++;
+    return handle.promise().error;
+}
+
+bool TableExecutor::Decision::await_ready() {
+    GameManager& game = *executor->_tables[index].game;
+    player->beginDecision(game.getGameState(), &game);
+    return player->pollDecision(action);
+}
+
+void TableExecutor::Decision::await_suspend(coroutine_handle<> /*table*/) {
+    // the handle is the table's own task, which the executor already holds
+    executor->_tables[index].pending = this;
+    executor->_waiting.push_back(index);
+}
+
+// Marks every parked table whose action has arrived as ready. True if any did.
+bool TableExecutor::collect() {
+    size_t kept = 0;
+    bool progressed = false;
+    for (size_t i = 0; i < _waiting.size(); i++) {
+        int index = _waiting[i];
+        Table& table = _tables[index];
+        if (table.pending->player->pollDecision(table.pending->action)) {
+            table.pending = nullptr;
+            _ready.push_back(index);
+            progressed = true;
+        } else {
+            _waiting[kept++] = index;
+        }
+    }
+    _waiting.resize(kept);
+    return progressed;
+}
+
+void TableExecutor::waitForAgents(int timeoutMs) {
+    _pollFds.clear();
+    for (int index : _waiting) {
+        int fd = _tables[index].pending->player->getWaitFd();
+        if (fd < 0) {
+            // someone can only be polled blindly, so don't sleep on the others
+            this_thread::yield();
+            return;
+        }
+        bool seen = false;
+        for (const pollfd& entry : _pollFds) seen = seen || entry.fd == fd;
+        if (!seen) _pollFds.push_back({fd, POLLIN, 0});
+    }
+    ::poll(_pollFds.data(), _pollFds.size(), timeoutMs);
+}
+
+int TableExecutor::getNumTables() const {
+    return static_cast<int>(_tables.size());
+}
+
+int TableExecutor::getNumWaiting() const {
+    return static_cast<int>(_waiting.size());
+}
+
+long long TableExecutor::getHandsPlayed() const {
+    return _handsPlayed;
+}
+
+long long TableExecutor::getDecisions() const {
+    return _decisions;
+}
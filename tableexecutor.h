@@ -0,0 +1,90 @@
+#ifndef TABLEEXECUTOR_H
+#define TABLEEXECUTOR_H
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <vector>
+#include <poll.h>
+#include "gamemanager.h"
+#include "asyncplayer.h"
+
+// Single-threaded event loop over many GameManager tables. Each table's game loop is a
+// C++20 coroutine that co_awaits every decision: an AsyncPlayer that has no answer yet
+// suspends it, and the thread moves on to other tables. Suspended tables are polled each pass
+// and resumed as their actions come in. When nothing is runnable the loop sleeps in poll(2)
+// on the agents' descriptors (or yields if none of them has one). Ordinary players are still
+// called inline.
+class TableExecutor
+{
+public:
+    TableExecutor();
+    ~TableExecutor();
+    TableExecutor(const TableExecutor&) = delete;
+    TableExecutor& operator=(const TableExecutor&) = delete;
+
+    int addTable(std::shared_ptr<GameManager> table, int numHands);
+    // One pass: resume the ready tables, collect finished decisions, and if that made no
+    // progress wait up to timeoutMs for an agent. False once every table is finished.
+    // An exception thrown at a table ends that table and is rethrown here.
+    bool runOnce(int timeoutMs = 10);
+    void run();
+
+    int getNumTables() const;
+    int getNumWaiting() const;
+    long long getHandsPlayed() const;
+    long long getDecisions() const;
+
+private:
+    // A table's coroutine: created suspended, resumed only by the executor.
+    struct TableTask {
+        struct promise_type {
+            std::exception_ptr error;
+
+            TableTask get_return_object() {
+                return TableTask{std::coroutine_handle<promise_type>::from_promise(*this)};
+            }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { error = std::current_exception(); }
+        };
+
+        std::coroutine_handle<promise_type> handle;
+    };
+
+    // co_await on an AsyncPlayer's decision: ready at once if the first poll has it,
+    // otherwise the table is parked until collect() sees the action.
+    struct Decision {
+        TableExecutor* executor;
+        int index;
+        AsyncPlayer* player;
+        PlayerAction action;
+
+        bool await_ready();
+        void await_suspend(std::coroutine_handle<> table);
+        PlayerAction await_resume() const { return action; }
+    };
+
+    struct Table {
+        std::shared_ptr<GameManager> game;
+        int handsLeft;
+        TableTask task;
+        Decision* pending;   // the decision the table is parked on, null when runnable
+    };
+
+    std::vector<Table> _tables;
+    std::vector<int> _ready;
+    std::vector<int> _running;
+    std::vector<int> _waiting;
+    std::vector<pollfd> _pollFds;
+    int _numFinished;
+    long long _handsPlayed;
+    long long _decisions;
+
+    TableTask playTable(int index);
+    std::exception_ptr resume(int index);
+    bool collect();
+    void waitForAgents(int timeoutMs);
+};
+
+#endif // TABLEEXECUTOR_H
@@ -0,0 +1,219 @@
+// Differential test of HeadsUpEngine against GameManager.
+//
+// Both tables play the same heads-up matches hand by hand. GameManager deals from its seeded
+// deck and the engine is handed the same cards (setNextDeal); one policy then decides for both,
+// from what each table shows the player to act, with dice seeded per hand. After every hand the
+// stacks and payoffs must agree. The first difference in a match is printed with both tables'
+// actions, and the run fails if there was any.
+//
+// A match ends after a fixed number of hands or once a stack is down to the small blind: a
+// hand that short can finish inside beginHand(), before GameManager shows its cards.
+//
+// Standalone, so pkbot.pro leaves it out of the app. Built from the project directory against
+// the project sources and libcs106, e.g.
+//   g++ -std=c++20 -O2 -I. -I<cs106>/include tests/headsupdiff.cpp $(ls *.cpp | grep -v main.cpp)
+//       -L<cs106>/lib -lcs106 -lpthread -o headsupdiff
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "gamemanager.h"
+#include "headsupengine.h"
+#include "randombot.h"
+
+using namespace std;
+
+namespace {
+
+const int kMatches = 1000;
+const int kHandsPerMatch = 200;
+
+// What the player to act sees, the same way on both tables.
+struct Spot {
+    int stack;
+    int roundBet;
+    int currentBet;
+    int pot;              // everything put in this hand, this round included
+    int raises;           // bets and raises so far this round
+    bool opponentAllIn;
+};
+
+// Mixes folds, calls, raises of every legal size and all-ins. Legality follows the rules the
+// engine enforces (RuleSet's sizing, the fixed-limit cap, no raising an all-in player), which
+// GameManager accepts as well.
+PlayerAction choose(const RuleSet& rules, const Spot& spot, EngineRng& dice) {
+    int toCall = spot.currentBet - spot.roundBet;
+    int allInTo = spot.roundBet + spot.stack;
+    bool capped = rules.getBettingType() == BettingStructure::FIXED_LIMIT && spot.raises >= rules.getMaxRaises();
+    bool canRaise = !spot.opponentAllIn && !capped && allInTo > spot.currentBet;
+    int minRaiseTo = rules.getMinimumRaise(spot.currentBet);
+    int maxRaiseTo = rules.getMaximumBet(spot.currentBet, allInTo, spot.pot);
+    bool allInLegal = allInTo <= spot.currentBet || (canRaise && allInTo <= maxRaiseTo);
+    maxRaiseTo = min(maxRaiseTo, allInTo);
+    bool raiseLegal = canRaise && minRaiseTo <= maxRaiseTo;
+
+    int roll = dice.below(100);
+    if (toCall > 0 && roll < 15) return PlayerAction(Action::fold);
+    if (toCall >= spot.stack) return PlayerAction(Action::all_in);   // a call puts it all in
+    if (roll >= 15 && roll < 19 && allInLegal) return PlayerAction(Action::all_in);
+    if (roll >= 65 && raiseLegal) {
+        int amount = minRaiseTo + dice.below((maxRaiseTo - minRaiseTo) / 8 + 1);
+        return PlayerAction(spot.currentBet == 0 ? Action::bet : Action::raise, amount);
+    }
+    return toCall > 0 ? PlayerAction(Action::call, toCall) : PlayerAction(Action::check);
+}
+
+// Counts the round's raises for the policy; neither table exposes its own count.
+struct RaiseCounter {
+    GamePhase phase = GamePhase::showdown;
+    int raises = 0;
+
+    int get(GamePhase now) {
+        if (now != phase) {
+            phase = now;
+            raises = 0;
+        }
+        return raises;
+    }
+    void record(const PlayerAction& action, const Spot& spot) {
+        bool allInRaise = action.actionType == Action::all_in && spot.roundBet + spot.stack > spot.currentBet;
+        if (action.actionType == Action::bet || action.actionType == Action::raise || allInRaise) raises++;
+    }
+};
+
+string describe(const PlayerAction& action, int seat) {
+    ostringstream out;
+    out << " " << seat << ":" << static_cast<int>(action.actionType);
+    if (action.actionType == Action::bet || action.actionType == Action::raise) out << "/" << action.amount;
+    return out.str();
+}
+
+// One match; returns the number of hands played, or -1 after printing the first difference.
+template <BettingStructure Structure>
+int playMatch(const RuleSet& rules, uint64_t seed, ostream& out) {
+    GameManager game(rules);
+    game.setVerbose(false);
+    game.setSeed(seed);
+    shared_ptr<Player> players[2] = {make_shared<RandomBot>("seat0", rules.getStartingChips()),
+                                     make_shared<RandomBot>("seat1", rules.getStartingChips())};
+    game.addPlayer(players[0]);
+    game.addPlayer(players[1]);
+
+    // GameManager's first button is seat 1; the engine moves its button before every hand
+    HeadsUpEngine<Structure> engine(rules);
+    engine.setButton(0);
+
+    int hand = 0;
+    for (; hand < kHandsPerMatch; hand++) {
+        int before[2] = {players[0]->getChips(), players[1]->getChips()};
+        if (min(before[0], before[1]) <= rules.getSmallBlind()) break;
+        uint64_t handSeed = EngineRng(seed * kHandsPerMatch + hand).next();
+
+        game.beginHand();
+        if (!game.isAwaitingDecision()) break;   // cannot happen above a small blind
+        uint8_t cards[9];
+        for (int seat = 0; seat < 2; seat++) {
+            const vector<Card>& hole = players[seat]->getHand().getCards();
+            cards[2 * seat] = static_cast<uint8_t>(hole[0].getIndex());
+            cards[2 * seat + 1] = static_cast<uint8_t>(hole[1].getIndex());
+        }
+        string managerActions;
+        EngineRng managerDice(handSeed);
+        RaiseCounter managerRaises;
+        while (game.isAwaitingDecision()) {
+            int seat = game.getDecisionSeat();
+            const shared_ptr<Player>& player = game.getPlayer(seat);
+            const shared_ptr<Player>& opponent = game.getPlayer(seat ^ 1);
+            Spot spot;
+            spot.stack = player->getChips();
+            spot.roundBet = player->getRoundBet();
+            spot.currentBet = game.getGameState().getCurrentBet();
+            spot.pot = player->getTotalBet() + opponent->getTotalBet();
+            spot.raises = managerRaises.get(game.getGameState().getCurrentPhase());
+            spot.opponentAllIn = opponent->isAllIn();
+            PlayerAction action = choose(rules, spot, managerDice);
+            managerRaises.record(action, spot);
+            managerActions += describe(action, seat);
+            game.applyDecision(action);
+        }
+
+        // board cards the hand never reached are filled in from the rest of the deck
+        const vector<Card>& board = game.getGameState().getCommunityCards();
+        uint64_t used = 0;
+        for (int i = 0; i < 4; i++) used |= 1ull << cards[i];
+        for (size_t i = 0; i < board.size(); i++) {
+            cards[4 + i] = static_cast<uint8_t>(board[i].getIndex());
+            used |= 1ull << cards[4 + i];
+        }
+        for (int i = 4 + static_cast<int>(board.size()), card = 0; i < 9; i++) {
+            while (used & (1ull << card)) card++;
+            cards[i] = static_cast<uint8_t>(card);
+            used |= 1ull << card;
+        }
+
+        engine.setNextDeal(cards);
+        engine.startHand();
+        string engineActions;
+        EngineRng engineDice(handSeed);
+        RaiseCounter engineRaises;
+        bool refused = false;
+        while (!engine.isHandOver() && !refused) {
+            int seat = engine.getCurrentSeat();
+            Spot spot;
+            spot.stack = engine.getStack(seat);
+            spot.roundBet = engine.getRoundBet(seat);
+            spot.currentBet = engine.getCurrentBet();
+            spot.pot = engine.getPotSize();
+            spot.raises = engineRaises.get(engine.getPhase());
+            spot.opponentAllIn = (engine.getAllInMask() >> (seat ^ 1)) & 1u;
+            PlayerAction action = choose(rules, spot, engineDice);
+            engineRaises.record(action, spot);
+            engineActions += describe(action, seat);
+            refused = !engine.applyAction(action);
+        }
+
+        bool same = !refused;
+        for (int seat = 0; seat < 2; seat++) {
+            int payoff = players[seat]->getChips() - before[seat];
+            same = same && players[seat]->getChips() == engine.getStack(seat) && payoff == engine.getPayoff(seat);
+        }
+        if (!same) {
+            out << "  seed " << seed << ", hand " << hand + 1 << (refused ? ": the engine refused an action" : "")
+                 << "\n    GameManager stacks " << players[0]->getChips() << " / " << players[1]->getChips()
+                 << ", actions" << managerActions
+                 << "\n    HeadsUpEngine stacks " << engine.getStack(0) << " / " << engine.getStack(1)
+                 << ", actions" << engineActions << endl;
+            return -1;
+        }
+    }
+    return hand;
+}
+
+template <BettingStructure Structure>
+int runStructure(const string& name, const RuleSet& rules, ostream& out) {
+    int failures = 0;
+    long long hands = 0;
+    for (int match = 0; match < kMatches; match++) {
+        int played = playMatch<Structure>(rules, match + 1, out);
+        if (played < 0) {
+            failures++;
+        } else {
+            hands += played;
+        }
+    }
+    out << name << ": " << kMatches << " matches, " << hands << " hands agreed, " << failures << " differed" << endl;
+    return failures;
+}
+
+}
+
+int main() {
+    int failures = runStructure<BettingStructure::NO_LIMIT>("no limit, 40bb", RuleSet(5, 10, 400), cout)
+        + runStructure<BettingStructure::NO_LIMIT>("no limit, 100bb", RuleSet::createCashGame(5, 10), cout)
+        + runStructure<BettingStructure::POT_LIMIT>("pot limit", RuleSet::createPotLimit(5, 10), cout)
+        + runStructure<BettingStructure::FIXED_LIMIT>("fixed limit", RuleSet::createFixedLimit(5, 10), cout);
+    return failures == 0 ? 0 : 1;
+}
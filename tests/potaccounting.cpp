@@ -0,0 +1,170 @@
+// Regression test for GameManager's chip accounting.
+//
+// Three-handed spots played out over many seeded deals, each checked against payouts worked out
+// here from the contributions, the cards and the hand ranks:
+//   calls      a raise and two calls, then checks: bets and calls come out of the stacks
+//   side pots  three all-ins of different sizes: a main pot and a side pot, each paid to the
+//              best hand among the players who put in that much
+//   uncalled   a shove the other players cover only in part: the part nobody could call goes
+//              back to the shover, and the blind that folded stays in the pot
+// Stacks are chosen so every pot splits evenly, so the odd-chip rule doesn't come into it.
+// Chips must be conserved; a player who lost everything must be gone from the table.
+//
+// Standalone, so pkbot.pro leaves it out of the app. Built from the project directory against
+// the project sources and libcs106, e.g.
+//   g++ -std=c++20 -O2 -I. -I<cs106>/include tests/potaccounting.cpp $(ls *.cpp | grep -v main.cpp)
+//       -L<cs106>/lib -lcs106 -lpthread -o potaccounting
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "gamemanager.h"
+#include "handstrengthevaluator.h"
+#include "randombot.h"
+
+using namespace std;
+
+namespace {
+
+const int kDeals = 500;
+const int kSeats = 3;
+
+// The first deal's button is seat 1, so seat 1 acts first before the flop, then the small
+// blind (seat 2) and the big blind (seat 0).
+struct Spot {
+    string name;
+    int stacks[kSeats];
+    // what the seat does when asked, given the bet it faces
+    PlayerAction (*decide)(int seat, int toCall, int stack, int currentBet, GamePhase phase);
+    int contributions[kSeats];   // what each seat ends up putting in
+    bool folded[kSeats];
+};
+
+PlayerAction raiseAndCall(int /*seat*/, int toCall, int /*stack*/, int currentBet, GamePhase phase) {
+    if (phase == GamePhase::preflop && currentBet < 60) return PlayerAction(Action::raise, 60);
+    return toCall > 0 ? PlayerAction(Action::call, toCall) : PlayerAction(Action::check);
+}
+
+PlayerAction shove(int /*seat*/, int /*toCall*/, int /*stack*/, int /*currentBet*/, GamePhase /*phase*/) {
+    return PlayerAction(Action::all_in);
+}
+
+PlayerAction shoveOverBigBlind(int seat, int toCall, int stack, int currentBet, GamePhase phase) {
+    if (seat == 0) return PlayerAction(Action::fold);
+    return shove(seat, toCall, stack, currentBet, phase);
+}
+
+// Chips each seat should hold after the hand: every level of contribution is a pot for the
+// best hands among the live seats that put in at least that much.
+vector<int> expectedStacks(const Spot& spot, const uint8_t hole[][2], const vector<Card>& board) {
+    int ranks[kSeats];
+    for (int seat = 0; seat < kSeats; seat++) {
+        uint8_t cards[7] = {hole[seat][0], hole[seat][1]};
+        for (int i = 0; i < 5; i++) cards[2 + i] = static_cast<uint8_t>(board[i].getIndex());
+        ranks[seat] = HandStrengthEvaluator::rankCards(cards, 7);
+    }
+    vector<int> stacks(kSeats);
+    for (int seat = 0; seat < kSeats; seat++) stacks[seat] = spot.stacks[seat] - spot.contributions[seat];
+
+    vector<int> levels(spot.contributions, spot.contributions + kSeats);
+    sort(levels.begin(), levels.end());
+    int previous = 0;
+    for (int level : levels) {
+        if (level == previous) continue;
+        int amount = 0;
+        int best = -1;
+        vector<int> winners;
+        for (int seat = 0; seat < kSeats; seat++) {
+            amount += min(spot.contributions[seat], level) - min(spot.contributions[seat], previous);
+            if (spot.folded[seat] || spot.contributions[seat] < level) continue;
+            if (ranks[seat] > best) {
+                best = ranks[seat];
+                winners.clear();
+            }
+            if (ranks[seat] == best) winners.push_back(seat);
+        }
+        for (int seat : winners) stacks[seat] += amount / static_cast<int>(winners.size());
+        previous = level;
+    }
+    return stacks;
+}
+
+// Plays the spot once; returns an empty string when the table paid out as expected.
+string playDeal(const Spot& spot, uint64_t seed) {
+    GameManager game(RuleSet(5, 10, 1000));
+    game.setSeed(seed);
+    vector<shared_ptr<Player>> players;
+    for (int seat = 0; seat < kSeats; seat++) {
+        players.push_back(make_shared<RandomBot>("seat" + to_string(seat), spot.stacks[seat]));
+        game.addPlayer(players.back());
+    }
+
+    game.beginHand();
+    // the cards are read before anyone can bust and leave the table
+    uint8_t hole[kSeats][2];
+    for (int seat = 0; seat < kSeats; seat++) {
+        const vector<Card>& cards = players[seat]->getHand().getCards();
+        hole[seat][0] = static_cast<uint8_t>(cards[0].getIndex());
+        hole[seat][1] = static_cast<uint8_t>(cards[1].getIndex());
+    }
+    while (game.isAwaitingDecision()) {
+        int seat = game.getDecisionSeat();
+        const shared_ptr<Player>& player = game.getPlayer(seat);
+        int currentBet = game.getGameState().getCurrentBet();
+        int toCall = currentBet - player->getRoundBet();
+        game.applyDecision(spot.decide(seat, toCall, player->getChips(), currentBet, game.getGameState().getCurrentPhase()));
+    }
+
+    const vector<Card>& board = game.getGameState().getCommunityCards();
+    if (board.size() != 5) return "the board was not dealt out";
+    vector<int> expected = expectedStacks(spot, hole, board);
+
+    ostringstream problem;
+    vector<shared_ptr<Player>> seated = game.getPlayers();
+    int total = 0;
+    for (int seat = 0; seat < kSeats; seat++) {
+        bool stillSeated = find(seated.begin(), seated.end(), players[seat]) != seated.end();
+        int chips = stillSeated ? players[seat]->getChips() : 0;
+        total += chips;
+        if (chips != expected[seat] || stillSeated != (expected[seat] > 0)) {
+            problem << " seat " << seat << " has " << chips << (stillSeated ? "" : " (left the table)")
+                    << ", expected " << expected[seat] << ";";
+        }
+    }
+    int before = spot.stacks[0] + spot.stacks[1] + spot.stacks[2];
+    if (total != before) problem << " " << before << " chips became " << total << ";";
+    return problem.str();
+}
+
+}
+
+int main() {
+    const Spot spots[] = {
+        {"calls", {1000, 1000, 1000}, raiseAndCall, {60, 60, 60}, {false, false, false}},
+        {"side pots", {100, 1000, 300}, shove, {100, 1000, 300}, {false, false, false}},
+        {"uncalled", {1000, 1000, 250}, shoveOverBigBlind, {10, 1000, 250}, {true, false, false}},
+    };
+
+    // the table narrates every hand; only the results are wanted here
+    ostringstream narration;
+    streambuf* console = cout.rdbuf(narration.rdbuf());
+    int failures = 0;
+    vector<string> report;
+    for (const Spot& spot : spots) {
+        int failed = 0;
+        for (int deal = 0; deal < kDeals; deal++) {
+            string problem = playDeal(spot, deal + 1);
+            narration.str("");
+            if (problem.empty()) continue;
+            if (failed++ == 0) report.push_back("  " + spot.name + ", seed " + to_string(deal + 1) + ":" + problem);
+        }
+        report.push_back(spot.name + ": " + to_string(kDeals) + " deals, " + to_string(failed) + " wrong");
+        failures += failed;
+    }
+    cout.rdbuf(console);
+    for (const string& line : report) cout << line << endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,234 @@
+// Differential test of TableEngine against GameManager, three to six handed.
+//
+// Both tables play the same matches hand by hand, the engine as makeTableEngine() builds it.
+// GameManager deals from its seeded deck and the engine is handed the same cards (setNextDeal);
+// one policy then decides for both, from what each table shows the player to act, with dice
+// seeded per hand. After every hand the stacks and payoffs must agree. The first difference in
+// a match is printed with both tables' actions, and the run fails if there was any.
+//
+// A match ends after a fixed number of hands or once a stack is down to the big blind, so the
+// blinds never put anyone all in and nobody is knocked out: GameManager drops a busted player
+// from the table, the engine only stops dealing to the seat.
+//
+// Standalone, so pkbot.pro leaves it out of the app. Built from the project directory against
+// the project sources and libcs106, e.g.
+//   g++ -std=c++20 -O2 -I. -I<cs106>/include tests/tableenginediff.cpp $(ls *.cpp | grep -v main.cpp)
+//       -L<cs106>/lib -lcs106 -lpthread -o tableenginediff
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <variant>
+#include <vector>
+#include "gamemanager.h"
+#include "randombot.h"
+#include "tableengine.h"
+
+using namespace std;
+
+namespace {
+
+const int kMatches = 1000;
+const int kHandsPerMatch = 100;
+const int kMaxSeats = 6;
+
+// What the player to act sees, the same way on both tables.
+struct Spot {
+    int stack;
+    int roundBet;
+    int currentBet;
+    int pot;              // everything put in this hand, this round included
+    int raises;           // bets and raises so far this round
+    bool opponentsCanAct; // someone else is neither folded nor all in
+};
+
+// Mixes folds (now and then even with a free check), short calls, raises of every legal size and
+// all-ins. Legality follows the rules the tables enforce (RuleSet's sizing, the fixed-limit cap,
+// no raising when nobody can answer), worked out here independently of either table.
+PlayerAction choose(const RuleSet& rules, const Spot& spot, EngineRng& dice) {
+    int toCall = spot.currentBet - spot.roundBet;
+    int allInTo = spot.roundBet + spot.stack;
+    bool capped = rules.getBettingType() == BettingStructure::FIXED_LIMIT && spot.raises >= rules.getMaxRaises();
+    bool canRaise = spot.opponentsCanAct && !capped && allInTo > spot.currentBet;
+    int minRaiseTo = rules.getMinimumRaise(spot.currentBet);
+    int maxRaiseTo = rules.getMaximumBet(spot.currentBet, allInTo, spot.pot);
+    bool allInLegal = allInTo <= spot.currentBet || (canRaise && allInTo <= maxRaiseTo);
+    maxRaiseTo = min(maxRaiseTo, allInTo);
+    bool raiseLegal = canRaise && minRaiseTo <= maxRaiseTo;
+
+    int roll = dice.below(100);
+    if (roll < (toCall > 0 ? 20 : 2)) return PlayerAction(Action::fold);
+    if (toCall >= spot.stack) {
+        // a call puts it all in, whichever way it is asked for
+        return roll % 2 ? PlayerAction(Action::all_in) : PlayerAction(Action::call, toCall);
+    }
+    if (roll >= 20 && roll < 23 && allInLegal) return PlayerAction(Action::all_in);
+    if (roll >= 70 && raiseLegal) {
+        int amount = minRaiseTo + dice.below((maxRaiseTo - minRaiseTo) / 8 + 1);
+        return PlayerAction(spot.currentBet == 0 ? Action::bet : Action::raise, amount);
+    }
+    return toCall > 0 ? PlayerAction(Action::call, toCall) : PlayerAction(Action::check);
+}
+
+// Counts the round's raises for the policy; neither table exposes its own count.
+struct RaiseCounter {
+    GamePhase phase = GamePhase::showdown;
+    int raises = 0;
+
+    int get(GamePhase now) {
+        if (now != phase) {
+            phase = now;
+            raises = 0;
+        }
+        return raises;
+    }
+    void record(const PlayerAction& action, const Spot& spot) {
+        bool allInRaise = action.actionType == Action::all_in && spot.roundBet + spot.stack > spot.currentBet;
+        if (action.actionType == Action::bet || action.actionType == Action::raise || allInRaise) raises++;
+    }
+};
+
+string describe(const PlayerAction& action, int seat) {
+    ostringstream out;
+    out << " " << seat << ":" << static_cast<int>(action.actionType);
+    if (action.actionType == Action::bet || action.actionType == Action::raise) out << "/" << action.amount;
+    return out.str();
+}
+
+// One match; returns the number of hands played, or -1 after printing the first difference.
+// Engine is whichever specialization makeTableEngine() picked for the rules and seats.
+template <typename Engine>
+int playMatch(const RuleSet& rules, int numSeats, Engine& engine, uint64_t seed, ostream& out) {
+    GameManager game(rules);
+    game.setVerbose(false);
+    game.setSeed(seed);
+    vector<shared_ptr<Player>> players;
+    for (int seat = 0; seat < numSeats; seat++) {
+        players.push_back(make_shared<RandomBot>("seat" + to_string(seat), rules.getStartingChips()));
+        game.addPlayer(players.back());
+    }
+
+    // GameManager's first button is seat 1; the engine moves its button before every hand
+    engine.setButton(0);
+
+    int hand = 0;
+    for (; hand < kHandsPerMatch; hand++) {
+        vector<int> before(numSeats);
+        for (int seat = 0; seat < numSeats; seat++) before[seat] = players[seat]->getChips();
+        if (*min_element(before.begin(), before.end()) <= rules.getBigBlind()) break;
+        uint64_t handSeed = EngineRng(seed * kHandsPerMatch + hand).next();
+
+        game.beginHand();
+        if (!game.isAwaitingDecision()) break;   // cannot happen above a big blind
+        uint8_t cards[kMaxSeats * 2 + 5];
+        uint64_t used = 0;
+        for (int seat = 0; seat < numSeats; seat++) {
+            const vector<Card>& hole = players[seat]->getHand().getCards();
+            cards[2 * seat] = static_cast<uint8_t>(hole[0].getIndex());
+            cards[2 * seat + 1] = static_cast<uint8_t>(hole[1].getIndex());
+            used |= (1ull << cards[2 * seat]) | (1ull << cards[2 * seat + 1]);
+        }
+        string managerActions;
+        EngineRng managerDice(handSeed);
+        RaiseCounter managerRaises;
+        while (game.isAwaitingDecision()) {
+            int seat = game.getDecisionSeat();
+            const shared_ptr<Player>& player = game.getPlayer(seat);
+            Spot spot;
+            spot.stack = player->getChips();
+            spot.roundBet = player->getRoundBet();
+            spot.currentBet = game.getGameState().getCurrentBet();
+            spot.pot = 0;
+            spot.opponentsCanAct = false;
+            for (int other = 0; other < numSeats; other++) {
+                const shared_ptr<Player>& opponent = game.getPlayer(other);
+                spot.pot += opponent->getTotalBet();
+                if (other != seat && !opponent->isFolded() && !opponent->isAllIn()) spot.opponentsCanAct = true;
+            }
+            spot.raises = managerRaises.get(game.getGameState().getCurrentPhase());
+            PlayerAction action = choose(rules, spot, managerDice);
+            managerRaises.record(action, spot);
+            managerActions += describe(action, seat);
+            game.applyDecision(action);
+        }
+
+        // board cards the hand never reached are filled in from the rest of the deck
+        uint8_t* board = cards + 2 * numSeats;
+        const vector<Card>& dealt = game.getGameState().getCommunityCards();
+        for (size_t i = 0; i < dealt.size(); i++) {
+            board[i] = static_cast<uint8_t>(dealt[i].getIndex());
+            used |= 1ull << board[i];
+        }
+        for (int i = static_cast<int>(dealt.size()), card = 0; i < 5; i++) {
+            while (used & (1ull << card)) card++;
+            board[i] = static_cast<uint8_t>(card);
+            used |= 1ull << card;
+        }
+
+        engine.setNextDeal(cards);
+        engine.startHand();
+        string engineActions;
+        EngineRng engineDice(handSeed);
+        RaiseCounter engineRaises;
+        bool refused = false;
+        while (!engine.isHandOver() && !refused) {
+            int seat = engine.getCurrentSeat();
+            Spot spot;
+            spot.stack = engine.getStack(seat);
+            spot.roundBet = engine.getRoundBet(seat);
+            spot.currentBet = engine.getCurrentBet();
+            spot.pot = engine.getPotSize();
+            spot.raises = engineRaises.get(engine.getPhase());
+            spot.opponentsCanAct = (engine.canActMask() & ~(1u << seat)) != 0;
+            PlayerAction action = choose(rules, spot, engineDice);
+            engineRaises.record(action, spot);
+            engineActions += describe(action, seat);
+            refused = !engine.applyAction(action);
+        }
+
+        bool same = !refused;
+        for (int seat = 0; seat < numSeats; seat++) {
+            int payoff = players[seat]->getChips() - before[seat];
+            same = same && players[seat]->getChips() == engine.getStack(seat) && payoff == engine.getPayoff(seat);
+        }
+        if (!same) {
+            out << "  seed " << seed << ", " << numSeats << " seats, hand " << hand + 1
+                << (refused ? ": the engine refused an action" : "") << "\n    GameManager stacks";
+            for (int seat = 0; seat < numSeats; seat++) out << " " << players[seat]->getChips();
+            out << ", actions" << managerActions << "\n    TableEngine stacks";
+            for (int seat = 0; seat < numSeats; seat++) out << " " << engine.getStack(seat);
+            out << ", actions" << engineActions << endl;
+            return -1;
+        }
+    }
+    return hand;
+}
+
+int runStructure(const string& name, const RuleSet& rules, ostream& out) {
+    int failures = 0;
+    long long hands = 0;
+    for (int match = 0; match < kMatches; match++) {
+        int numSeats = 3 + match % (kMaxSeats - 2);
+        AnyTableEngine table = makeTableEngine(rules, numSeats);
+        int played = visit([&](auto& engine) { return playMatch(rules, numSeats, engine, match + 1, out); }, table);
+        if (played < 0) {
+            failures++;
+        } else {
+            hands += played;
+        }
+    }
+    out << name << ": " << kMatches << " matches, " << hands << " hands agreed, " << failures << " differed" << endl;
+    return failures;
+}
+
+}
+
+int main() {
+    int failures = runStructure("no limit, 40bb", RuleSet(5, 10, 400), cout)
+        + runStructure("no limit, 100bb", RuleSet::createCashGame(5, 10), cout)
+        + runStructure("pot limit", RuleSet::createPotLimit(5, 10), cout)
+        + runStructure("fixed limit", RuleSet::createFixedLimit(5, 10), cout);
+    return failures == 0 ? 0 : 1;
+}
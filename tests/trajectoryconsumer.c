@@ -0,0 +1,81 @@
+/*
+ * Trainer-side consumer of a trajectory ring in plain C. It checks that trajectoryring.h and
+ * its consumer API work from C, and is the smallest example of reading a ring from outside
+ * the simulator.
+ *
+ * Attaches to the named ring, waiting up to ten seconds for the producer to create it, reads
+ * records until nothing new has arrived for a second, then prints what it read alongside
+ * the producer's own counters.
+ *
+ * Standalone, so pkbot.pro leaves it out of the app. Compiled as C and linked with the ring,
+ * from the project directory:
+ *   gcc -std=c99 -Wall -Wextra -pedantic -I. -c tests/trajectoryconsumer.c
+ *   g++ -std=c++17 -I. -c trajectoryring.cpp
+ *   g++ trajectoryconsumer.o trajectoryring.o -lrt -o trajectoryconsumer
+ *   ./trajectoryconsumer /pk_selfplay_0
+ */
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <time.h>
+#include "trajectoryring.h"
+
+static double now(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+static void waitBriefly(void) {
+    struct timespec wait = {0, 1000000};   /* 1 ms */
+    nanosleep(&wait, NULL);
+}
+
+int main(int argc, char** argv) {
+    TrajectoryRingHeader* ring = NULL;
+    const TrajectoryRecord* record;
+    uint64_t ticket;
+    uint64_t records = 0;
+    uint64_t done = 0;
+    int64_t actions = 0;
+    double rewards = 0.0;
+    double start;
+    double last;
+    double elapsed;
+
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s <ring name>\n", argv[0]);
+        return 2;
+    }
+    start = now();
+    while (!(ring = trajectoryRingAttach(argv[1])) && now() - start < 10.0) waitBriefly();
+    if (!ring) {
+        fprintf(stderr, "could not attach to %s\n", argv[1]);
+        return 1;
+    }
+
+    start = now();
+    last = start;
+    while (now() - last < 1.0) {
+        record = trajectoryRingClaim(ring, &ticket);
+        if (!record) {
+            waitBriefly();
+            continue;
+        }
+        /* the record is read in place until it is released */
+        records++;
+        actions += record->action;
+        rewards += record->reward;
+        done += record->done;
+        trajectoryRingRelease(ring, ticket);
+        last = now();
+    }
+    elapsed = last - start;
+
+    printf("read %llu records (%llu done), action sum %lld, reward sum %.3f\n",
+           (unsigned long long)records, (unsigned long long)done, (long long)actions, rewards);
+    printf("producer wrote %llu, dropped %llu; %.0f records/s\n",
+           (unsigned long long)trajectoryRingWritten(ring), (unsigned long long)trajectoryRingDropped(ring),
+           elapsed > 0.0 ? records / elapsed : 0.0);
+    trajectoryRingDetach(ring);
+    return 0;
+}
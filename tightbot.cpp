@@ -5,14 +5,22 @@ TightBot::TightBot(const std::string& name, int chips, double tightness, double
     : Player(name, chips, position),
     _tightness(tightness),
     _aggressiveness(aggressiveness),
-    _bluffFrequency(0.2) {
+    _bluffFrequency(0.2),
+    _rng(std::random_device()()),
+    _cachedHole(0),
+    _cachedBoard(0),
+    _cachedPhase(GamePhase::preflop),
+    _cached(false),
+    _cachedStrength(0.0) {
 }
 
 PlayerAction TightBot::makeDecision(const Gamestate& gameState, GameManager* gameManager) {
 
-    float handStrength = evaluateHandStrength(gameState);
+    double handStrength = evaluateHandStrength(gameState);
 
     if (handStrength < _tightness) {
+        // too weak to put chips in, but a free look costs nothing
+        if (canCheck(gameState.getCurrentBet())) return PlayerAction(Action::check);
         return PlayerAction(Action::fold);
     }
 
@@ -23,8 +31,20 @@ PlayerAction TightBot::makeDecision(const Gamestate& gameState, GameManager* gam
     }
 }
 
-bool TightBot::shouldBeAggressive(const Gamestate& gameState) {
-    double randomRoll = (std::rand() % 100) / 100.0;
+void TightBot::setBluffFrequency(double bluffFrequency) {
+    _bluffFrequency = bluffFrequency;
+}
+
+void TightBot::setSeed(uint64_t seed) {
+    _rng.seed(seed);
+}
+
+double TightBot::getRoll() {
+    return (_rng() % 100) / 100.0;
+}
+
+bool TightBot::shouldBeAggressive(const Gamestate& /*gameState*/) {
+    double randomRoll = getRoll();
 
     if (randomRoll < _aggressiveness) {
         return true;
@@ -35,14 +55,17 @@ bool TightBot::shouldBeAggressive(const Gamestate& gameState) {
 PlayerAction TightBot::chooseAggressiveAction(const Gamestate& gameState, GameManager* gameManager) {
     auto legalActions = gameManager->getLegalActions(gameState.getCurrentPlayerIndex());
     int currentBet = gameState.getCurrentBet();
-    float handStrength = evaluateHandStrength(gameState);
+    double handStrength = evaluateHandStrength(gameState);
 
 
     if (currentBet == 0) {
         for (const auto& action : legalActions) {
-            if (action.action == Action::bet) {
+            if (action.actionType == Action::bet) {
                 int betSize = calculateBetSize(handStrength, gameState);
-                return PlayerAction(Action::bet, betSize);
+                // 0 is no bet; otherwise the legal bet carries the minimum
+                int maxBet = gameManager->getMaximumBet(gameState.getCurrentPlayerIndex());
+                if (betSize > 0) return PlayerAction(Action::bet, std::min(std::max(betSize, action.amount), maxBet));
+                break;
             }
         }
         return PlayerAction(Action::check);
@@ -50,14 +73,19 @@ PlayerAction TightBot::chooseAggressiveAction(const Gamestate& gameState, GameMa
 
     double raiseChance = _aggressiveness * handStrength;
 
-    double randomRoll = (rand() % 100) / 100.0;
+    double randomRoll = getRoll();
 
     if (randomRoll < raiseChance) {
         for (const auto& action : legalActions) {
-            if (action.action == Action::raise) {
-                int raiseSize = calculateRaiseSize(currentBet, handStrength, gameState);
-                return PlayerAction(Action::raise, raiseSize);
+            if (action.actionType != Action::raise) continue;
+            int raiseSize = calculateRaiseSize(currentBet, handStrength, gameState);
+            int maxRaise = gameManager->getMaximumBet(gameState.getCurrentPlayerIndex());
+            if (raiseSize > 0) return PlayerAction(Action::raise, std::min(std::max(raiseSize, action.amount), maxRaise));
+            // 0 is no raise worth making: stay in with a call
+            for (const auto& call : legalActions) {
+                if (call.actionType == Action::call) return call;
             }
+            break;
         }
     }
 
@@ -65,7 +93,7 @@ PlayerAction TightBot::chooseAggressiveAction(const Gamestate& gameState, GameMa
 
     if (handStrength > callThreshold) {
         for (const auto& action : legalActions) {
-            if (action.action == Action::call) {
+            if (action.actionType == Action::call) {
                 return action;
             }
         }
@@ -76,22 +104,20 @@ PlayerAction TightBot::chooseAggressiveAction(const Gamestate& gameState, GameMa
 
 PlayerAction TightBot::choosePassiveAction(const Gamestate& gameState, GameManager* gameManager) {
     auto legalActions = gameManager->getLegalActions(gameState.getCurrentPlayerIndex());
-    int currentBet = gameState.getCurrentBet();
-    const Hand playerHand = this->getHand();
 
     // if there is an option to check always check as the preferred passive action
     for (const auto& action : legalActions) {
-        if (action.action == Action::check) {
+        if (action.actionType == Action::check) {
             return action;
         }
     }
 
-    float handStrength = evaluateHandStrength(gameState);
+    double handStrength = evaluateHandStrength(gameState);
     double callThreshold = getCallThreshold();
 
     if (handStrength > callThreshold) {
         for (const auto& action : legalActions) {
-            if (action.action == Action::call) {
+            if (action.actionType == Action::call) {
                 return action;
             }
         }
@@ -99,35 +125,35 @@ PlayerAction TightBot::choosePassiveAction(const Gamestate& gameState, GameManag
     return PlayerAction(Action::fold);
 }
 
-double TightBot::getBaseStrength(int handRank) {
-    switch(handRank) {
-    case STRAIGHT_FLUSH: return 0.95;
-    case FOUR_OF_A_KIND: return 0.90;
-    case FULL_HOUSE: return 0.85;
-    case FLUSH: return 0.75;
-    case STRAIGHT: return 0.65;
-    case THREE_OF_A_KIND: return 0.55;
-    case TWO_PAIR: return 0.45;
-    case ONE_PAIR: return 0.30;
-    case HIGH_CARD: return 0.15;
-    default: return 0.10;
-    }
-}
-
-
-double TightBot::getCallThreshold() {
+double TightBot::getCallThreshold() const {
     double tightnessComponent = 0.2 + (_tightness * 0.5);
     double aggressivenessAdjustment = _aggressiveness * 0.1;
 
     return tightnessComponent - aggressivenessAdjustment;
 }
 
-float TightBot::evaluateHandStrength(const Gamestate& gameState) {
+double TightBot::evaluateHandStrength(const Gamestate& gameState) {
     const Hand& playerHand = this->getHand();
-    return HandStrengthEvaluator::evaluateHandStrength(playerHand, gameState);
+    uint64_t hole = 0;
+    for (const Card& card : playerHand.getCards()) {
+        hole |= 1ull << card.getIndex();
+    }
+    uint64_t board = 0;
+    for (const Card& card : gameState.getCommunityCards()) {
+        board |= 1ull << card.getIndex();
+    }
+    GamePhase phase = gameState.getCurrentPhase();
+    if (!_cached || hole != _cachedHole || board != _cachedBoard || phase != _cachedPhase) {
+        _cachedStrength = HandStrengthEvaluator::evaluateHandStrength(playerHand, gameState);
+        _cachedHole = hole;
+        _cachedBoard = board;
+        _cachedPhase = phase;
+        _cached = true;
+    }
+    return _cachedStrength;
 }
 
-int TightBot::calculateBetSize(double handStrength, const GameState& gameState) {
+int TightBot::calculateBetSize(double handStrength, const Gamestate& gameState) {
     int potSize = gameState.getTotalPotValue();
 
     if (handStrength > 0.8) {
@@ -140,7 +166,7 @@ int TightBot::calculateBetSize(double handStrength, const GameState& gameState)
 
         return potSize * 0.3;
     } else {
-        double bluffRoll = (rand() % 100) / 100.0;
+        double bluffRoll = getRoll();
         if (bluffRoll < _bluffFrequency) {
             return potSize * 0.4;
         }
@@ -148,41 +174,16 @@ int TightBot::calculateBetSize(double handStrength, const GameState& gameState)
     }
 }
 
-int TightBot::calculateRaiseSize(int currentBet, double handStrength, const GameState& gameState) {
+int TightBot::calculateRaiseSize(int currentBet, double handStrength, const Gamestate& /*gameState*/) {
     if (handStrength > 0.8) {
         return currentBet * 3;
     } else if (handStrength > 0.6) {
         return currentBet * 2;
     } else {
-        double bluffRoll = (rand() % 100) / 100.0;
+        double bluffRoll = getRoll();
         if (bluffRoll < _bluffFrequency) {
             return currentBet * 2;
         }
         return 0;
     }
 }
-
-double TightBot::getPreFlopStrength(const GameState& gameState) {
-    auto cards = this->getHand();
-    if (cards.size() != 2) return 0.5;  // Should have exactly 2 hole cards
-
-    int rank1 = cards[0].getRank();
-    int rank2 = cards[1].getRank();
-    bool suited = (cards[0].getSuit() == cards[1].getSuit());
-    bool paired = (rank1 == rank2);
-
-    // Premium hands
-    if (paired && rank1 >= 10) return 0.9;  // AA, KK, QQ, JJ, TT
-    if ((rank1 == 12 && rank2 == 11) || (rank1 == 11 && rank2 == 12)) return 0.85; // AK
-
-    // Good hands
-    if (paired && rank1 >= 7) return 0.7;   // 99, 88, 77
-    if (suited && abs(rank1 - rank2) <= 1 && std::min(rank1, rank2) >= 9) return 0.65; // AQs, KQs, etc.
-
-    // Mediocre hands
-    if (paired) return 0.5;  // Any pair
-    if (std::max(rank1, rank2) >= 11) return 0.4;  // Any ace or face card
-
-    // Trash
-    return 0.2;
-}
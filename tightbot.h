@@ -1,25 +1,45 @@
 #ifndef TIGHTBOT_H
 #define TIGHTBOT_H
+#include <cstdint>
+#include <random>
 #include "player.h"
 
 class GameManager;
 
+// Plays hands whose strength clears its tightness, betting or raising with probability set by
+// its aggressiveness. Strength is HandStrengthEvaluator::evaluateHandStrength - a table lookup
+// preflop, an enumeration against every opponent holding after it - and is kept for as long
+// as the hand, board and phase stay the same, so one decision evaluates at most once.
 class TightBot : public Player {
 
 public:
     TightBot(const std::string& name, int chips, double tightness = 0.8,
              double aggressiveness = 0.3, int position = -1);
     PlayerAction makeDecision(const Gamestate& gameState, GameManager* gameManager);
+    void setBluffFrequency(double bluffFrequency);
+    // Fixes the bot's dice, for repeatable matches.
+    void setSeed(uint64_t seed);
 
 private:
     double _tightness;
     double _aggressiveness;
     double _bluffFrequency;
+    std::mt19937_64 _rng;
+    // last evaluation and what it was for
+    uint64_t _cachedHole;
+    uint64_t _cachedBoard;
+    GamePhase _cachedPhase;
+    bool _cached;
+    double _cachedStrength;
 
+    double getRoll();   // 0.00 to 0.99
     double evaluateHandStrength(const Gamestate& gameState);
+    bool shouldBeAggressive(const Gamestate& gameState);
     PlayerAction chooseAggressiveAction(const Gamestate& gameState, GameManager* gm);
     PlayerAction choosePassiveAction(const Gamestate& gameState, GameManager* gm);
-    int calculateBetSize(double handStrength, int potSize);
+    double getCallThreshold() const;
+    int calculateBetSize(double handStrength, const Gamestate& gameState);
+    int calculateRaiseSize(int currentBet, double handStrength, const Gamestate& gameState);
 };
 
 #endif
@@ -0,0 +1,173 @@
+#include "trajectoryring.h"
+#include "infostate.h"
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static_assert(TRAJECTORY_STATE_SIZE == InfoState::kSize, "trajectory record must hold one InfoState");
+static_assert(sizeof(TrajectoryRingHeader) % 64 == 0, "slots must start on a cache line");
+static_assert(sizeof(TrajectorySlot) % 8 == 0, "slot sequence must stay 8-byte aligned");
+
+static TrajectorySlot* slotsOf(TrajectoryRingHeader* header) {
+    return reinterpret_cast<TrajectorySlot*>(reinterpret_cast<char*>(header) + sizeof(TrajectoryRingHeader));
+}
+
+static size_t mappedSize(uint32_t capacity) {
+    return sizeof(TrajectoryRingHeader) + static_cast<size_t>(capacity) * sizeof(TrajectorySlot);
+}
+
+TrajectoryRing::TrajectoryRing(const std::string& name, uint32_t capacity, Backpressure mode)
+    : _name(name), _mode(mode), _header(nullptr), _slots(nullptr), _mappedBytes(0), _pending(0) {
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+        throw std::runtime_error("Trajectory ring capacity must be a power of two");
+    }
+
+    int fd = shm_open(name.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0600);
+    if (fd < 0) throw std::runtime_error("Could not create shared memory " + name);
+    _mappedBytes = mappedSize(capacity);
+    if (ftruncate(fd, static_cast<off_t>(_mappedBytes)) != 0) {
+        close(fd);
+        shm_unlink(name.c_str());
+        throw std::runtime_error("Could not size shared memory " + name);
+    }
+    void* memory = mmap(nullptr, _mappedBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) {
+        shm_unlink(name.c_str());
+        throw std::runtime_error("Could not map shared memory " + name);
+    }
+
+    _header = static_cast<TrajectoryRingHeader*>(memory);
+    _slots = slotsOf(_header);
+    std::memset(_header, 0, sizeof(TrajectoryRingHeader));
+    _header->capacity = capacity;
+    _header->recordSize = sizeof(TrajectoryRecord);
+    _header->slotSize = sizeof(TrajectorySlot);
+    for (uint32_t i = 0; i < capacity; i++) {
+        __atomic_store_n(&_slots[i].sequence, static_cast<uint64_t>(i), __ATOMIC_RELAXED);
+    }
+    // consumers check the magic last, so it goes in once the slots are ready
+    __atomic_store_n(&_header->magic, TRAJECTORY_RING_MAGIC, __ATOMIC_RELEASE);
+}
+
+TrajectoryRing::~TrajectoryRing() {
+    munmap(_header, _mappedBytes);
+    shm_unlink(_name.c_str());
+}
+
+TrajectoryRecord* TrajectoryRing::beginWrite() {
+    uint64_t position = __atomic_load_n(&_header->writeIndex, __ATOMIC_RELAXED);
+    TrajectorySlot& slot = _slots[position & (_header->capacity - 1)];
+    // the slot is free once the consumer of the previous lap released it
+    while (__atomic_load_n(&slot.sequence, __ATOMIC_ACQUIRE) != position) {
+        if (_mode == Backpressure::drop) {
+            __atomic_fetch_add(&_header->dropped, 1, __ATOMIC_RELAXED);
+            return nullptr;
+        }
+        std::this_thread::yield();
+    }
+    _pending = position;
+    return &slot.record;
+}
+
+void TrajectoryRing::commitWrite() {
+    TrajectorySlot& slot = _slots[_pending & (_header->capacity - 1)];
+    __atomic_store_n(&slot.sequence, _pending + 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&_header->writeIndex, _pending + 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&_header->written, 1, __ATOMIC_RELAXED);
+}
+
+bool TrajectoryRing::write(const float* state, const uint8_t* legalMask, int numActions,
+                           int action, float reward, int env, int seat, bool done) {
+    TrajectoryRecord* record = beginWrite();
+    if (!record) return false;
+    std::memcpy(record->state, state, sizeof(record->state));
+    std::memset(record->legalMask, 0, sizeof(record->legalMask));
+    if (numActions > TRAJECTORY_MASK_SIZE) numActions = TRAJECTORY_MASK_SIZE;
+    std::memcpy(record->legalMask, legalMask, static_cast<size_t>(numActions));
+    record->action = action;
+    record->reward = reward;
+    record->env = static_cast<uint32_t>(env);
+    record->seat = static_cast<uint8_t>(seat);
+    record->done = done ? 1 : 0;
+    commitWrite();
+    return true;
+}
+
+uint64_t TrajectoryRing::getWritten() const {
+    return __atomic_load_n(&_header->written, __ATOMIC_RELAXED);
+}
+
+uint64_t TrajectoryRing::getDropped() const {
+    return __atomic_load_n(&_header->dropped, __ATOMIC_RELAXED);
+}
+
+const std::string& TrajectoryRing::getName() const {
+    return _name;
+}
+
+TrajectoryRingHeader* trajectoryRingAttach(const char* name) {
+    int fd = shm_open(name, O_RDWR, 0600);
+    if (fd < 0) return nullptr;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(TrajectoryRingHeader)) {
+        close(fd);
+        return nullptr;
+    }
+    void* memory = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) return nullptr;
+
+    TrajectoryRingHeader* header = static_cast<TrajectoryRingHeader*>(memory);
+    bool valid = __atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) == TRAJECTORY_RING_MAGIC
+            && header->recordSize == sizeof(TrajectoryRecord)
+            && header->slotSize == sizeof(TrajectorySlot)
+            && mappedSize(header->capacity) <= static_cast<size_t>(info.st_size);
+    if (!valid) {
+        munmap(memory, static_cast<size_t>(info.st_size));
+        return nullptr;
+    }
+    return header;
+}
+
+void trajectoryRingDetach(TrajectoryRingHeader* ring) {
+    if (ring) munmap(ring, mappedSize(ring->capacity));
+}
+
+const TrajectoryRecord* trajectoryRingClaim(TrajectoryRingHeader* ring, uint64_t* ticket) {
+    TrajectorySlot* slots = slotsOf(ring);
+    uint64_t position = __atomic_load_n(&ring->readIndex, __ATOMIC_RELAXED);
+    for (;;) {
+        TrajectorySlot& slot = slots[position & (ring->capacity - 1)];
+        uint64_t sequence = __atomic_load_n(&slot.sequence, __ATOMIC_ACQUIRE);
+        int64_t ready = static_cast<int64_t>(sequence - (position + 1));
+        if (ready < 0) return nullptr;
+        if (ready == 0) {
+            // on failure position is reloaded with the current read index
+            if (__atomic_compare_exchange_n(&ring->readIndex, &position, position + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                *ticket = position;
+                return &slot.record;
+            }
+        } else {
+            position = __atomic_load_n(&ring->readIndex, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+void trajectoryRingRelease(TrajectoryRingHeader* ring, uint64_t ticket) {
+    TrajectorySlot& slot = slotsOf(ring)[ticket & (ring->capacity - 1)];
+    __atomic_store_n(&slot.sequence, ticket + ring->capacity, __ATOMIC_RELEASE);
+}
+
+uint64_t trajectoryRingWritten(const TrajectoryRingHeader* ring) {
+    return __atomic_load_n(&ring->written, __ATOMIC_RELAXED);
+}
+
+uint64_t trajectoryRingDropped(const TrajectoryRingHeader* ring) {
+    return __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+}
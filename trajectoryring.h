@@ -0,0 +1,110 @@
+#ifndef TRAJECTORYRING_H
+#define TRAJECTORYRING_H
+/*
+ * Shared-memory ring of self-play transitions for a local trainer process.
+ *
+ * One simulator thread produces into a ring (give each thread its own ring); any number of
+ * consumer processes attach to it by name and read records in place. Each slot carries a
+ * sequence number, so claiming a record is a single CAS on the shared read index and nobody
+ * takes a lock. The producer either waits for space or drops the record and counts it,
+ * depending on its backpressure mode.
+ *
+ * Everything above the C++ section is plain C so a trainer can map the ring without this
+ * library's C++ side (tests/trajectoryconsumer.c is a complete C consumer), e.g.
+ *
+ *     TrajectoryRingHeader* ring = trajectoryRingAttach("/pk_selfplay_0");
+ *     uint64_t ticket;
+ *     const TrajectoryRecord* record = trajectoryRingClaim(ring, &ticket);
+ *     if (record) { ... use record->state ...; trajectoryRingRelease(ring, ticket); }
+ */
+#include <stdint.h>
+
+#define TRAJECTORY_STATE_SIZE 372   /* InfoState::kSize */
+#define TRAJECTORY_MASK_SIZE 8      /* room for VectorEnv::kNumActions */
+#define TRAJECTORY_RING_MAGIC 0x504b5452u
+
+typedef struct TrajectoryRecord {
+    float state[TRAJECTORY_STATE_SIZE];
+    uint8_t legalMask[TRAJECTORY_MASK_SIZE];
+    int32_t action;
+    float reward;
+    uint32_t env;
+    uint8_t seat;
+    uint8_t done;
+    uint8_t reserved[2];
+} TrajectoryRecord;
+
+typedef struct TrajectorySlot {
+    uint64_t sequence;              /* == position when free, position + 1 once published */
+    uint8_t pad[56];
+    TrajectoryRecord record;
+} TrajectorySlot;
+
+typedef struct TrajectoryRingHeader {
+    uint32_t magic;
+    uint32_t capacity;              /* power of two */
+    uint32_t recordSize;            /* sizeof(TrajectoryRecord), checked on attach */
+    uint32_t slotSize;
+    uint8_t pad0[48];
+    uint64_t writeIndex;            /* producer only */
+    uint8_t pad1[56];
+    uint64_t readIndex;             /* shared by consumers */
+    uint8_t pad2[56];
+    uint64_t written;
+    uint64_t dropped;
+    uint8_t pad3[48];
+    /* TrajectorySlot slots[capacity] follow */
+} TrajectoryRingHeader;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+TrajectoryRingHeader* trajectoryRingAttach(const char* name);
+void trajectoryRingDetach(TrajectoryRingHeader* ring);
+/* Returns the next published record or NULL when the ring is empty. Release it when done. */
+const TrajectoryRecord* trajectoryRingClaim(TrajectoryRingHeader* ring, uint64_t* ticket);
+void trajectoryRingRelease(TrajectoryRingHeader* ring, uint64_t ticket);
+uint64_t trajectoryRingWritten(const TrajectoryRingHeader* ring);
+uint64_t trajectoryRingDropped(const TrajectoryRingHeader* ring);
+
+#ifdef __cplusplus
+}
+
+#include <string>
+
+// Producer side. Creates (and on destruction unlinks) the shared-memory object.
+class TrajectoryRing
+{
+public:
+    enum class Backpressure { block, drop };
+
+    TrajectoryRing(const std::string& name, uint32_t capacity, Backpressure mode = Backpressure::drop);
+    ~TrajectoryRing();
+    TrajectoryRing(const TrajectoryRing&) = delete;
+    TrajectoryRing& operator=(const TrajectoryRing&) = delete;
+
+    // Zero-copy write: fill the returned record in place, then commit. Returns nullptr when
+    // the ring is full in drop mode (the record is counted as dropped).
+    TrajectoryRecord* beginWrite();
+    void commitWrite();
+
+    bool write(const float* state, const uint8_t* legalMask, int numActions,
+               int action, float reward, int env, int seat, bool done);
+
+    uint64_t getWritten() const;
+    uint64_t getDropped() const;
+    const std::string& getName() const;
+
+private:
+    std::string _name;
+    Backpressure _mode;
+    TrajectoryRingHeader* _header;
+    TrajectorySlot* _slots;
+    size_t _mappedBytes;
+    uint64_t _pending;  // position handed out by beginWrite, not yet committed
+};
+
+#endif // __cplusplus
+
+#endif // TRAJECTORYRING_H
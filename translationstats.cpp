@@ -0,0 +1,101 @@
+#include "translationstats.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+using namespace std;
+
+TranslationStats::TranslationStats(const BetAbstraction& bets, double tolerance)
+    : _allInAction(bets.getAllInAction()), _tolerance(tolerance), _counts(2 * bets.getPotFractions().size() + 1),
+    _readAsLower(2 * bets.getPotFractions().size() + 1), _errorMillionths(0), _errorSamples(0) {
+    vector<pair<double, int>> sizes;
+    for (size_t i = 0; i < bets.getPotFractions().size(); i++) {
+        sizes.emplace_back(bets.getPotFractions()[i], BetAbstraction::kFirstRaise + static_cast<int>(i));
+    }
+    sort(sizes.begin(), sizes.end());
+    for (const pair<double, int>& size : sizes) {
+        _sizes.push_back(size.first);
+        _actions.push_back(size.second);
+    }
+    reset();
+}
+
+void TranslationStats::record(double fraction, int action, double allInFraction) {
+    int count = static_cast<int>(_sizes.size());
+    int slot = 2 * count;
+    double translated = action == _allInAction ? allInFraction : -1.0;
+    for (int i = 0; i < count; i++) {
+        if (fabs(fraction - _sizes[i]) <= _tolerance * _sizes[i]) {
+            slot = 2 * i + 1;
+            break;
+        }
+        if (fraction < _sizes[i]) {
+            slot = 2 * i;
+            break;
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        if (_actions[i] == action) translated = _sizes[i];
+    }
+    _counts[slot].fetch_add(1, memory_order_relaxed);
+    if (slot % 2 == 0 && slot > 0 && slot < 2 * count && _actions[slot / 2 - 1] == action) {
+        _readAsLower[slot].fetch_add(1, memory_order_relaxed);
+    }
+    // an action with no size of its own says nothing about the error
+    if (translated < 0.0) return;
+    _errorMillionths.fetch_add(static_cast<uint64_t>(llround(fabs(fraction - translated) * 1e6)),
+                               memory_order_relaxed);
+    _errorSamples.fetch_add(1, memory_order_relaxed);
+}
+
+void TranslationStats::reset() {
+    for (atomic<uint64_t>& count : _counts) count.store(0, memory_order_relaxed);
+    for (atomic<uint64_t>& count : _readAsLower) count.store(0, memory_order_relaxed);
+    _errorMillionths.store(0, memory_order_relaxed);
+    _errorSamples.store(0, memory_order_relaxed);
+}
+
+uint64_t TranslationStats::getCount() const {
+    uint64_t total = 0;
+    for (const atomic<uint64_t>& count : _counts) total += count.load(memory_order_relaxed);
+    return total;
+}
+
+double TranslationStats::getMismatchRate() const {
+    uint64_t total = getCount();
+    if (total == 0) return 0.0;
+    uint64_t onSize = 0;
+    for (size_t slot = 1; slot < _counts.size(); slot += 2) onSize += _counts[slot].load(memory_order_relaxed);
+    return static_cast<double>(total - onSize) / total;
+}
+
+void TranslationStats::print(ostream& out) const {
+    uint64_t total = getCount();
+    uint64_t samples = _errorSamples.load(memory_order_relaxed);
+    out << "Bet translation: " << total << " real sizes, " << getMismatchRate() * 100.0
+        << "% between abstract sizes, mean error "
+        << (samples > 0 ? _errorMillionths.load(memory_order_relaxed) / 1e6 / samples : 0.0) << " pot" << endl;
+    if (total == 0) return;
+    int count = static_cast<int>(_sizes.size());
+    for (int slot = 0; slot <= 2 * count; slot++) {
+        uint64_t hits = _counts[slot].load(memory_order_relaxed);
+        out << "  ";
+        if (count == 0) {
+            out << "any size";
+        } else if (slot % 2 == 1) {
+            out << "at " << _sizes[slot / 2] << " pot";
+        } else if (slot == 0) {
+            out << "below " << _sizes[0] << " pot";
+        } else if (slot == 2 * count) {
+            out << "above " << _sizes[count - 1] << " pot";
+        } else {
+            out << _sizes[slot / 2 - 1] << " - " << _sizes[slot / 2] << " pot";
+        }
+        out << ": " << hits << " (" << 100.0 * hits / total << "%)";
+        if (slot % 2 == 0 && slot > 0 && slot < 2 * count && hits > 0) {
+            out << ", " << 100.0 * _readAsLower[slot].load(memory_order_relaxed) / hits << "% read as "
+                << _sizes[slot / 2 - 1];
+        }
+        out << endl;
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef TRANSLATIONSTATS_H
+#define TRANSLATIONSTATS_H
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include "betabstraction.h"
+
+// Where real bet and raise sizes land against a BetAbstraction's pot fractions, for tuning the
+// abstraction: on one of its sizes (within a relative tolerance), below the smallest, above the
+// largest, or between two neighbours, with how many of those were read as the lower one.
+// Recording is a few relaxed atomic adds, so bots can keep it on during play and share one
+// between threads; print writes the report.
+class TranslationStats
+{
+public:
+    explicit TranslationStats(const BetAbstraction& bets, double tolerance = 0.05);
+
+    // A real size, as a pot fraction, and the abstract action it was translated to; an all in
+    // stands for allInFraction, the actor's stack as a pot fraction.
+    void record(double fraction, int action, double allInFraction);
+    void reset();
+
+    uint64_t getCount() const;
+    double getMismatchRate() const;   // share of sizes that were not on an abstract one
+    void print(std::ostream& out) const;
+
+private:
+    std::vector<double> _sizes;         // the pot fractions, ascending
+    std::vector<int> _actions;          // abstract id of each
+    int _allInAction;
+    double _tolerance;
+    // slot 2i + 1 is on size i; even slots are the gaps below, between and above them
+    std::vector<std::atomic<uint64_t>> _counts;
+    std::vector<std::atomic<uint64_t>> _readAsLower;
+    std::atomic<uint64_t> _errorMillionths;   // |real - translated| in millionths of the pot
+    std::atomic<uint64_t> _errorSamples;      // records translated to a size, what the error is over
+};
+
+#endif // TRANSLATIONSTATS_H
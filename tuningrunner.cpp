@@ -0,0 +1,201 @@
+#include "tuningrunner.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include "gamemanager.h"
+#include "tableengine.h"
+#include "tightbot.h"
+
+using namespace std;
+
+namespace {
+
+const double kConfidence = 1.96;   // two-sided 95%
+
+// a block's seeds: the deck's, the candidate's and the opponent's
+const uint64_t kStreamsPerBlock = 4;
+
+// mean and half-width of its 95% interval over the first count values
+void summarize(const double* values, int count, double& mean, double& halfWidth) {
+    mean = 0.0;
+    halfWidth = 0.0;
+    if (count == 0) return;
+    for (int i = 0; i < count; i++) mean += values[i];
+    mean /= count;
+    if (count < 2) {
+        halfWidth = INFINITY;
+        return;
+    }
+    double squares = 0.0;
+    for (int i = 0; i < count; i++) squares += (values[i] - mean) * (values[i] - mean);
+    halfWidth = kConfidence * sqrt(squares / (count - 1) / count);
+}
+
+}
+
+TuningRunner::TuningRunner(const RuleSet& rules, int numThreads)
+    : _rules(rules), _pool(numThreads), _handsPerBlock(200), _firstBlocks(8), _stackBigBlinds(200),
+    _keep(0.5), _maxRounds(6), _seed(0) {
+}
+
+void TuningRunner::addOpponent(const string& name, Opponent opponent) {
+    if (!opponent) throw runtime_error("A tuning opponent needs a factory");
+    _opponentNames.push_back(name);
+    _opponents.push_back(opponent);
+}
+
+void TuningRunner::setBlocks(int handsPerBlock, int firstBlocks, int stackBigBlinds) {
+    if (handsPerBlock <= 0 || firstBlocks <= 0 || stackBigBlinds <= 0) {
+        throw runtime_error("Blocks need hands, a count and a stack");
+    }
+    _handsPerBlock = handsPerBlock;
+    _firstBlocks = firstBlocks;
+    _stackBigBlinds = stackBigBlinds;
+}
+
+void TuningRunner::setHalving(double keep, int maxRounds) {
+    if (keep <= 0.0 || keep > 1.0 || maxRounds <= 0) throw runtime_error("Halving keeps a share in (0, 1] for at least one round");
+    _keep = keep;
+    _maxRounds = maxRounds;
+}
+
+void TuningRunner::setSeed(uint64_t seed) {
+    _seed = seed;
+}
+
+vector<TuningRunner::Config> TuningRunner::makeGrid(const vector<double>& tightness, const vector<double>& aggressiveness,
+                                                    const vector<double>& bluffFrequency) {
+    vector<Config> configs;
+    for (double t : tightness) {
+        for (double a : aggressiveness) {
+            for (double b : bluffFrequency) {
+                configs.push_back(Config{t, a, b});
+            }
+        }
+    }
+    return configs;
+}
+
+double TuningRunner::playBlock(const Config& config, int block, int& hands) const {
+    int numOpponents = static_cast<int>(_opponents.size());
+    int bigBlind = _rules.getBigBlind();
+    int stack = _stackBigBlinds * bigBlind;
+
+    GameManager game(_rules);
+    game.setVerbose(false);
+    game.setSeed(EngineRng::getStreamSeed(_seed, block * kStreamsPerBlock));
+    game.setAllInEvaluation();
+    auto candidate = make_shared<TightBot>("candidate", stack, config.tightness, config.aggressiveness);
+    candidate->setBluffFrequency(config.bluffFrequency);
+    candidate->setSeed(EngineRng::getStreamSeed(_seed, block * kStreamsPerBlock + 1));
+    shared_ptr<Player> opponent = _opponents[block % numOpponents](EngineRng::getStreamSeed(_seed, block * kStreamsPerBlock + 2));
+    if (!opponent) throw runtime_error("Opponent " + _opponentNames[block % numOpponents] + " gave no player");
+    if ((block / numOpponents) % 2 == 0) {
+        game.addPlayer(candidate);
+        game.addPlayer(opponent);
+    } else {
+        game.addPlayer(opponent);
+        game.addPlayer(candidate);
+    }
+
+    // hands is only written once the block is done, so a throw leaves the caller's count alone
+    int played = 0;
+    for (; played < _handsPerBlock && !game.isGameOver(); played++) {
+        game.playHand();
+    }
+    hands = played;
+    // all-ins count at expectation
+    double chips = candidate->getChips() + candidate->getAllInAdjustment();
+    return played > 0 ? (chips - stack) * 100.0 / bigBlind / played : 0.0;
+}
+
+vector<TuningRunner::Result> TuningRunner::run(const vector<Config>& configs) {
+    if (_opponents.empty()) throw runtime_error("Tuning needs at least one opponent");
+    vector<Candidate> candidates(configs.size());
+    vector<int> alive(configs.size());
+    for (size_t i = 0; i < configs.size(); i++) {
+        candidates[i].config = configs[i];
+        candidates[i].hands = 0;
+        candidates[i].rounds = 0;
+        alive[i] = static_cast<int>(i);
+    }
+
+    int blocks = 0;
+    int newBlocks = _firstBlocks;
+    for (int round = 0; round < _maxRounds && !alive.empty(); round++) {
+        for (int index : alive) candidates[index].scores.resize(blocks + newBlocks);
+        int jobs = static_cast<int>(alive.size()) * newBlocks;
+        vector<int> hands(jobs);
+        _pool.parallelFor(jobs, [&](int begin, int end) {
+            for (int job = begin; job < end; job++) {
+                Candidate& candidate = candidates[alive[job / newBlocks]];
+                int block = blocks + job % newBlocks;
+                candidate.scores[block] = playBlock(candidate.config, block, hands[job]);
+            }
+        });
+        for (int job = 0; job < jobs; job++) candidates[alive[job / newBlocks]].hands += hands[job];
+        blocks += newBlocks;
+        for (int index : alive) candidates[index].rounds++;
+        if (alive.size() == 1) break;
+
+        // best first; the leader's blocks are everyone's blocks
+        vector<pair<double, int>> order;
+        for (int index : alive) {
+            double mean;
+            double halfWidth;
+            summarize(candidates[index].scores.data(), blocks, mean, halfWidth);
+            order.push_back(make_pair(-mean, index));
+        }
+        sort(order.begin(), order.end());
+        const vector<double>& leader = candidates[order[0].second].scores;
+        size_t keep = max<size_t>(1, static_cast<size_t>(ceil(alive.size() * _keep)));
+        vector<int> survivors;
+        vector<double> differences(blocks);
+        for (size_t rank = 0; rank < order.size() && survivors.size() < keep; rank++) {
+            const vector<double>& scores = candidates[order[rank].second].scores;
+            for (int block = 0; block < blocks; block++) differences[block] = scores[block] - leader[block];
+            double mean;
+            double halfWidth;
+            summarize(differences.data(), blocks, mean, halfWidth);
+            if (rank > 0 && mean + halfWidth < 0.0) continue;   // raced out
+            survivors.push_back(order[rank].second);
+        }
+        alive.swap(survivors);
+        newBlocks *= 2;
+    }
+
+    vector<Result> results;
+    for (const Candidate& candidate : candidates) {
+        Result result;
+        result.config = candidate.config;
+        result.rounds = candidate.rounds;
+        result.blocks = static_cast<int>(candidate.scores.size());
+        result.hands = candidate.hands;
+        double halfWidth;
+        summarize(candidate.scores.data(), result.blocks, result.mean, halfWidth);
+        result.low = result.mean - halfWidth;
+        result.high = result.mean + halfWidth;
+        results.push_back(result);
+    }
+    sort(results.begin(), results.end(), [](const Result& a, const Result& b) {
+        return a.rounds != b.rounds ? a.rounds > b.rounds : a.mean > b.mean;
+    });
+    return results;
+}
+
+void TuningRunner::print(const vector<Result>& results, ostream& out, int rows) {
+    out << " rank  tight  aggr  bluff  rounds  blocks     hands     bb/100   95% interval" << endl;
+    int count = min(rows, static_cast<int>(results.size()));
+    for (int i = 0; i < count; i++) {
+        const Result& result = results[i];
+        out << setw(5) << i + 1 << fixed << setprecision(2)
+            << setw(7) << result.config.tightness << setw(6) << result.config.aggressiveness
+            << setw(7) << result.config.bluffFrequency << setw(8) << result.rounds << setw(8) << result.blocks
+            << setw(10) << result.hands << setprecision(1) << setw(11) << result.mean
+            << "   [" << result.low << ", " << result.high << "]" << endl;
+    }
+    out.unsetf(ios::fixed);
+    out << setprecision(6);
+}
@@ -0,0 +1,87 @@
+#ifndef TUNINGRUNNER_H
+#define TUNINGRUNNER_H
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+#include "player.h"
+#include "ruleset.h"
+#include "workerpool.h"
+
+// Searches TightBot's parameters by successive halving. Every configuration plays the same
+// blocks - a heads-up match of a fixed number of hands against one benchmark opponent, with
+// the deck, the candidate and the opponent all seeded from the block number - so configurations
+// see the same cards and the same opponent dice (common random numbers), and the candidate
+// switches seats from one pass over the opponents to the next. A block scores the candidate's
+// winnings in big blinds per 100 hands, with all-ins settled on expected value.
+//
+// Each round plays the survivors' next blocks across the worker pool, then keeps the best
+// share by mean and also drops any whose paired difference from the leader, over the blocks
+// both played, is below zero with 95% confidence. Survivors play twice as many new blocks
+// the next round. The result is every configuration ranked by mean with a 95% interval, the
+// ones eliminated early ranked after those that lasted longer.
+class TuningRunner
+{
+public:
+    struct Config {
+        double tightness;
+        double aggressiveness;
+        double bluffFrequency;
+    };
+
+    struct Result {
+        Config config;
+        int rounds;           // rounds survived
+        int blocks;
+        long long hands;
+        double mean;          // bb/100
+        double low;           // 95% interval of the mean
+        double high;
+    };
+
+    // A benchmark opponent for a block, with its dice seeded.
+    using Opponent = std::function<std::shared_ptr<Player>(uint64_t seed)>;
+
+    explicit TuningRunner(const RuleSet& rules, int numThreads = 0);   // 0 = one per hardware thread
+
+    void addOpponent(const std::string& name, Opponent opponent);
+    // stack in big blinds; the first round plays firstBlocks blocks per configuration
+    void setBlocks(int handsPerBlock, int firstBlocks, int stackBigBlinds = 200);
+    // keep: share of survivors kept each round; stops at one survivor or after maxRounds
+    void setHalving(double keep, int maxRounds);
+    void setSeed(uint64_t seed);
+
+    // Every combination of the given values.
+    static std::vector<Config> makeGrid(const std::vector<double>& tightness, const std::vector<double>& aggressiveness,
+                                        const std::vector<double>& bluffFrequency);
+
+    // The matches run with the tables quiet. A block that throws (an opponent giving no player)
+    // ends the run with that exception once the round's other blocks have stopped.
+    std::vector<Result> run(const std::vector<Config>& configs);
+    static void print(const std::vector<Result>& results, std::ostream& out, int rows = 20);
+
+private:
+    struct Candidate {
+        Config config;
+        std::vector<double> scores;   // bb/100 per block, in block order
+        long long hands;
+        int rounds;
+    };
+
+    RuleSet _rules;
+    WorkerPool _pool;
+    std::vector<std::string> _opponentNames;
+    std::vector<Opponent> _opponents;
+    int _handsPerBlock;
+    int _firstBlocks;
+    int _stackBigBlinds;
+    double _keep;
+    int _maxRounds;
+    uint64_t _seed;
+
+    double playBlock(const Config& config, int block, int& hands) const;
+};
+
+#endif // TUNINGRUNNER_H
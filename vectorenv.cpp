@@ -0,0 +1,167 @@
+#include "vectorenv.h"
+#include "infostate.h"
+#include <cstring>
+
+using namespace std;
+
+namespace {
+
+const int kObservationSize = InfoState::kSize;
+
+template <typename Engine>
+void fillTables(vector<Engine>& tables, const RuleSet& rules, int numEnvs) {
+    tables.reserve(numEnvs);
+    for (int env = 0; env < numEnvs; env++) {
+        tables.emplace_back(rules);
+    }
+}
+
+}
+
+VectorEnv::VectorEnv(const RuleSet& rules, int numEnvs, int numThreads)
+    : _rules(rules),
+    _numEnvs(numEnvs),
+    _pool(numThreads),
+    _observations(static_cast<size_t>(numEnvs) * kObservationSize, 0.0f),
+    _legalMasks(static_cast<size_t>(numEnvs) * kNumActions, 0),
+    _currentSeats(numEnvs, -1),
+    _rewards(static_cast<size_t>(numEnvs) * 2, 0.0f),
+    _dones(numEnvs, 0) {
+    switch (rules.getBettingType()) {
+    case BettingStructure::NO_LIMIT:
+        _tables.emplace<0>();
+        fillTables(std::get<0>(_tables), rules, numEnvs);
+        break;
+    case BettingStructure::POT_LIMIT:
+        _tables.emplace<1>();
+        fillTables(std::get<1>(_tables), rules, numEnvs);
+        break;
+    case BettingStructure::FIXED_LIMIT:
+        _tables.emplace<2>();
+        fillTables(std::get<2>(_tables), rules, numEnvs);
+        break;
+    }
+}
+
+int VectorEnv::getNumEnvs() const {
+    return _numEnvs;
+}
+
+int VectorEnv::getObservationSize() const {
+    return kObservationSize;
+}
+
+void VectorEnv::reset(const uint64_t* seeds) {
+    std::visit([&](auto& tables) {
+        _pool.parallelFor(_numEnvs, [&](int begin, int end) {
+            for (int env = begin; env < end; env++) {
+                tables[env].seed(seeds[env]);
+                _rewards[env * 2] = 0.0f;
+                _rewards[env * 2 + 1] = 0.0f;
+                _dones[env] = 0;
+                beginHand(tables[env], env);
+            }
+        });
+    }, _tables);
+}
+
+void VectorEnv::step(const int* actions) {
+    std::visit([&](auto& tables) {
+        _pool.parallelFor(_numEnvs, [&](int begin, int end) {
+            for (int env = begin; env < end; env++) {
+                stepTable(tables[env], env, actions[env]);
+            }
+        });
+    }, _tables);
+}
+
+template <typename Engine>
+void VectorEnv::beginHand(Engine& table, int env) {
+    table.setStack(0, _rules.getStartingChips());
+    table.setStack(1, _rules.getStartingChips());
+    table.startHand();
+    writeOutputs(table, env);
+}
+
+template <typename Engine>
+void VectorEnv::stepTable(Engine& table, int env, int action) {
+    _rewards[env * 2] = 0.0f;
+    _rewards[env * 2 + 1] = 0.0f;
+    _dones[env] = 0;
+
+    LegalActions legal = table.getLegalActions();
+    if (!table.applyAction(toPlayerAction(legal, table.getCurrentBet(), getPotAfterCall(table), action))) {
+        int seat = table.getCurrentSeat();
+        table.applyAction(PlayerAction(table.getCurrentBet() > table.getRoundBet(seat) ? Action::fold : Action::check));
+    }
+
+    if (table.isHandOver()) {
+        float bigBlind = static_cast<float>(table.getBigBlind());
+        _rewards[env * 2] = table.getPayoff(0) / bigBlind;
+        _rewards[env * 2 + 1] = table.getPayoff(1) / bigBlind;
+        _dones[env] = 1;
+        beginHand(table, env);
+        return;
+    }
+    writeOutputs(table, env);
+}
+
+template <typename Engine>
+int VectorEnv::getPotAfterCall(const Engine& table) {
+    return table.getPotSize() + table.getCurrentBet() - table.getRoundBet(table.getCurrentSeat());
+}
+
+PlayerAction VectorEnv::toPlayerAction(const LegalActions& legal, int currentBet, int potAfterCall, int action) {
+    Action raiseType = currentBet == 0 ? Action::bet : Action::raise;
+    switch (action) {
+    case kFold:
+        return PlayerAction(Action::fold);
+    case kCheckCall:
+        return legal.has(Action::check) ? PlayerAction(Action::check) : PlayerAction(Action::call, legal.callAmount);
+    case kRaiseMin:
+        return PlayerAction(raiseType, legal.minRaiseTo);
+    case kRaiseHalfPot:
+    case kRaisePot: {
+        int target = currentBet + (action == kRaisePot ? potAfterCall : potAfterCall / 2);
+        if (target < legal.minRaiseTo) target = legal.minRaiseTo;
+        if (target > legal.maxRaiseTo) target = legal.maxRaiseTo;
+        return PlayerAction(raiseType, target);
+    }
+    case kAllIn:
+    default:
+        return PlayerAction(Action::all_in, legal.allInTo);
+    }
+}
+
+void VectorEnv::getLegalMask(const LegalActions& legal, int currentBet, int potAfterCall, uint8_t* mask) {
+    memset(mask, 0, kNumActions);
+    mask[kFold] = legal.has(Action::fold) && !legal.has(Action::check);
+    mask[kCheckCall] = legal.has(Action::check) || legal.has(Action::call);
+    if (legal.has(Action::bet) || legal.has(Action::raise)) {
+        int lastAmount = -1;
+        for (int action = kRaiseMin; action <= kRaisePot; action++) {
+            int amount = toPlayerAction(legal, currentBet, potAfterCall, action).amount;
+            if (amount > lastAmount && amount < legal.allInTo) {
+                mask[action] = 1;
+                lastAmount = amount;
+            }
+        }
+    }
+    mask[kAllIn] = legal.has(Action::all_in);
+}
+
+template <typename Engine>
+void VectorEnv::writeOutputs(const Engine& table, int env) {
+    int seat = table.getCurrentSeat();
+    _currentSeats[env] = seat;
+
+    float* obs = &_observations[static_cast<size_t>(env) * kObservationSize];
+    uint8_t* mask = &_legalMasks[static_cast<size_t>(env) * kNumActions];
+    memset(mask, 0, kNumActions);
+    if (seat < 0) {
+        memset(obs, 0, sizeof(float) * kObservationSize);
+        return;
+    }
+    InfoState::encode(table, seat, obs);
+    getLegalMask(table.getLegalActions(), table.getCurrentBet(), getPotAfterCall(table), mask);
+}
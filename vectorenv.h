@@ -0,0 +1,71 @@
+#ifndef VECTORENV_H
+#define VECTORENV_H
+#include <cstdint>
+#include <vector>
+#include <variant>
+#include "ruleset.h"
+#include "headsupengine.h"
+#include "workerpool.h"
+
+// Batched heads-up environment for RL self-play. Holds N independent tables and advances all
+// of them with one step() call, writing results into buffers allocated once up front:
+//   observations  numEnvs x getObservationSize() floats, InfoState layout for the seat to act
+//   legal masks   numEnvs x kNumActions bytes (1 = legal)
+//   current seat  numEnvs ints
+//   rewards       numEnvs x 2 floats, net big blinds per seat, nonzero only on the step a hand ends
+//   dones         numEnvs bytes, 1 on the step a hand ends
+// A finished table is dealt a fresh hand (starting stacks) in the same step, so the
+// observation after a done already belongs to the next hand.
+class VectorEnv
+{
+public:
+    enum DiscreteAction { kFold, kCheckCall, kRaiseMin, kRaiseHalfPot, kRaisePot, kAllIn };
+    static const int kNumActions = 6;
+
+    VectorEnv(const RuleSet& rules, int numEnvs, int numThreads = 1);
+
+    int getNumEnvs() const;
+    int getObservationSize() const;
+
+    void reset(const uint64_t* seeds);   // one seed per env
+    void step(const int* actions);       // one DiscreteAction per env, for its current seat
+
+    const float* getObservations() const { return _observations.data(); }
+    const uint8_t* getLegalMasks() const { return _legalMasks.data(); }
+    const int* getCurrentSeats() const { return _currentSeats.data(); }
+    const float* getRewards() const { return _rewards.data(); }
+    const uint8_t* getDones() const { return _dones.data(); }
+
+    // The discrete actions over a seat's legal moves, with the pot as it would be after a call.
+    // NeuralBot maps GameManager tables through these too, so a trained network plays by the
+    // same mapping it learned on. A sized raise only counts when it lands on a distinct amount.
+    static void getLegalMask(const LegalActions& legal, int currentBet, int potAfterCall, uint8_t* mask);
+    static PlayerAction toPlayerAction(const LegalActions& legal, int currentBet, int potAfterCall, int action);
+
+private:
+    using Tables = std::variant<std::vector<HeadsUpEngine<BettingStructure::NO_LIMIT>>,
+                                std::vector<HeadsUpEngine<BettingStructure::POT_LIMIT>>,
+                                std::vector<HeadsUpEngine<BettingStructure::FIXED_LIMIT>>>;
+
+    RuleSet _rules;
+    int _numEnvs;
+    Tables _tables;
+    WorkerPool _pool;
+
+    std::vector<float> _observations;
+    std::vector<uint8_t> _legalMasks;
+    std::vector<int> _currentSeats;
+    std::vector<float> _rewards;
+    std::vector<uint8_t> _dones;
+
+    template <typename Engine>
+    void beginHand(Engine& table, int env);
+    template <typename Engine>
+    void stepTable(Engine& table, int env, int action);
+    template <typename Engine>
+    void writeOutputs(const Engine& table, int env);
+    template <typename Engine>
+    static int getPotAfterCall(const Engine& table);
+};
+
+#endif // VECTORENV_H
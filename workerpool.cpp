@@ -0,0 +1,95 @@
+#include "workerpool.h"
+
+using namespace std;
+
+WorkerPool::WorkerPool(int numThreads)
+    : _job(nullptr),
+    _generation(0),
+    _remaining(0),
+    _stopping(false) {
+    if (numThreads <= 0) {
+        numThreads = max(1, static_cast<int>(thread::hardware_concurrency()));
+    }
+    for (int worker = 1; worker < numThreads; worker++) {
+        _threads.emplace_back(&WorkerPool::workerLoop, this, worker);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        lock_guard<mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _wake.notify_all();
+    for (thread& worker : _threads) {
+        worker.join();
+    }
+}
+
+int WorkerPool::size() const {
+    return static_cast<int>(_threads.size()) + 1;
+}
+
+void WorkerPool::run(const function<void(int)>& work) {
+    if (_threads.empty()) {
+        work(0);
+        return;
+    }
+    {
+        lock_guard<mutex> lock(_mutex);
+        _job = &work;
+        _remaining = static_cast<int>(_threads.size());
+        _generation++;
+    }
+    _wake.notify_all();
+
+    // the other workers still use work and whatever it captured, so wait for them either way
+    exception_ptr error;
+    try {
+        work(0);
+    } catch (...) {
+        error = current_exception();
+    }
+
+    unique_lock<mutex> lock(_mutex);
+    _finished.wait(lock, [this] { return _remaining == 0; });
+    _job = nullptr;
+    if (!error) error = _error;
+    _error = nullptr;
+    lock.unlock();
+    if (error) rethrow_exception(error);
+}
+
+void WorkerPool::parallelFor(int count, const function<void(int, int)>& work) {
+    int workers = size();
+    run([&](int worker) {
+        int begin = static_cast<int>(static_cast<long long>(count) * worker / workers);
+        int end = static_cast<int>(static_cast<long long>(count) * (worker + 1) / workers);
+        if (begin < end) work(begin, end);
+    });
+}
+
+void WorkerPool::workerLoop(int worker) {
+    long seen = 0;
+    while (true) {
+        const function<void(int)>* job;
+        {
+            unique_lock<mutex> lock(_mutex);
+            _wake.wait(lock, [&] { return _stopping || _generation != seen; });
+            if (_stopping) return;
+            seen = _generation;
+            job = _job;
+        }
+
+        exception_ptr error;
+        try {
+            (*job)(worker);
+        } catch (...) {
+            error = current_exception();
+        }
+
+        lock_guard<mutex> lock(_mutex);
+        if (error && !_error) _error = error;
+        if (--_remaining == 0) _finished.notify_one();
+    }
+}
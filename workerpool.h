@@ -0,0 +1,40 @@
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+
+// Fixed set of worker threads for batch jobs. The calling thread works as worker 0,
+// so a pool of size 1 runs everything inline with no threads at all.
+class WorkerPool
+{
+public:
+    explicit WorkerPool(int numThreads = 0);   // 0 = one per hardware thread
+    ~WorkerPool();
+    int size() const;
+
+    // Runs work(workerIndex) once on every worker and returns when all are done. If any of
+    // them throws, the first exception is rethrown here once every worker has finished.
+    void run(const std::function<void(int worker)>& work);
+
+    // Splits [0, count) into one contiguous chunk per worker
+    void parallelFor(int count, const std::function<void(int begin, int end)>& work);
+
+private:
+    std::vector<std::thread> _threads;
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::condition_variable _finished;
+    const std::function<void(int)>* _job;
+    long _generation;
+    int _remaining;
+    bool _stopping;
+    std::exception_ptr _error;   // first exception thrown by this run's work
+
+    void workerLoop(int worker);
+};
+
+#endif // WORKERPOOL_H